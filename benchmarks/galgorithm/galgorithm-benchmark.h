@@ -0,0 +1,82 @@
+/*
+ * /benchmarks/galgorithm/galgorithm-benchmark.h
+ *
+ * Shared helpers for the GAlgorithm benchmarks.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+
+#include <glib.h>
+
+namespace galgorithm_benchmark {
+  inline int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  /* Fill a new GPtrArray with @size pseudo-random integers in
+   * [0, @range), always using the same seed so that runs are
+   * comparable with each other. */
+  inline GPtrArray * random_ptr_array (size_t size, size_t range)
+  {
+    GPtrArray *array = g_ptr_array_sized_new (size);
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < size; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (1 + engine () % range));
+
+    return array;
+  }
+
+  /* Run @func @iterations times and return the best wall time in
+   * milliseconds. @setup is run before each iteration and is not
+   * timed. */
+  template <typename Setup, typename Func>
+  double best_of (size_t iterations, Setup &&setup, Func &&func)
+  {
+    double best = 0.0;
+
+    for (size_t i = 0; i < iterations; ++i)
+      {
+        setup ();
+
+        auto start = std::chrono::steady_clock::now ();
+        func ();
+        auto end = std::chrono::steady_clock::now ();
+
+        double elapsed = std::chrono::duration <double, std::milli> (end - start).count ();
+        if (i == 0 || elapsed < best)
+          best = elapsed;
+      }
+
+    return best;
+  }
+
+  inline void report (const char *name, size_t size, double milliseconds)
+  {
+    std::printf ("%-44s %10zu elements %14.6f ms\n", name, size, milliseconds);
+  }
+}
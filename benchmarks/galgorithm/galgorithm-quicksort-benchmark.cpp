@@ -0,0 +1,66 @@
+/*
+ * /benchmarks/galgorithm/galgorithm-quicksort-benchmark.cpp
+ *
+ * Compare the Lomuto and block partition schemes for
+ * GAlgorithm Quicksort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstring>
+
+#include <galgorithm/galgorithm-quicksort.h>
+
+#include "galgorithm-benchmark.h"
+
+using namespace galgorithm_benchmark;
+
+namespace {
+  void benchmark_partition (const char                   *name,
+                            GAlgorithmQuicksortPartition  partition_scheme,
+                            size_t                        size)
+  {
+    g_autoptr(GPtrArray) source = random_ptr_array (size, size);
+    g_autoptr(GPtrArray) array = g_ptr_array_sized_new (size);
+    g_ptr_array_set_size (array, size);
+
+    double ms = best_of (5,
+                         [&]() {
+                           std::memcpy (array->pdata, source->pdata, size * sizeof (gpointer));
+                         },
+                         [&]() {
+                           g_algorithm_quicksort_full (array, ptr_compare, partition_scheme);
+                         });
+
+    report (name, size, ms);
+  }
+}
+
+int main (void)
+{
+  for (size_t size : { 10000, 100000, 1000000 })
+    {
+      benchmark_partition ("quicksort (lomuto partition)",
+                           G_ALGORITHM_QUICKSORT_PARTITION_LOMUTO,
+                           size);
+      benchmark_partition ("quicksort (block partition)",
+                           G_ALGORITHM_QUICKSORT_PARTITION_BLOCK,
+                           size);
+    }
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * /benchmarks/galgorithm/galgorithm-sort-benchmark.cpp
+ *
+ * Compare the strategies of the GAlgorithm adaptive sort on different
+ * kinds of input, which is what its dispatch thresholds are based on.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <galgorithm/galgorithm-sort.h>
+#include <galgorithm/galgorithm-sort-private.h>
+
+#include "galgorithm-benchmark.h"
+
+using namespace galgorithm_benchmark;
+
+namespace {
+  typedef GPtrArray * (*InputFunc) (size_t size);
+
+  GPtrArray * random_input (size_t size)
+  {
+    return random_ptr_array (size, 1000000000);
+  }
+
+  GPtrArray * sorted_input (size_t size)
+  {
+    GPtrArray *array = random_ptr_array (size, 1000000000);
+
+    std::sort (array->pdata, array->pdata + array->len);
+    return array;
+  }
+
+  GPtrArray * reversed_input (size_t size)
+  {
+    GPtrArray *array = sorted_input (size);
+
+    std::reverse (array->pdata, array->pdata + array->len);
+    return array;
+  }
+
+  /* Sorted, then 1% of the elements swapped with random others */
+  GPtrArray * nearly_sorted_input (size_t size)
+  {
+    GPtrArray *array = sorted_input (size);
+    std::mt19937 engine (1);
+
+    for (size_t i = 0; i < size / 100; ++i)
+      std::swap (array->pdata[engine () % size], array->pdata[engine () % size]);
+
+    return array;
+  }
+
+  GPtrArray * few_distinct_input (size_t size)
+  {
+    return random_ptr_array (size, 16);
+  }
+
+  /* Time one sort of @source with @strategy, repeating small sorts
+   * enough times to be measurable */
+  double time_strategy (GPtrArray *source, GAlgorithmSortStrategy strategy)
+  {
+    size_t size = source->len;
+    size_t repeats = std::max <size_t> (1, 1000000 / size);
+    g_autoptr(GPtrArray) array = g_ptr_array_sized_new (size);
+    g_ptr_array_set_size (array, size);
+
+    double ms = best_of (5,
+                         []() {},
+                         [&]() {
+                           for (size_t r = 0; r < repeats; ++r)
+                             {
+                               std::memcpy (array->pdata, source->pdata, size * sizeof (gpointer));
+                               g_algorithm_sort_with_strategy (array, ptr_compare, strategy);
+                             }
+                         });
+
+    return ms / repeats;
+  }
+
+  void benchmark_input (const char *input_name, InputFunc input_func, size_t size)
+  {
+    static const GAlgorithmSortStrategy strategies[] = {
+      G_ALGORITHM_SORT_STRATEGY_INSERTION,
+      G_ALGORITHM_SORT_STRATEGY_RUN_MERGE,
+      G_ALGORITHM_SORT_STRATEGY_IN_PLACE_MERGE,
+      G_ALGORITHM_SORT_STRATEGY_INTROSORT,
+      G_ALGORITHM_SORT_STRATEGY_THREE_WAY_QUICKSORT
+    };
+    g_autoptr(GPtrArray) source = input_func (size);
+    GAlgorithmSortStrategy chosen = g_algorithm_sort_choose_strategy (source,
+                                                                      ptr_compare,
+                                                                      G_ALGORITHM_SORT_FLAGS_NONE);
+
+    for (GAlgorithmSortStrategy strategy : strategies)
+      {
+        /* Insertion sort is quadratic, so only try it where it
+         * could plausibly win */
+        if (strategy == G_ALGORITHM_SORT_STRATEGY_INSERTION && size > 256)
+          continue;
+
+        std::string name = std::string (input_name) + ": " +
+                           g_algorithm_sort_strategy_get_name (strategy) +
+                           (strategy == chosen ? " (chosen)" : "");
+
+        report (name.c_str (), size, time_strategy (source, strategy));
+      }
+  }
+}
+
+int main (void)
+{
+  for (size_t size : { 8, 16, 24, 32, 64, 100000 })
+    {
+      benchmark_input ("random", random_input, size);
+      benchmark_input ("sorted", sorted_input, size);
+      benchmark_input ("reversed", reversed_input, size);
+      benchmark_input ("nearly sorted", nearly_sorted_input, size);
+      benchmark_input ("few distinct", few_distinct_input, size);
+    }
+
+  return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * /benchmarks/galgorithm/galgorithm-timing-wheel-benchmark.cpp
+ *
+ * Benchmark the GAlgorithm Timing Wheel against the Minheap for
+ * connection timeouts.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <deque>
+#include <random>
+#include <vector>
+
+#include <galgorithm/galgorithm-minheap.h>
+#include <galgorithm/galgorithm-timing-wheel.h>
+
+#include "galgorithm-benchmark.h"
+
+using namespace galgorithm_benchmark;
+
+namespace {
+  /* Every connection has an idle timeout of this many ticks, which
+   * is pushed back whenever the connection sees any activity. Each
+   * connection sees activity every 100 ticks on average, so most
+   * timeouts are cancelled long before they expire. */
+  const guint64 MIN_TIMEOUT = 100;
+  const guint64 MAX_TIMEOUT = 2000;
+  const size_t ACTIVITY_DIVISOR = 100;
+  const guint64 TICKS = 1000;
+
+  /* Drives the same sequence of events for each timer implementation,
+   * so that they all do exactly the same work */
+  class Workload {
+    public:
+      explicit Workload (size_t n_connections) :
+        n_connections (n_connections),
+        engine (0)
+      {
+      }
+
+      size_t active_connection () { return engine () % n_connections; }
+      guint64 timeout () { return MIN_TIMEOUT + engine () % (MAX_TIMEOUT - MIN_TIMEOUT); }
+
+      const size_t n_connections;
+
+    private:
+      std::mt19937 engine;
+  };
+
+  double run_timing_wheel (size_t n_connections)
+  {
+    return best_of (3,
+                    []() {},
+                    [&]() {
+                      Workload workload (n_connections);
+                      g_autoptr(GAlgorithmTimingWheel) wheel = g_algorithm_timing_wheel_new (0);
+                      g_autoptr(GPtrArray) expired = g_ptr_array_new ();
+                      std::vector <GAlgorithmTimingWheelHandle> handles (n_connections);
+
+                      for (size_t c = 0; c < n_connections; ++c)
+                        handles[c] = g_algorithm_timing_wheel_schedule (wheel, workload.timeout (), GSIZE_TO_POINTER (c));
+
+                      for (guint64 now = 1; now <= TICKS; ++now)
+                        {
+                          for (size_t i = 0; i < n_connections / ACTIVITY_DIVISOR; ++i)
+                            {
+                              size_t c = workload.active_connection ();
+
+                              g_algorithm_timing_wheel_cancel (wheel, handles[c]);
+                              handles[c] = g_algorithm_timing_wheel_schedule (wheel,
+                                                                              now + workload.timeout (),
+                                                                              GSIZE_TO_POINTER (c));
+                            }
+
+                          g_ptr_array_set_size (expired, 0);
+                          g_algorithm_timing_wheel_advance (wheel, now, expired);
+
+                          /* Expired connections reconnect straight away */
+                          for (guint i = 0; i < expired->len; ++i)
+                            {
+                              size_t c = GPOINTER_TO_SIZE (expired->pdata[i]);
+
+                              handles[c] = g_algorithm_timing_wheel_schedule (wheel,
+                                                                              now + workload.timeout (),
+                                                                              GSIZE_TO_POINTER (c));
+                            }
+                        }
+                    });
+  }
+
+  struct HeapTimer {
+    guint64 expiry;
+    size_t  connection;
+    bool    cancelled;
+  };
+
+  int heap_timer_compare (gconstpointer a, gconstpointer b)
+  {
+    guint64 lhs = static_cast <const HeapTimer *> (a)->expiry;
+    guint64 rhs = static_cast <const HeapTimer *> (b)->expiry;
+
+    return lhs == rhs ? 0 : (lhs < rhs ? -1 : 1);
+  }
+
+  /* A heap can't remove an arbitrary timer, so cancelled timers are
+   * marked and skipped over when they reach the top */
+  double run_minheap (size_t n_connections)
+  {
+    return best_of (3,
+                    []() {},
+                    [&]() {
+                      Workload workload (n_connections);
+                      g_autoptr(GPtrArray) heap = g_ptr_array_new ();
+                      std::deque <HeapTimer> timers;
+                      std::vector <HeapTimer *> current (n_connections);
+
+                      auto schedule = [&](size_t c, guint64 expiry) {
+                        timers.push_back (HeapTimer { expiry, c, false });
+                        current[c] = &timers.back ();
+                        g_algorithm_insert_minheap (heap, current[c], heap_timer_compare);
+                      };
+
+                      for (size_t c = 0; c < n_connections; ++c)
+                        schedule (c, workload.timeout ());
+
+                      std::vector <size_t> expired;
+
+                      for (guint64 now = 1; now <= TICKS; ++now)
+                        {
+                          for (size_t i = 0; i < n_connections / ACTIVITY_DIVISOR; ++i)
+                            {
+                              size_t c = workload.active_connection ();
+
+                              current[c]->cancelled = true;
+                              schedule (c, now + workload.timeout ());
+                            }
+
+                          expired.clear ();
+
+                          for (;;)
+                            {
+                              auto *timer = static_cast <HeapTimer *> (g_algorithm_minheap_pop (heap, heap_timer_compare));
+
+                              if (timer == NULL)
+                                break;
+
+                              if (timer->expiry > now)
+                                {
+                                  g_algorithm_insert_minheap (heap, timer, heap_timer_compare);
+                                  break;
+                                }
+
+                              if (!timer->cancelled)
+                                expired.push_back (timer->connection);
+                            }
+
+                          for (size_t c : expired)
+                            schedule (c, now + workload.timeout ());
+                        }
+                    });
+  }
+}
+
+int main (void)
+{
+  for (size_t n_connections : { 10000, 100000, 1000000 })
+    {
+      report ("schedule/cancel/expire: timing wheel", n_connections, run_timing_wheel (n_connections));
+      report ("schedule/cancel/expire: minheap", n_connections, run_minheap (n_connections));
+    }
+
+  return 0;
+}
@@ -0,0 +1,534 @@
+/*
+ * /galgorithm/galgorithm-accessor.c
+ *
+ * Implementation for GAlgorithm Accessor, which sorts and searches
+ * containers in place through a table of get, swap and length
+ * functions, with adapters for GPtrArray, GSequence and GListModel.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <gio/gio.h>
+#include <glib.h>
+
+#include <galgorithm/galgorithm-accessor.h>
+#include <galgorithm/galgorithm-stats-private.h>
+
+/* Ranges this short are finished off with an insertion sort */
+#define INSERTION_SORT_THRESHOLD 16
+
+static size_t
+ptr_array_get_length (gpointer container)
+{
+  return ((GPtrArray *) container)->len;
+}
+
+static gpointer
+ptr_array_get (gpointer container, size_t index)
+{
+  return ((GPtrArray *) container)->pdata[index];
+}
+
+static void
+ptr_array_swap (gpointer container, size_t a, size_t b)
+{
+  gpointer *pdata = ((GPtrArray *) container)->pdata;
+  gpointer tmp = pdata[a];
+
+  pdata[a] = pdata[b];
+  pdata[b] = tmp;
+}
+
+static const GAlgorithmAccessor ptr_array_accessor = {
+  ptr_array_get_length,
+  ptr_array_get,
+  ptr_array_swap,
+  NULL
+};
+
+/* Positions in a GSequence are found by walking down its tree, so
+ * each of these is O(log N) */
+static size_t
+sequence_get_length (gpointer container)
+{
+  return g_sequence_get_length (container);
+}
+
+static gpointer
+sequence_get (gpointer container, size_t index)
+{
+  return g_sequence_get (g_sequence_get_iter_at_pos (container, index));
+}
+
+static void
+sequence_swap (gpointer container, size_t a, size_t b)
+{
+  g_sequence_swap (g_sequence_get_iter_at_pos (container, a),
+                   g_sequence_get_iter_at_pos (container, b));
+}
+
+static const GAlgorithmAccessor sequence_accessor = {
+  sequence_get_length,
+  sequence_get,
+  sequence_swap,
+  NULL
+};
+
+static size_t
+list_model_get_length (gpointer container)
+{
+  return g_list_model_get_n_items (container);
+}
+
+/* Models are free to make their items on demand, so the reference
+ * g_list_model_get_item() gives us is held until the item is released */
+static gpointer
+list_model_get (gpointer container, size_t index)
+{
+  return g_list_model_get_item (container, index);
+}
+
+static void
+list_model_release (gpointer container, gpointer element)
+{
+  g_object_unref (element);
+}
+
+static const GAlgorithmAccessor list_model_accessor = {
+  list_model_get_length,
+  list_model_get,
+  NULL,
+  list_model_release
+};
+
+/* A GListStore can't move its items without announcing every move,
+ * so it is sorted through a permutation of its positions instead. The
+ * positions themselves are the elements, so that they can be compared
+ * as a tie break. */
+typedef struct {
+  guint *positions;
+  guint  n_positions;
+} ListStorePermutation;
+
+typedef struct {
+  GListModel            *model;
+  GAlgorithmCompareFunc  cmp;
+} ListStorePermutationCompare;
+
+static size_t
+permutation_get_length (gpointer container)
+{
+  return ((ListStorePermutation *) container)->n_positions;
+}
+
+static gpointer
+permutation_get (gpointer container, size_t index)
+{
+  return GUINT_TO_POINTER (((ListStorePermutation *) container)->positions[index]);
+}
+
+static void
+permutation_swap (gpointer container, size_t a, size_t b)
+{
+  guint *positions = ((ListStorePermutation *) container)->positions;
+  guint tmp = positions[a];
+
+  positions[a] = positions[b];
+  positions[b] = tmp;
+}
+
+static const GAlgorithmAccessor permutation_accessor = {
+  permutation_get_length,
+  permutation_get,
+  permutation_swap,
+  NULL
+};
+
+/* Equal items are ordered by where they started, so no two positions
+ * compare equal. That makes the sort stable, and a store which is
+ * already sorted gives back the identity permutation. */
+static int
+permutation_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  ListStorePermutationCompare *compare = user_data;
+  guint position_a = GPOINTER_TO_UINT (a);
+  guint position_b = GPOINTER_TO_UINT (b);
+  g_autoptr(GObject) item_a = g_list_model_get_item (compare->model, position_a);
+  g_autoptr(GObject) item_b = g_list_model_get_item (compare->model, position_b);
+  int result = compare->cmp (item_a, item_b);
+
+  if (result != 0)
+    return result;
+
+  return (position_a > position_b) - (position_a < position_b);
+}
+
+/* The sorts below take a comparator with user data, so that the
+ * permutation can be compared against its model. Public callers pass
+ * a plain GAlgorithmCompareFunc, which is the user data here. */
+static int
+compare_elements (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  GAlgorithmCompareFunc cmp = *(GAlgorithmCompareFunc *) user_data;
+
+  return cmp (a, b);
+}
+
+static inline int
+accessor_compare (GCompareDataFunc cmp,
+                  gpointer         cmp_data,
+                  gconstpointer    a,
+                  gconstpointer    b)
+{
+  G_ALGORITHM_STATS_ADD (comparisons, 1);
+
+  return cmp (a, b, cmp_data);
+}
+
+static inline void
+accessor_release (const GAlgorithmAccessor *accessor,
+                  gpointer                  container,
+                  gpointer                  element)
+{
+  if (accessor->release != NULL)
+    accessor->release (container, element);
+}
+
+/* Compare the elements at @a and @b, holding on to each of them
+ * only for as long as the comparison */
+static int
+accessor_compare_positions (const GAlgorithmAccessor *accessor,
+                            gpointer                  container,
+                            GCompareDataFunc          cmp,
+                            gpointer                  cmp_data,
+                            size_t                    a,
+                            size_t                    b)
+{
+  gpointer element_a = accessor->get (container, a);
+  gpointer element_b = accessor->get (container, b);
+  int result = accessor_compare (cmp, cmp_data, element_a, element_b);
+
+  accessor_release (accessor, container, element_a);
+  accessor_release (accessor, container, element_b);
+
+  return result;
+}
+
+static inline void
+accessor_swap (const GAlgorithmAccessor *accessor,
+               gpointer                  container,
+               size_t                    a,
+               size_t                    b)
+{
+  accessor->swap (container, a, b);
+
+  G_ALGORITHM_STATS_ADD (swaps, 1);
+}
+
+/* Sort [@lower, @upper) by sinking each element into place */
+static void
+accessor_insertion_sort (const GAlgorithmAccessor *accessor,
+                         gpointer                  container,
+                         GCompareDataFunc          cmp,
+                         gpointer                  cmp_data,
+                         size_t                    lower,
+                         size_t                    upper)
+{
+  /* The element being sunk is always at j, so comparing by position
+   * is the same as comparing against it */
+  for (size_t i = lower + 1; i < upper; ++i)
+    for (size_t j = i;
+         j > lower && accessor_compare_positions (accessor, container, cmp, cmp_data, j, j - 1) < 0;
+         --j)
+      accessor_swap (accessor, container, j, j - 1);
+}
+
+/* Partition [@lower, @upper) around the median of its first, middle
+ * and last elements, returning where the pivot ends up. Elements
+ * equal to the pivot stop both scans, which keeps the partition
+ * balanced when there are lots of duplicates. */
+static size_t
+accessor_partition (const GAlgorithmAccessor *accessor,
+                    gpointer                  container,
+                    GCompareDataFunc          cmp,
+                    gpointer                  cmp_data,
+                    size_t                    lower,
+                    size_t                    upper)
+{
+  size_t middle = lower + (upper - lower) / 2;
+  size_t last = upper - 1;
+
+  if (accessor_compare_positions (accessor, container, cmp, cmp_data, middle, lower) < 0)
+    accessor_swap (accessor, container, middle, lower);
+  if (accessor_compare_positions (accessor, container, cmp, cmp_data, last, lower) < 0)
+    accessor_swap (accessor, container, last, lower);
+  if (accessor_compare_positions (accessor, container, cmp, cmp_data, last, middle) < 0)
+    accessor_swap (accessor, container, last, middle);
+
+  /* The median goes first, and the last element is now no less than
+   * it, so the left scan can't run off the end */
+  accessor_swap (accessor, container, lower, middle);
+
+  /* The pivot stays at @lower until the scans are done */
+  size_t i = lower;
+  size_t j = upper;
+
+  for (;;)
+    {
+      do
+        ++i;
+      while (accessor_compare_positions (accessor, container, cmp, cmp_data, i, lower) < 0);
+
+      do
+        --j;
+      while (accessor_compare_positions (accessor, container, cmp, cmp_data, lower, j) < 0);
+
+      if (i >= j)
+        break;
+
+      accessor_swap (accessor, container, i, j);
+    }
+
+  accessor_swap (accessor, container, lower, j);
+  return j;
+}
+
+static void
+accessor_quicksort (const GAlgorithmAccessor *accessor,
+                    gpointer                  container,
+                    GCompareDataFunc          cmp,
+                    gpointer                  cmp_data,
+                    size_t                    lower,
+                    size_t                    upper)
+{
+  /* Recurse into the smaller side and loop on the larger one, so
+   * the stack stays O(log N) deep */
+  while (upper - lower > INSERTION_SORT_THRESHOLD)
+    {
+      size_t pivot = accessor_partition (accessor, container, cmp, cmp_data, lower, upper);
+
+      if (pivot - lower < upper - pivot)
+        {
+          accessor_quicksort (accessor, container, cmp, cmp_data, lower, pivot);
+          lower = pivot + 1;
+        }
+      else
+        {
+          accessor_quicksort (accessor, container, cmp, cmp_data, pivot + 1, upper);
+          upper = pivot;
+        }
+    }
+
+  accessor_insertion_sort (accessor, container, cmp, cmp_data, lower, upper);
+}
+
+/**
+ * g_algorithm_accessor_for_ptr_array:
+ *
+ * Get a #GAlgorithmAccessor for a #GPtrArray container.
+ *
+ * Returns: (transfer none): A #GAlgorithmAccessor for #GPtrArray.
+ */
+const GAlgorithmAccessor *
+g_algorithm_accessor_for_ptr_array (void)
+{
+  return &ptr_array_accessor;
+}
+
+/**
+ * g_algorithm_accessor_for_sequence:
+ *
+ * Get a #GAlgorithmAccessor for a #GSequence container. Reaching an
+ * element by position costs O(log N) in a #GSequence, so sorting one
+ * this way takes O(N log^2 N) time, but needs no extra memory.
+ *
+ * Returns: (transfer none): A #GAlgorithmAccessor for #GSequence.
+ */
+const GAlgorithmAccessor *
+g_algorithm_accessor_for_sequence (void)
+{
+  return &sequence_accessor;
+}
+
+/**
+ * g_algorithm_accessor_for_list_model:
+ *
+ * Get a #GAlgorithmAccessor for a #GListModel container, which can be
+ * searched but not sorted. Each item is only referenced while it is
+ * being compared, so models which make their items on demand work
+ * too. To sort a #GListStore, use g_algorithm_accessor_sort_list_store().
+ *
+ * Returns: (transfer none): A #GAlgorithmAccessor for #GListModel.
+ */
+const GAlgorithmAccessor *
+g_algorithm_accessor_for_list_model (void)
+{
+  return &list_model_accessor;
+}
+
+/**
+ * g_algorithm_accessor_sort:
+ * @accessor: A #GAlgorithmAccessor with a swap function.
+ * @container: The container to sort, of the kind @accessor is for.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to order elements by.
+ *
+ * Sort @container in place with a quicksort that only moves elements
+ * through @accessor. The sort is not stable.
+ */
+void
+g_algorithm_accessor_sort (const GAlgorithmAccessor *accessor,
+                           gpointer                  container,
+                           GAlgorithmCompareFunc     cmp)
+{
+  g_return_if_fail(accessor != NULL);
+  g_return_if_fail(accessor->swap != NULL);
+  g_return_if_fail(cmp != NULL);
+
+  size_t len = accessor->get_length (container);
+
+  if (len <= 1)
+    return;
+
+  G_ALGORITHM_OPERATION_BEGIN (accessor_sort, len);
+
+  accessor_quicksort (accessor, container, compare_elements, &cmp, 0, len);
+
+  G_ALGORITHM_OPERATION_END (accessor_sort, len);
+}
+
+/**
+ * g_algorithm_accessor_binary_search:
+ * @accessor: A #GAlgorithmAccessor.
+ * @container: The container to search, of the kind @accessor is for.
+ * @needle: An element to search for.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc, which @container is
+ *       sorted by.
+ *
+ * Do a binary search on sorted data reached through @accessor.
+ *
+ * Return: The position of @needle in @container on success, -1 on failure.
+ */
+int64_t g_algorithm_accessor_binary_search (const GAlgorithmAccessor *accessor,
+                                            gpointer                  container,
+                                            gpointer                  needle,
+                                            GAlgorithmCompareFunc     cmp)
+{
+  g_return_val_if_fail(accessor != NULL, -1);
+  g_return_val_if_fail(cmp != NULL, -1);
+
+  size_t len = accessor->get_length (container);
+
+  if (len == 0)
+    return -1;
+
+  G_ALGORITHM_OPERATION_BEGIN (accessor_binary_search, len);
+
+  size_t floor_index = 0;
+  size_t ceil_index = len;
+
+  while (floor_index < ceil_index)
+    {
+      size_t midpoint = floor_index + ((ceil_index - floor_index) / 2);
+      gpointer element = accessor->get (container, midpoint);
+      int cmp_result = G_ALGORITHM_STATS_COMPARE (cmp, needle, element);
+
+      accessor_release (accessor, container, element);
+
+      if (cmp_result == 0)
+        {
+          G_ALGORITHM_OPERATION_END (accessor_binary_search, len);
+          return (int64_t) midpoint;
+        }
+
+      if (cmp_result > 0)
+        floor_index = midpoint + 1;
+      else
+        ceil_index = midpoint;
+    }
+
+  G_ALGORITHM_OPERATION_END (accessor_binary_search, len);
+  return -1;
+}
+
+/**
+ * g_algorithm_accessor_sort_list_store:
+ * @store: A #GListStore.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to order items by.
+ *
+ * Do a stable sort on the items of @store in place. The items are
+ * compared where they are, and moved into their sorted order with a
+ * single splice, so
+ * @store emits #GListModel::items-changed at most once, and not at
+ * all if it was already sorted.
+ */
+void
+g_algorithm_accessor_sort_list_store (GListStore            *store,
+                                      GAlgorithmCompareFunc  cmp)
+{
+  g_return_if_fail(store != NULL);
+  g_return_if_fail(cmp != NULL);
+
+  GListModel *model = G_LIST_MODEL (store);
+  guint n_items = g_list_model_get_n_items (model);
+
+  if (n_items <= 1)
+    return;
+
+  g_autofree guint *positions = g_new (guint, n_items);
+  ListStorePermutation permutation = { positions, n_items };
+  ListStorePermutationCompare compare = { model, cmp };
+
+  for (guint i = 0; i < n_items; ++i)
+    positions[i] = i;
+
+  G_ALGORITHM_OPERATION_BEGIN (accessor_sort, n_items);
+
+  accessor_quicksort (&permutation_accessor,
+                      &permutation,
+                      permutation_compare,
+                      &compare,
+                      0,
+                      n_items);
+
+  G_ALGORITHM_OPERATION_END (accessor_sort, n_items);
+
+  /* Only splice the range of items which actually moved */
+  guint first_moved = 0;
+  guint end_moved = n_items;
+
+  while (first_moved < n_items && positions[first_moved] == first_moved)
+    ++first_moved;
+
+  if (first_moved == n_items)
+    return;
+
+  while (positions[end_moved - 1] == end_moved - 1)
+    --end_moved;
+
+  /* Splicing drops the store's references before taking new ones, so
+   * hold our own on the items across it */
+  g_autoptr(GPtrArray) sorted = g_ptr_array_new_full (end_moved - first_moved, g_object_unref);
+
+  for (guint i = first_moved; i < end_moved; ++i)
+    g_ptr_array_add (sorted, g_list_model_get_item (model, positions[i]));
+
+  g_list_store_splice (store,
+                       first_moved,
+                       sorted->len,
+                       sorted->pdata,
+                       sorted->len);
+}
@@ -0,0 +1,123 @@
+/*
+ * /galgorithm/galgorithm-accessor.h
+ *
+ * Forward declarations for GAlgorithm Accessor.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+/**
+ * GAlgorithmAccessorLengthFunc:
+ * @container: The container being accessed.
+ *
+ * Get the number of elements in @container.
+ *
+ * Returns: The number of elements in @container.
+ */
+typedef size_t (*GAlgorithmAccessorLengthFunc) (gpointer container);
+
+/**
+ * GAlgorithmAccessorGetFunc:
+ * @container: The container being accessed.
+ * @index: The position of the element to get.
+ *
+ * Get the element at @index in @container. If the accessor has a
+ * release function, the element is only valid until it is passed to
+ * that. Otherwise the container must keep it alive.
+ *
+ * Returns: (transfer none): The element at @index.
+ */
+typedef gpointer (*GAlgorithmAccessorGetFunc) (gpointer container,
+                                               size_t   index);
+
+/**
+ * GAlgorithmAccessorSwapFunc:
+ * @container: The container being accessed.
+ * @a: The position of one element.
+ * @b: The position of the other element.
+ *
+ * Exchange the elements at @a and @b in @container.
+ */
+typedef void (*GAlgorithmAccessorSwapFunc) (gpointer container,
+                                            size_t   a,
+                                            size_t   b);
+
+/**
+ * GAlgorithmAccessorReleaseFunc:
+ * @container: The container being accessed.
+ * @element: An element returned by the #GAlgorithmAccessorGetFunc.
+ *
+ * Release an element once it is no longer needed, for containers
+ * which make or reference their elements as they are fetched.
+ */
+typedef void (*GAlgorithmAccessorReleaseFunc) (gpointer container,
+                                               gpointer element);
+
+/**
+ * GAlgorithmAccessor:
+ * @get_length: A #GAlgorithmAccessorLengthFunc.
+ * @get: A #GAlgorithmAccessorGetFunc.
+ * @swap: (nullable): A #GAlgorithmAccessorSwapFunc, or %NULL if the
+ *        container can only be searched.
+ * @release: (nullable): A #GAlgorithmAccessorReleaseFunc, or %NULL if
+ *           the container keeps its elements alive itself.
+ *
+ * A table of functions to reach the elements of some container by
+ * position, so that it can be sorted and searched in place instead
+ * of being copied into a #GPtrArray first.
+ *
+ * Elements are moved by swapping rather than setting them, since
+ * containers like #GSequence own their elements and would free the
+ * one being overwritten.
+ */
+typedef struct {
+  GAlgorithmAccessorLengthFunc  get_length;
+  GAlgorithmAccessorGetFunc     get;
+  GAlgorithmAccessorSwapFunc    swap;
+  GAlgorithmAccessorReleaseFunc release;
+} GAlgorithmAccessor;
+
+const GAlgorithmAccessor * g_algorithm_accessor_for_ptr_array (void);
+
+const GAlgorithmAccessor * g_algorithm_accessor_for_sequence (void);
+
+const GAlgorithmAccessor * g_algorithm_accessor_for_list_model (void);
+
+void g_algorithm_accessor_sort (const GAlgorithmAccessor *accessor,
+                                gpointer                  container,
+                                GAlgorithmCompareFunc     cmp);
+
+int64_t g_algorithm_accessor_binary_search (const GAlgorithmAccessor *accessor,
+                                            gpointer                  container,
+                                            gpointer                  needle,
+                                            GAlgorithmCompareFunc     cmp);
+
+void g_algorithm_accessor_sort_list_store (GListStore            *store,
+                                           GAlgorithmCompareFunc  cmp);
+
+G_END_DECLS
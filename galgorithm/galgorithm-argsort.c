@@ -0,0 +1,354 @@
+/*
+ * /galgorithm/galgorithm-argsort.c
+ *
+ * Implementation for GAlgorithm Argsort, which computes the permutation
+ * that would sort an array instead of moving its elements, and for
+ * applying such a permutation in-place.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-argsort.h>
+
+/* Ranges smaller than this are finished off with insertion sort */
+#define INSERTION_SORT_THRESHOLD 16
+
+static inline void
+swap (guint32 *lhs, guint32 *rhs)
+{
+  guint32 tmp = *lhs;
+  *lhs = *rhs;
+  *rhs = tmp;
+}
+
+static GArray *
+identity_permutation (size_t len)
+{
+  GArray *indices = g_array_sized_new (FALSE, FALSE, sizeof (guint32), len);
+
+  g_array_set_size (indices, len);
+
+  for (size_t i = 0; i < len; ++i)
+    g_array_index (indices, guint32, i) = (guint32) i;
+
+  return indices;
+}
+
+static void
+insertion_sort_indices (gpointer              *pdata,
+                        guint32               *indices,
+                        size_t                 len,
+                        GAlgorithmCompareFunc  cmp)
+{
+  for (size_t i = 1; i < len; ++i)
+    {
+      guint32 candidate = indices[i];
+      size_t j = i;
+
+      for (; j > 0 && cmp (pdata[candidate], pdata[indices[j - 1]]) < 0; --j)
+        indices[j] = indices[j - 1];
+
+      indices[j] = candidate;
+    }
+}
+
+/*
+ * Hoare partition the indices in [@lower, @upper) around the median of
+ * the first, middle and last elements. Returns the split point, where
+ * everything before it is <= the pivot and everything from it onwards
+ * is >= the pivot. Both halves are non-empty.
+ */
+static size_t
+partition_indices (gpointer              *pdata,
+                   guint32               *indices,
+                   size_t                 lower,
+                   size_t                 upper,
+                   GAlgorithmCompareFunc  cmp)
+{
+  size_t middle = lower + (upper - lower) / 2;
+
+  if (cmp (pdata[indices[middle]], pdata[indices[lower]]) < 0)
+    swap (&indices[middle], &indices[lower]);
+  if (cmp (pdata[indices[upper - 1]], pdata[indices[middle]]) < 0)
+    swap (&indices[upper - 1], &indices[middle]);
+  if (cmp (pdata[indices[middle]], pdata[indices[lower]]) < 0)
+    swap (&indices[middle], &indices[lower]);
+
+  gpointer pivot = pdata[indices[middle]];
+  size_t i = lower;
+  size_t j = upper - 1;
+
+  for (;;)
+    {
+      while (cmp (pdata[indices[i]], pivot) < 0)
+        ++i;
+      while (cmp (pivot, pdata[indices[j]]) < 0)
+        --j;
+
+      if (i >= j)
+        return j + 1;
+
+      swap (&indices[i++], &indices[j--]);
+    }
+}
+
+/**
+ * g_algorithm_argsort:
+ * @array: (element-type GObject): A #GPtrArray
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Compute the permutation that sorts @array, without moving any of
+ * its elements. The result can be applied to @array and to any other
+ * arrays running parallel to it with
+ * g_algorithm_apply_permutation_ptr_array() and
+ * g_algorithm_apply_permutation_array().
+ *
+ * This uses quicksort, so elements that compare equal may end up in
+ * any order. Use g_algorithm_argsort_stable() if that matters.
+ *
+ * Return: (transfer full) (element-type guint32): A new #GArray where the
+ *         element at each position is the index in @array of the element
+ *         that belongs at that position once sorted.
+ */
+GArray * g_algorithm_argsort (GPtrArray             *array,
+                              GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+  g_return_val_if_fail(array->len <= G_MAXUINT32, NULL);
+
+  GArray *permutation = identity_permutation (array->len);
+  guint32 *indices = (guint32 *) permutation->data;
+
+  /* Non-recursive, same as g_algorithm_quicksort. Always push the
+   * larger half first so that the stack stays O(log N) deep. */
+  g_autoptr(GArray) stack = g_array_new (FALSE, FALSE, sizeof (size_t));
+  size_t bounds[2] = { 0, array->len };
+
+  g_array_append_vals (stack, bounds, 2);
+
+  while (stack->len > 0)
+    {
+      size_t upper = g_array_index (stack, size_t, stack->len - 1);
+      size_t lower = g_array_index (stack, size_t, stack->len - 2);
+      g_array_set_size (stack, stack->len - 2);
+
+      if (upper - lower < INSERTION_SORT_THRESHOLD)
+        {
+          insertion_sort_indices (array->pdata, &indices[lower], upper - lower, cmp);
+          continue;
+        }
+
+      size_t split = partition_indices (array->pdata, indices, lower, upper, cmp);
+      size_t lower_half[2] = { lower, split };
+      size_t upper_half[2] = { split, upper };
+
+      if (split - lower > upper - split)
+        {
+          g_array_append_vals (stack, lower_half, 2);
+          g_array_append_vals (stack, upper_half, 2);
+        }
+      else
+        {
+          g_array_append_vals (stack, upper_half, 2);
+          g_array_append_vals (stack, lower_half, 2);
+        }
+    }
+
+  return permutation;
+}
+
+/**
+ * g_algorithm_argsort_stable:
+ * @array: (element-type GObject): A #GPtrArray
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Like g_algorithm_argsort(), but elements that compare equal keep
+ * their original relative order. This is a bottom-up merge sort over
+ * the indices, ping-ponging between two index buffers in the same way
+ * as g_algorithm_merge_sort().
+ *
+ * Return: (transfer full) (element-type guint32): A new #GArray where the
+ *         element at each position is the index in @array of the element
+ *         that belongs at that position once sorted.
+ */
+GArray * g_algorithm_argsort_stable (GPtrArray             *array,
+                                     GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+  g_return_val_if_fail(array->len <= G_MAXUINT32, NULL);
+
+  size_t len = array->len;
+  GArray *permutation = identity_permutation (len);
+  g_autoptr(GArray) buf = identity_permutation (len);
+
+  guint32 *input = (guint32 *) buf->data;
+  guint32 *output = (guint32 *) permutation->data;
+  gpointer *pdata = array->pdata;
+
+  /* Insertion sort small runs first, then merge them */
+  for (size_t start = 0; start < len; start += INSERTION_SORT_THRESHOLD)
+    insertion_sort_indices (pdata, &input[start], MIN (INSERTION_SORT_THRESHOLD, len - start), cmp);
+
+  for (size_t window = INSERTION_SORT_THRESHOLD; window < len; window <<= 1)
+    {
+      for (size_t start = 0; start < len; start += 2 * window)
+        {
+          size_t middle = MIN (start + window, len);
+          size_t end = MIN (start + 2 * window, len);
+          size_t j = start;
+          size_t k = middle;
+          size_t p = start;
+
+          while (j < middle && k < end)
+            output[p++] = cmp (pdata[input[k]], pdata[input[j]]) < 0 ? input[k++] : input[j++];
+
+          while (j < middle)
+            output[p++] = input[j++];
+
+          while (k < end)
+            output[p++] = input[k++];
+        }
+
+      /* Buffer swap */
+      guint32 *tmp = input;
+      input = output;
+      output = tmp;
+    }
+
+  /* Make sure the sorted indices end up in the array we return */
+  if (input != (guint32 *) permutation->data)
+    memcpy (permutation->data, input, len * sizeof (guint32));
+
+  return permutation;
+}
+
+/* Follow each cycle of @permutation, calling @move (dst, src) to
+ * gather the element at src into dst. The element at the start of
+ * each cycle is first saved with @save and finally put in place with
+ * @restore. Visited positions are tracked in a bitmap, which is much
+ * smaller than a second copy of the array. */
+#define APPLY_PERMUTATION(len, permutation, save, move, restore)              \
+  G_STMT_START {                                                              \
+    const guint32 *_perm = (const guint32 *) (permutation)->data;             \
+    g_autofree guint8 *_visited = g_new0 (guint8, (len) / 8 + 1);             \
+                                                                              \
+    for (size_t _start = 0; _start < (len); ++_start)                         \
+      {                                                                       \
+        if (_visited[_start / 8] & (1 << (_start % 8)))                       \
+          continue;                                                           \
+                                                                              \
+        save (_start);                                                        \
+        size_t _j = _start;                                                   \
+                                                                              \
+        for (;;)                                                              \
+          {                                                                   \
+            size_t _k = _perm[_j];                                            \
+            _visited[_j / 8] |= (guint8) (1 << (_j % 8));                     \
+                                                                              \
+            if (_k == _start)                                                 \
+              {                                                               \
+                restore (_j);                                                 \
+                break;                                                        \
+              }                                                               \
+                                                                              \
+            move (_j, _k);                                                    \
+            _j = _k;                                                          \
+          }                                                                   \
+      }                                                                       \
+  } G_STMT_END
+
+/**
+ * g_algorithm_apply_permutation_ptr_array:
+ * @array: (element-type gpointer): A #GPtrArray
+ * @permutation: (element-type guint32): A #GArray of indices, such as the
+ *               one returned by g_algorithm_argsort(). It must be a
+ *               permutation of 0 to @array->len - 1.
+ *
+ * Reorder @array in-place so that the element at each position i is
+ * the one that was previously at position @permutation[i]. Each cycle
+ * of the permutation is followed in turn, so no copy of @array is made.
+ *
+ * Return: (transfer none) (element-type gpointer): @array, reordered in-place.
+ */
+GPtrArray * g_algorithm_apply_permutation_ptr_array (GPtrArray *array,
+                                                     GArray    *permutation)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(permutation != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (permutation) == sizeof (guint32), NULL);
+  g_return_val_if_fail(permutation->len == array->len, NULL);
+
+  gpointer *pdata = array->pdata;
+  gpointer saved = NULL;
+
+#define SAVE(i) (saved = pdata[i])
+#define MOVE(dst, src) (pdata[dst] = pdata[src])
+#define RESTORE(i) (pdata[i] = saved)
+
+  APPLY_PERMUTATION (array->len, permutation, SAVE, MOVE, RESTORE);
+
+#undef SAVE
+#undef MOVE
+#undef RESTORE
+
+  return array;
+}
+
+/**
+ * g_algorithm_apply_permutation_array:
+ * @array: A #GArray with elements of any size.
+ * @permutation: (element-type guint32): A #GArray of indices, such as the
+ *               one returned by g_algorithm_argsort(). It must be a
+ *               permutation of 0 to @array->len - 1.
+ *
+ * Reorder @array in-place so that the element at each position i is
+ * the one that was previously at position @permutation[i]. Each cycle
+ * of the permutation is followed in turn, so only one element is ever
+ * copied out of @array.
+ *
+ * Return: (transfer none): @array, reordered in-place.
+ */
+GArray * g_algorithm_apply_permutation_array (GArray *array,
+                                              GArray *permutation)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(permutation != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (permutation) == sizeof (guint32), NULL);
+  g_return_val_if_fail(permutation->len == array->len, NULL);
+
+  size_t element_size = g_array_get_element_size (array);
+  guint8 *data = (guint8 *) array->data;
+  g_autofree guint8 *saved = g_malloc (element_size);
+
+#define SAVE(i) memcpy (saved, data + (i) * element_size, element_size)
+#define MOVE(dst, src) memcpy (data + (dst) * element_size, data + (src) * element_size, element_size)
+#define RESTORE(i) memcpy (data + (i) * element_size, saved, element_size)
+
+  APPLY_PERMUTATION (array->len, permutation, SAVE, MOVE, RESTORE);
+
+#undef SAVE
+#undef MOVE
+#undef RESTORE
+
+  return array;
+}
@@ -0,0 +1,44 @@
+/*
+ * /galgorithm/galgorithm-argsort.h
+ *
+ * Forward declarations for GAlgorithm Argsort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+GArray * g_algorithm_argsort (GPtrArray             *array,
+                              GAlgorithmCompareFunc  cmp);
+
+GArray * g_algorithm_argsort_stable (GPtrArray             *array,
+                                     GAlgorithmCompareFunc  cmp);
+
+GPtrArray * g_algorithm_apply_permutation_ptr_array (GPtrArray *array,
+                                                     GArray    *permutation);
+
+GArray * g_algorithm_apply_permutation_array (GArray *array,
+                                              GArray *permutation);
+
+G_END_DECLS
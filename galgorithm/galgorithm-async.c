@@ -0,0 +1,383 @@
+/*
+ * /galgorithm/galgorithm-async.c
+ *
+ * Implementation for asynchronous GAlgorithm sorts, which run the
+ * sort on a worker thread using GTask.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <gio/gio.h>
+#include <glib.h>
+
+#include <galgorithm/galgorithm-async.h>
+#include <galgorithm/galgorithm-merge-sort-private.h>
+#include <galgorithm/galgorithm-quicksort-private.h>
+
+/* Merge this many elements between checks of the cancellable, so
+ * that even the last passes over a huge array cancel quickly */
+#define MERGE_SORT_CHUNK_ELEMENTS (1 << 16)
+
+/* Don't flood the caller's main context with progress updates */
+#define PROGRESS_GRANULARITY 0.01
+
+typedef struct {
+  GPtrArray                    *array;
+  GCompareDataFunc              cmp;
+  gpointer                      cmp_data;
+  GDestroyNotify                cmp_data_destroy;
+  GAlgorithmQuicksortPartition  partition_scheme;
+  GAlgorithmProgressFunc        progress_callback;
+  gpointer                      progress_data;
+  GDestroyNotify                progress_data_destroy;
+  gdouble                       last_progress;
+} SortTaskData;
+
+typedef struct {
+  GTask   *task;
+  gdouble  fraction;
+} ProgressUpdate;
+
+/* The task that the calling worker thread is sorting. The sorts take a
+ * plain GAlgorithmCompareFunc, so the comparator's user data reaches it
+ * through here. A task runs entirely on one worker thread. */
+static GPrivate current_sort_task = G_PRIVATE_INIT (NULL);
+
+static int
+sort_task_compare (gconstpointer a, gconstpointer b)
+{
+  SortTaskData *data = g_private_get (&current_sort_task);
+
+  return data->cmp (a, b, data->cmp_data);
+}
+
+static SortTaskData *
+sort_task_data_new (GPtrArray                    *array,
+                    GCompareDataFunc              cmp,
+                    gpointer                      cmp_data,
+                    GDestroyNotify                cmp_data_destroy,
+                    GAlgorithmQuicksortPartition  partition_scheme,
+                    GAlgorithmProgressFunc        progress_callback,
+                    gpointer                      progress_data,
+                    GDestroyNotify                progress_data_destroy)
+{
+  SortTaskData *data = g_new0 (SortTaskData, 1);
+
+  data->array = g_ptr_array_ref (array);
+  data->cmp = cmp;
+  data->cmp_data = cmp_data;
+  data->cmp_data_destroy = cmp_data_destroy;
+  data->partition_scheme = partition_scheme;
+  data->progress_callback = progress_callback;
+  data->progress_data = progress_data;
+  data->progress_data_destroy = progress_data_destroy;
+  data->last_progress = 0.0;
+
+  return data;
+}
+
+static void
+sort_task_data_free (gpointer user_data)
+{
+  SortTaskData *data = user_data;
+
+  g_ptr_array_unref (data->array);
+
+  if (data->cmp_data_destroy != NULL)
+    data->cmp_data_destroy (data->cmp_data);
+
+  if (data->progress_data_destroy != NULL)
+    data->progress_data_destroy (data->progress_data);
+
+  g_free (data);
+}
+
+static gboolean
+dispatch_progress (gpointer user_data)
+{
+  ProgressUpdate *update = user_data;
+  SortTaskData *data = g_task_get_task_data (update->task);
+
+  data->progress_callback (update->fraction, data->progress_data);
+  return G_SOURCE_REMOVE;
+}
+
+static void
+progress_update_free (gpointer user_data)
+{
+  ProgressUpdate *update = user_data;
+
+  g_object_unref (update->task);
+  g_free (update);
+}
+
+/* Called on the worker thread. The update holds a reference on the
+ * task, so the task data outlives any update still in the queue. */
+static void
+report_progress (GTask   *task,
+                 gdouble  fraction)
+{
+  SortTaskData *data = g_task_get_task_data (task);
+
+  if (data->progress_callback == NULL)
+    return;
+
+  if (fraction < 1.0 && fraction - data->last_progress < PROGRESS_GRANULARITY)
+    return;
+
+  ProgressUpdate *update = g_new0 (ProgressUpdate, 1);
+  update->task = g_object_ref (task);
+  update->fraction = fraction;
+  data->last_progress = fraction;
+
+  g_main_context_invoke_full (g_task_get_context (task),
+                              G_PRIORITY_DEFAULT,
+                              dispatch_progress,
+                              update,
+                              progress_update_free);
+}
+
+static void
+merge_sort_thread (GTask        *task,
+                   gpointer      source_object,
+                   gpointer      task_data,
+                   GCancellable *cancellable)
+{
+  SortTaskData *data = task_data;
+  GAlgorithmMergeSortState state;
+
+  g_private_set (&current_sort_task, data);
+  g_algorithm_merge_sort_state_init (&state, data->array, sort_task_compare);
+
+  while (!g_cancellable_is_cancelled (cancellable) &&
+         g_algorithm_merge_sort_state_step (&state, MERGE_SORT_CHUNK_ELEMENTS))
+    report_progress (task, g_algorithm_merge_sort_state_get_progress (&state));
+
+  /* Puts every element back into the array, even if we stopped early */
+  g_algorithm_merge_sort_state_clear (&state);
+  g_private_set (&current_sort_task, NULL);
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  report_progress (task, 1.0);
+  g_task_return_boolean (task, TRUE);
+}
+
+static gboolean
+quicksort_check (size_t   sorted,
+                 size_t   total,
+                 gpointer user_data)
+{
+  GTask *task = user_data;
+
+  if (g_cancellable_is_cancelled (g_task_get_cancellable (task)))
+    return FALSE;
+
+  report_progress (task, (gdouble) sorted / total);
+  return TRUE;
+}
+
+static void
+quicksort_thread (GTask        *task,
+                  gpointer      source_object,
+                  gpointer      task_data,
+                  GCancellable *cancellable)
+{
+  SortTaskData *data = task_data;
+
+  g_private_set (&current_sort_task, data);
+  g_algorithm_quicksort_with_check (data->array,
+                                    sort_task_compare,
+                                    data->partition_scheme,
+                                    quicksort_check,
+                                    task);
+  g_private_set (&current_sort_task, NULL);
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  report_progress (task, 1.0);
+  g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * g_algorithm_merge_sort_async:
+ * @array: (element-type GObject): A #GPtrArray. It is sorted in-place on a
+ *         worker thread, so it must not be used until the sort finishes.
+ * @cmp: (scope notified) (closure cmp_data) (destroy cmp_data_destroy):
+ *       A #GCompareDataFunc to compare two elements. It is called on the
+ *       worker thread, so bindings which can only run callbacks on the
+ *       main thread should sort with g_algorithm_sort_by_spec() instead.
+ * @cmp_data: (nullable): User data for @cmp.
+ * @cmp_data_destroy: (nullable): A #GDestroyNotify for @cmp_data, called
+ *                    once the sort is finished with @cmp.
+ * @progress_callback: (nullable) (scope notified) (closure progress_data) (destroy progress_data_destroy):
+ *                     A #GAlgorithmProgressFunc to report progress with,
+ *                     or %NULL.
+ * @progress_data: (nullable): User data for @progress_callback.
+ * @progress_data_destroy: (nullable): A #GDestroyNotify for @progress_data.
+ * @cancellable: (nullable): A #GCancellable, or %NULL.
+ * @callback: (scope async): A #GAsyncReadyCallback to call when the sort
+ *            is done.
+ * @user_data: (closure): User data for @callback.
+ *
+ * Do a merge sort on @array on a worker thread, so that sorting a large
+ * array does not block the main loop. @cancellable is checked regularly
+ * between merge steps, so cancelling takes effect quickly. If the sort
+ * is cancelled, @array still holds all of its elements but in an
+ * unspecified order.
+ *
+ * @progress_callback and @callback are called on the thread-default
+ * main context of the caller.
+ */
+void
+g_algorithm_merge_sort_async (GPtrArray              *array,
+                              GCompareDataFunc        cmp,
+                              gpointer                cmp_data,
+                              GDestroyNotify          cmp_data_destroy,
+                              GAlgorithmProgressFunc  progress_callback,
+                              gpointer                progress_data,
+                              GDestroyNotify          progress_data_destroy,
+                              GCancellable           *cancellable,
+                              GAsyncReadyCallback     callback,
+                              gpointer                user_data)
+{
+  g_return_if_fail(array != NULL);
+  g_return_if_fail(cmp != NULL);
+  g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  g_autoptr(GTask) task = g_task_new (NULL, cancellable, callback, user_data);
+
+  g_task_set_source_tag (task, g_algorithm_merge_sort_async);
+  g_task_set_task_data (task,
+                        sort_task_data_new (array,
+                                            cmp,
+                                            cmp_data,
+                                            cmp_data_destroy,
+                                            G_ALGORITHM_QUICKSORT_PARTITION_LOMUTO,
+                                            progress_callback,
+                                            progress_data,
+                                            progress_data_destroy),
+                        sort_task_data_free);
+  g_task_run_in_thread (task, merge_sort_thread);
+}
+
+/**
+ * g_algorithm_merge_sort_finish:
+ * @result: The #GAsyncResult passed to the callback of
+ *          g_algorithm_merge_sort_async().
+ * @error: Return location for a #GError.
+ *
+ * Finish sorting an array with g_algorithm_merge_sort_async().
+ *
+ * Returns: %TRUE if the array was sorted, %FALSE with @error set if
+ *          the sort was cancelled.
+ */
+gboolean
+g_algorithm_merge_sort_finish (GAsyncResult  *result,
+                               GError       **error)
+{
+  g_return_val_if_fail(g_task_is_valid (result, NULL), FALSE);
+  g_return_val_if_fail(g_task_get_source_tag (G_TASK (result)) == g_algorithm_merge_sort_async, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * g_algorithm_quicksort_async:
+ * @array: (element-type GObject): A #GPtrArray. It is sorted in-place on a
+ *         worker thread, so it must not be used until the sort finishes.
+ * @cmp: (scope notified) (closure cmp_data) (destroy cmp_data_destroy):
+ *       A #GCompareDataFunc to compare two elements. It is called on the
+ *       worker thread, so bindings which can only run callbacks on the
+ *       main thread should sort with g_algorithm_sort_by_spec() instead.
+ * @cmp_data: (nullable): User data for @cmp.
+ * @cmp_data_destroy: (nullable): A #GDestroyNotify for @cmp_data, called
+ *                    once the sort is finished with @cmp.
+ * @partition_scheme: A #GAlgorithmQuicksortPartition to partition with.
+ * @progress_callback: (nullable) (scope notified) (closure progress_data) (destroy progress_data_destroy):
+ *                     A #GAlgorithmProgressFunc to report progress with,
+ *                     or %NULL.
+ * @progress_data: (nullable): User data for @progress_callback.
+ * @progress_data_destroy: (nullable): A #GDestroyNotify for @progress_data.
+ * @cancellable: (nullable): A #GCancellable, or %NULL.
+ * @callback: (scope async): A #GAsyncReadyCallback to call when the sort
+ *            is done.
+ * @user_data: (closure): User data for @callback.
+ *
+ * Do quicksort on @array on a worker thread, the same way as
+ * g_algorithm_quicksort_full(). @cancellable is checked after every
+ * partition. If the sort is cancelled, @array still holds all of its
+ * elements but in an unspecified order.
+ *
+ * @progress_callback and @callback are called on the thread-default
+ * main context of the caller.
+ */
+void
+g_algorithm_quicksort_async (GPtrArray                    *array,
+                             GCompareDataFunc              cmp,
+                             gpointer                      cmp_data,
+                             GDestroyNotify                cmp_data_destroy,
+                             GAlgorithmQuicksortPartition  partition_scheme,
+                             GAlgorithmProgressFunc        progress_callback,
+                             gpointer                      progress_data,
+                             GDestroyNotify                progress_data_destroy,
+                             GCancellable                 *cancellable,
+                             GAsyncReadyCallback           callback,
+                             gpointer                      user_data)
+{
+  g_return_if_fail(array != NULL);
+  g_return_if_fail(cmp != NULL);
+  g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  g_autoptr(GTask) task = g_task_new (NULL, cancellable, callback, user_data);
+
+  g_task_set_source_tag (task, g_algorithm_quicksort_async);
+  g_task_set_task_data (task,
+                        sort_task_data_new (array,
+                                            cmp,
+                                            cmp_data,
+                                            cmp_data_destroy,
+                                            partition_scheme,
+                                            progress_callback,
+                                            progress_data,
+                                            progress_data_destroy),
+                        sort_task_data_free);
+  g_task_run_in_thread (task, quicksort_thread);
+}
+
+/**
+ * g_algorithm_quicksort_finish:
+ * @result: The #GAsyncResult passed to the callback of
+ *          g_algorithm_quicksort_async().
+ * @error: Return location for a #GError.
+ *
+ * Finish sorting an array with g_algorithm_quicksort_async().
+ *
+ * Returns: %TRUE if the array was sorted, %FALSE with @error set if
+ *          the sort was cancelled.
+ */
+gboolean
+g_algorithm_quicksort_finish (GAsyncResult  *result,
+                              GError       **error)
+{
+  g_return_val_if_fail(g_task_is_valid (result, NULL), FALSE);
+  g_return_val_if_fail(g_task_get_source_tag (G_TASK (result)) == g_algorithm_quicksort_async, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
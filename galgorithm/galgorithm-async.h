@@ -0,0 +1,75 @@
+/*
+ * /galgorithm/galgorithm-async.h
+ *
+ * Forward declarations for asynchronous GAlgorithm sorts.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib.h>
+#include <stdint.h>
+
+#include <galgorithm/galgorithm-quicksort.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+/**
+ * GAlgorithmProgressFunc:
+ * @fraction: How much of the sort is done, between 0.0 and 1.0.
+ * @user_data: The user data passed along with the callback.
+ *
+ * Called on the thread-default main context of the caller of an
+ * asynchronous sort to report how far along it is.
+ */
+typedef void (*GAlgorithmProgressFunc) (gdouble  fraction,
+                                        gpointer user_data);
+
+void g_algorithm_merge_sort_async (GPtrArray              *array,
+                                   GCompareDataFunc        cmp,
+                                   gpointer                cmp_data,
+                                   GDestroyNotify          cmp_data_destroy,
+                                   GAlgorithmProgressFunc  progress_callback,
+                                   gpointer                progress_data,
+                                   GDestroyNotify          progress_data_destroy,
+                                   GCancellable           *cancellable,
+                                   GAsyncReadyCallback     callback,
+                                   gpointer                user_data);
+
+gboolean g_algorithm_merge_sort_finish (GAsyncResult  *result,
+                                        GError       **error);
+
+void g_algorithm_quicksort_async (GPtrArray                    *array,
+                                  GCompareDataFunc              cmp,
+                                  gpointer                      cmp_data,
+                                  GDestroyNotify                cmp_data_destroy,
+                                  GAlgorithmQuicksortPartition  partition_scheme,
+                                  GAlgorithmProgressFunc        progress_callback,
+                                  gpointer                      progress_data,
+                                  GDestroyNotify                progress_data_destroy,
+                                  GCancellable                 *cancellable,
+                                  GAsyncReadyCallback           callback,
+                                  gpointer                      user_data);
+
+gboolean g_algorithm_quicksort_finish (GAsyncResult  *result,
+                                       GError       **error);
+
+G_END_DECLS
@@ -23,6 +23,7 @@
 #include <glib.h>
 
 #include <galgorithm/galgorithm-binary-search.h>
+#include <galgorithm/galgorithm-stats-private.h>
 
 
 /**
@@ -49,19 +50,23 @@ int64_t g_algorithm_binary_search (GPtrArray            *array,
     return -1;
   }
 
+  G_ALGORITHM_OPERATION_BEGIN (binary_search, array->len);
+
   /* Now do the binary search. We assume that the array is sorted. */
   size_t floor_index = 0;
-  size_t ceil_index = array->len - 1;
+  size_t ceil_index = array->len;
 
-  while (floor_index <= ceil_index) {
+  /* The needle can only be in [floor_index, ceil_index) */
+  while (floor_index < ceil_index) {
     /* Check using the comparator if we're greater than
      * or less than the midpoint. If we're greater, then
      * midpoint becomes the new floor_index, otherwise
      * midpoint becomes the new ceil_index */
     size_t midpoint = floor_index + ((ceil_index - floor_index) / 2);
-    int cmp_result = cmp (needle, array->pdata[midpoint]);
+    int cmp_result = G_ALGORITHM_STATS_COMPARE (cmp, needle, array->pdata[midpoint]);
 
     if (cmp_result == 0) {
+      G_ALGORITHM_OPERATION_END (binary_search, array->len);
       return (int64_t) midpoint;
     }
 
@@ -73,5 +78,34 @@ int64_t g_algorithm_binary_search (GPtrArray            *array,
   }
 
   /* Didn't find anything */
+  G_ALGORITHM_OPERATION_END (binary_search, array->len);
   return -1;
 }
+
+/**
+ * g_algorithm_binary_search_with_filter:
+ * @array: (element-type GObject): A #GPtrArray
+ * @needle: An entry in @array to search for
+ * @cmp: (scope call): A #GAlgorithmCompareFunc, which @array is sorted by.
+ * @filter: (nullable): A #GAlgorithmBloomFilter built from @array, or %NULL.
+ *
+ * Like g_algorithm_binary_search(), but check @filter first, so that
+ * most needles which are not in @array are rejected with a single probe
+ * instead of log2 (N) comparisons. With a %NULL @filter, this is the
+ * same as g_algorithm_binary_search().
+ *
+ * Return: The index of the @array on success, -1 on failure.
+ */
+int64_t g_algorithm_binary_search_with_filter (GPtrArray             *array,
+                                               gpointer               needle,
+                                               GAlgorithmCompareFunc  cmp,
+                                               GAlgorithmBloomFilter *filter)
+{
+  g_return_val_if_fail(array != NULL, -1);
+  g_return_val_if_fail(cmp != NULL, -1);
+
+  if (filter != NULL && !g_algorithm_bloom_filter_may_contain (filter, needle))
+    return -1;
+
+  return g_algorithm_binary_search (array, needle, cmp);
+}
@@ -25,12 +25,19 @@
 #include <glib.h>
 #include <stdint.h>
 
+#include <galgorithm/galgorithm-bloom-filter.h>
+
 G_BEGIN_DECLS
 
-typedef int (GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
 
 int64_t g_algorithm_binary_search (GPtrArray             *array,
                                    gpointer               needle,
                                    GAlgorithmCompareFunc  cmp);
 
+int64_t g_algorithm_binary_search_with_filter (GPtrArray             *array,
+                                               gpointer               needle,
+                                               GAlgorithmCompareFunc  cmp,
+                                               GAlgorithmBloomFilter *filter);
+
 G_END_DECLS
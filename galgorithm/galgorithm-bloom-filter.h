@@ -0,0 +1,66 @@
+/*
+ * /galgorithm/galgorithm-bloom-filter.h
+ *
+ * Forward declarations for GAlgorithm Bloom Filter.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+#define G_ALGORITHM_TYPE_BLOOM_FILTER (g_algorithm_bloom_filter_get_type ())
+
+typedef struct _GAlgorithmBloomFilter GAlgorithmBloomFilter;
+
+/**
+ * GAlgorithmBloomHashFunc:
+ * @element: The element to hash.
+ *
+ * Hash @element. Elements comparing equal must hash to the same value.
+ * The hash is mixed again before use, so it does not need to be well
+ * distributed.
+ *
+ * Returns: The hash of @element.
+ */
+typedef guint64 (*GAlgorithmBloomHashFunc) (gconstpointer element);
+
+GType g_algorithm_bloom_filter_get_type (void);
+
+GAlgorithmBloomFilter * g_algorithm_bloom_filter_new (GPtrArray               *array,
+                                                      GAlgorithmBloomHashFunc  hash,
+                                                      gdouble                  false_positive_rate);
+
+GAlgorithmBloomFilter * g_algorithm_bloom_filter_ref (GAlgorithmBloomFilter *filter);
+
+void g_algorithm_bloom_filter_unref (GAlgorithmBloomFilter *filter);
+
+gboolean g_algorithm_bloom_filter_may_contain (GAlgorithmBloomFilter *filter,
+                                               gconstpointer          element);
+
+gsize g_algorithm_bloom_filter_get_size (GAlgorithmBloomFilter *filter);
+
+gdouble g_algorithm_bloom_filter_get_bits_per_element (GAlgorithmBloomFilter *filter);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GAlgorithmBloomFilter, g_algorithm_bloom_filter_unref)
+
+G_END_DECLS
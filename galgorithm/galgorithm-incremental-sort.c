@@ -0,0 +1,287 @@
+/*
+ * /galgorithm/galgorithm-incremental-sort.c
+ *
+ * Implementation for GAlgorithm Incremental Sort, a merge sort that
+ * advances a bounded amount at a time so that it can share a thread
+ * with a main loop.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <glib-object.h>
+#include <glib.h>
+
+#include <galgorithm/galgorithm-incremental-sort.h>
+#include <galgorithm/galgorithm-merge-sort-private.h>
+
+/* Merge this many elements between checks of the clock */
+#define TIME_CHECK_ELEMENTS 1024
+
+struct _GAlgorithmIncrementalSort {
+  volatile gint            ref_count;
+  GAlgorithmMergeSortState state;
+  gboolean                 done;
+};
+
+typedef struct {
+  GAlgorithmIncrementalSort         *sort;
+  gint64                             time_slice_us;
+  GAlgorithmIncrementalSortDoneFunc  done_callback;
+  gpointer                           user_data;
+  GDestroyNotify                     user_data_destroy;
+} IncrementalSortSourceData;
+
+G_DEFINE_BOXED_TYPE (GAlgorithmIncrementalSort,
+                     g_algorithm_incremental_sort,
+                     g_algorithm_incremental_sort_ref,
+                     g_algorithm_incremental_sort_unref)
+
+/**
+ * g_algorithm_incremental_sort_new:
+ * @array: (element-type GObject): A #GPtrArray to sort in-place. It must
+ *         not be modified until the sort is done.
+ * @cmp: (scope forever): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Create a new incremental sort for @array. Nothing is sorted until
+ * the sort is advanced with g_algorithm_incremental_sort_step() or by
+ * attaching it to a main context with g_algorithm_incremental_sort_attach().
+ *
+ * The result is the same as g_algorithm_merge_sort(), but the merge
+ * passes can be spread out over as many steps as needed.
+ *
+ * Returns: (transfer full): A new #GAlgorithmIncrementalSort.
+ */
+GAlgorithmIncrementalSort *
+g_algorithm_incremental_sort_new (GPtrArray             *array,
+                                  GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  GAlgorithmIncrementalSort *sort = g_new0 (GAlgorithmIncrementalSort, 1);
+
+  sort->ref_count = 1;
+  sort->done = FALSE;
+  g_algorithm_merge_sort_state_init (&sort->state, g_ptr_array_ref (array), cmp);
+
+  return sort;
+}
+
+/**
+ * g_algorithm_incremental_sort_ref:
+ * @sort: A #GAlgorithmIncrementalSort.
+ *
+ * Take a reference on @sort.
+ *
+ * Returns: (transfer full): @sort.
+ */
+GAlgorithmIncrementalSort *
+g_algorithm_incremental_sort_ref (GAlgorithmIncrementalSort *sort)
+{
+  g_return_val_if_fail(sort != NULL, NULL);
+
+  g_atomic_int_inc (&sort->ref_count);
+  return sort;
+}
+
+/**
+ * g_algorithm_incremental_sort_unref:
+ * @sort: (transfer full): A #GAlgorithmIncrementalSort.
+ *
+ * Release a reference on @sort. If the sort was not done when the last
+ * reference is released, the array holds all of its elements in an
+ * unspecified order.
+ */
+void
+g_algorithm_incremental_sort_unref (GAlgorithmIncrementalSort *sort)
+{
+  g_return_if_fail(sort != NULL);
+
+  if (!g_atomic_int_dec_and_test (&sort->ref_count))
+    return;
+
+  GPtrArray *array = sort->state.array;
+
+  if (!sort->done)
+    g_algorithm_merge_sort_state_clear (&sort->state);
+
+  g_ptr_array_unref (array);
+  g_free (sort);
+}
+
+/**
+ * g_algorithm_incremental_sort_step:
+ * @sort: A #GAlgorithmIncrementalSort.
+ * @max_elements: The most elements to merge in this step, or 0 for
+ *                no limit.
+ * @max_time_us: Roughly the most time to spend in this step in
+ *               microseconds, or 0 for no limit.
+ *
+ * Advance the sort by at most @max_elements merged elements or
+ * @max_time_us microseconds, whichever comes first. The time limit is
+ * checked every 1024 elements.
+ *
+ * Returns: %TRUE if there is still more sorting to do, %FALSE if the
+ *          array is now sorted.
+ */
+gboolean
+g_algorithm_incremental_sort_step (GAlgorithmIncrementalSort *sort,
+                                   size_t                     max_elements,
+                                   gint64                     max_time_us)
+{
+  g_return_val_if_fail(sort != NULL, FALSE);
+
+  if (sort->done)
+    return FALSE;
+
+  gint64 deadline = max_time_us > 0 ? g_get_monotonic_time () + max_time_us : G_MAXINT64;
+  size_t remaining = max_elements > 0 ? max_elements : G_MAXSIZE;
+
+  while (remaining > 0)
+    {
+      size_t chunk = MIN (remaining, TIME_CHECK_ELEMENTS);
+
+      if (!g_algorithm_merge_sort_state_step (&sort->state, chunk))
+        {
+          /* Make sure the sorted elements end up in the array */
+          g_algorithm_merge_sort_state_clear (&sort->state);
+          sort->done = TRUE;
+          return FALSE;
+        }
+
+      remaining -= chunk;
+
+      if (g_get_monotonic_time () >= deadline)
+        break;
+    }
+
+  return TRUE;
+}
+
+/**
+ * g_algorithm_incremental_sort_is_done:
+ * @sort: A #GAlgorithmIncrementalSort.
+ *
+ * Check whether @sort has finished sorting its array.
+ *
+ * Returns: %TRUE if the array is sorted.
+ */
+gboolean
+g_algorithm_incremental_sort_is_done (GAlgorithmIncrementalSort *sort)
+{
+  g_return_val_if_fail(sort != NULL, FALSE);
+
+  return sort->done;
+}
+
+/**
+ * g_algorithm_incremental_sort_get_progress:
+ * @sort: A #GAlgorithmIncrementalSort.
+ *
+ * Get roughly how much of the sort is done.
+ *
+ * Returns: The fraction of the work done, between 0.0 and 1.0.
+ */
+gdouble
+g_algorithm_incremental_sort_get_progress (GAlgorithmIncrementalSort *sort)
+{
+  g_return_val_if_fail(sort != NULL, 0.0);
+
+  if (sort->done)
+    return 1.0;
+
+  return g_algorithm_merge_sort_state_get_progress (&sort->state);
+}
+
+static gboolean
+incremental_sort_source_dispatch (gpointer user_data)
+{
+  IncrementalSortSourceData *data = user_data;
+
+  if (g_algorithm_incremental_sort_step (data->sort, 0, data->time_slice_us))
+    return G_SOURCE_CONTINUE;
+
+  if (data->done_callback != NULL)
+    data->done_callback (data->sort, data->user_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+incremental_sort_source_data_free (gpointer user_data)
+{
+  IncrementalSortSourceData *data = user_data;
+
+  g_algorithm_incremental_sort_unref (data->sort);
+
+  if (data->user_data_destroy != NULL)
+    data->user_data_destroy (data->user_data);
+
+  g_free (data);
+}
+
+/**
+ * g_algorithm_incremental_sort_attach:
+ * @sort: A #GAlgorithmIncrementalSort.
+ * @context: (nullable): The #GMainContext to sort on, or %NULL for the
+ *           global default main context.
+ * @time_slice_us: Roughly the most time to spend sorting per main loop
+ *                 iteration, in microseconds.
+ * @done_callback: (nullable) (scope notified) (closure user_data) (destroy user_data_destroy):
+ *                 A #GAlgorithmIncrementalSortDoneFunc to call once the
+ *                 array is sorted, or %NULL.
+ * @user_data: (nullable): User data for @done_callback.
+ * @user_data_destroy: (nullable): A #GDestroyNotify for @user_data.
+ *
+ * Drive @sort from an idle source on @context, advancing it by
+ * @time_slice_us each time the main loop is idle until it is done. The
+ * source runs at %G_PRIORITY_DEFAULT_IDLE, so redraws and input are
+ * handled in between slices. A time slice of a few milliseconds keeps
+ * a frame-driven main loop within its frame budget.
+ *
+ * Returns: (transfer full): The #GSource driving @sort. Destroy it with
+ *          g_source_destroy() to stop sorting early.
+ */
+GSource *
+g_algorithm_incremental_sort_attach (GAlgorithmIncrementalSort         *sort,
+                                     GMainContext                      *context,
+                                     gint64                             time_slice_us,
+                                     GAlgorithmIncrementalSortDoneFunc  done_callback,
+                                     gpointer                           user_data,
+                                     GDestroyNotify                     user_data_destroy)
+{
+  g_return_val_if_fail(sort != NULL, NULL);
+  g_return_val_if_fail(time_slice_us > 0, NULL);
+
+  IncrementalSortSourceData *data = g_new0 (IncrementalSortSourceData, 1);
+  GSource *source = g_idle_source_new ();
+
+  data->sort = g_algorithm_incremental_sort_ref (sort);
+  data->time_slice_us = time_slice_us;
+  data->done_callback = done_callback;
+  data->user_data = user_data;
+  data->user_data_destroy = user_data_destroy;
+
+  g_source_set_name (source, "GAlgorithmIncrementalSort");
+  g_source_set_callback (source,
+                         incremental_sort_source_dispatch,
+                         data,
+                         incremental_sort_source_data_free);
+  g_source_attach (source, context);
+
+  return source;
+}
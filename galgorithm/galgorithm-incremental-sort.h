@@ -0,0 +1,73 @@
+/*
+ * /galgorithm/galgorithm-incremental-sort.h
+ *
+ * Forward declarations for GAlgorithm Incremental Sort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+#define G_ALGORITHM_TYPE_INCREMENTAL_SORT (g_algorithm_incremental_sort_get_type ())
+
+typedef struct _GAlgorithmIncrementalSort GAlgorithmIncrementalSort;
+
+/**
+ * GAlgorithmIncrementalSortDoneFunc:
+ * @sort: The #GAlgorithmIncrementalSort that finished.
+ * @user_data: The user data passed along with the callback.
+ *
+ * Called once the array being sorted by @sort is fully sorted.
+ */
+typedef void (*GAlgorithmIncrementalSortDoneFunc) (GAlgorithmIncrementalSort *sort,
+                                                   gpointer                   user_data);
+
+GType g_algorithm_incremental_sort_get_type (void);
+
+GAlgorithmIncrementalSort * g_algorithm_incremental_sort_new (GPtrArray             *array,
+                                                              GAlgorithmCompareFunc  cmp);
+
+GAlgorithmIncrementalSort * g_algorithm_incremental_sort_ref (GAlgorithmIncrementalSort *sort);
+
+void g_algorithm_incremental_sort_unref (GAlgorithmIncrementalSort *sort);
+
+gboolean g_algorithm_incremental_sort_step (GAlgorithmIncrementalSort *sort,
+                                            size_t                     max_elements,
+                                            gint64                     max_time_us);
+
+gboolean g_algorithm_incremental_sort_is_done (GAlgorithmIncrementalSort *sort);
+
+gdouble g_algorithm_incremental_sort_get_progress (GAlgorithmIncrementalSort *sort);
+
+GSource * g_algorithm_incremental_sort_attach (GAlgorithmIncrementalSort         *sort,
+                                               GMainContext                      *context,
+                                               gint64                             time_slice_us,
+                                               GAlgorithmIncrementalSortDoneFunc  done_callback,
+                                               gpointer                           user_data,
+                                               GDestroyNotify                     user_data_destroy);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GAlgorithmIncrementalSort, g_algorithm_incremental_sort_unref)
+
+G_END_DECLS
@@ -0,0 +1,69 @@
+/*
+ * /galgorithm/galgorithm-merge-sort-private.h
+ *
+ * Private declarations for the resumable GAlgorithm Merge Sort state,
+ * shared by the blocking, asynchronous and incremental merge sorts.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+#include <galgorithm/galgorithm-merge-sort.h>
+
+G_BEGIN_DECLS
+
+/* A bottom-up merge sort that can be stopped after any number of
+ * merged elements and resumed later. At any point between steps, the
+ * input buffer holds every element of the array exactly once, so the
+ * sort can also be abandoned without losing anything. */
+typedef struct {
+  GPtrArray             *array;
+  GAlgorithmCompareFunc  cmp;
+
+  gpointer              *scratch;
+  gpointer              *input;
+  gpointer              *output;
+
+  size_t                 len;
+  size_t                 window;
+  size_t                 passes_done;
+  size_t                 passes_total;
+
+  /* Cursor into the pair of runs currently being merged */
+  size_t                 j;
+  size_t                 k;
+  size_t                 p;
+  size_t                 middle;
+  size_t                 end;
+} GAlgorithmMergeSortState;
+
+void g_algorithm_merge_sort_state_init (GAlgorithmMergeSortState *state,
+                                        GPtrArray                *array,
+                                        GAlgorithmCompareFunc     cmp);
+
+gboolean g_algorithm_merge_sort_state_step (GAlgorithmMergeSortState *state,
+                                            size_t                    max_elements);
+
+gdouble g_algorithm_merge_sort_state_get_progress (GAlgorithmMergeSortState *state);
+
+void g_algorithm_merge_sort_state_clear (GAlgorithmMergeSortState *state);
+
+G_END_DECLS
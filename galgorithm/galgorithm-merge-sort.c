@@ -21,21 +21,146 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <string.h>
+
 #include <glib.h>
 
 #include <galgorithm/galgorithm-merge-sort.h>
+#include <galgorithm/galgorithm-merge-sort-private.h>
+#include <galgorithm/galgorithm-stats-private.h>
 
 static inline size_t min (size_t a, size_t b) {
   return a < b ? a : b;
 }
 
-static inline unsigned int nearest_greater_power_of_two (size_t length) {
-  unsigned int shift = 0;
-  
-  // Not the most efficient way to do this
-  while ((1 << (shift++)) < length);
-  
-  return shift;
+static void
+merge_sort_state_start_pair (GAlgorithmMergeSortState *state,
+                             size_t                    start)
+{
+  state->j = start;
+  state->p = start;
+  state->middle = min (start + state->window, state->len);
+  state->k = state->middle;
+  state->end = min (start + 2 * state->window, state->len);
+}
+
+/* Not part of the public API, see galgorithm-merge-sort-private.h */
+void
+g_algorithm_merge_sort_state_init (GAlgorithmMergeSortState *state,
+                                   GPtrArray                *array,
+                                   GAlgorithmCompareFunc     cmp)
+{
+  state->array = array;
+  state->cmp = cmp;
+  state->len = array->len;
+
+  /* We first create another buffer of the same size. The first
+   * pass merges from @array into it, then they take turns. */
+  state->scratch = g_new (gpointer, MAX (state->len, 1));
+  G_ALGORITHM_STATS_ADD (scratch_bytes, MAX (state->len, 1) * sizeof (gpointer));
+  state->input = array->pdata;
+  state->output = state->scratch;
+
+  state->window = 1;
+  state->passes_done = 0;
+  state->passes_total = 0;
+
+  for (size_t window = 1; window < state->len; window <<= 1)
+    ++state->passes_total;
+
+  merge_sort_state_start_pair (state, 0);
+}
+
+/* Merge up to @max_elements more elements. Returns TRUE if there is
+ * still work left to do. */
+gboolean
+g_algorithm_merge_sort_state_step (GAlgorithmMergeSortState *state,
+                                   size_t                    max_elements)
+{
+  GAlgorithmCompareFunc cmp = state->cmp;
+
+  while (state->window < state->len)
+    {
+      if (state->p == state->end)
+        {
+          if (state->end < state->len)
+            {
+              merge_sort_state_start_pair (state, state->end);
+              continue;
+            }
+
+          /* Finished a pass. Buffer swap */
+          gpointer *tmp = state->input;
+          state->input = state->output;
+          state->output = tmp;
+
+          state->window <<= 1;
+          ++state->passes_done;
+          G_ALGORITHM_STATS_ADD (passes, 1);
+          merge_sort_state_start_pair (state, 0);
+          continue;
+        }
+
+      if (max_elements == 0)
+        return TRUE;
+
+      gpointer *input = state->input;
+      gpointer *output = state->output;
+      size_t j = state->j;
+      size_t k = state->k;
+      size_t p = state->p;
+      size_t middle = state->middle;
+      size_t end = state->end;
+      size_t stop = p + min (max_elements, end - p);
+
+      max_elements -= stop - p;
+      G_ALGORITHM_STATS_ADD (moves, stop - p);
+
+      /* Take from the left run on ties, which keeps the sort stable */
+      size_t compared_from = p;
+
+      while (p < stop && j < middle && k < end)
+        output[p++] = cmp (input[j], input[k]) > 0 ? input[k++] : input[j++];
+
+      G_ALGORITHM_STATS_ADD (comparisons, p - compared_from);
+
+      /* Now, one of j or k may be exhausted, fill from the one
+       * that remains */
+      while (p < stop && j < middle)
+        output[p++] = input[j++];
+
+      while (p < stop && k < end)
+        output[p++] = input[k++];
+
+      state->j = j;
+      state->k = k;
+      state->p = p;
+    }
+
+  return FALSE;
+}
+
+gdouble
+g_algorithm_merge_sort_state_get_progress (GAlgorithmMergeSortState *state)
+{
+  if (state->window >= state->len)
+    return 1.0;
+
+  return (state->passes_done + (gdouble) state->p / state->len) / state->passes_total;
+}
+
+/* Make sure @array holds the elements in their current order, which is
+ * sorted if state_step returned FALSE, and release the scratch buffer. */
+void
+g_algorithm_merge_sort_state_clear (GAlgorithmMergeSortState *state)
+{
+  if (state->input != state->array->pdata)
+    {
+      memcpy (state->array->pdata, state->input, state->len * sizeof (gpointer));
+      G_ALGORITHM_STATS_ADD (moves, state->len);
+    }
+
+  g_clear_pointer (&state->scratch, g_free);
 }
 
 /**
@@ -57,73 +182,122 @@ GPtrArray * g_algorithm_merge_sort (GPtrArray            *array,
   g_return_val_if_fail(array != NULL, NULL);
   g_return_val_if_fail(cmp != NULL, NULL);
 
-  /* We first create another pointer array of the same size. */
-  g_autoptr(GPtrArray) buf = g_ptr_array_sized_new (array->len);
-  buf->len = array->len;
-
-  /* Do the first merge iteration copying from the input
-   * buffer to to the output buffer */
-  for (size_t i = 0; i < (array->len / 2) * 2; i += 2) {
-    int res = cmp (array->pdata[i], array->pdata[i + 1]);
-    buf->pdata[i] = (res > 0) ? array->pdata[i + 1] : array->pdata[i];
-    buf->pdata[i + 1] = (res > 0) ? array->pdata [i] : array->pdata[i + 1];
-  }
-  
-  /* Handle the remaining element. */
-  if (array->len % 2 != 0) {
-    buf->pdata[array->len - 1] = array->pdata[array->len - 1];
-  }
-  
-  size_t comparisons = nearest_greater_power_of_two(array->len) - 1;
-  size_t window = 2;
-  
-  GPtrArray *input = buf;
-  GPtrArray *output = array;
-  
-  while (comparisons--) {
-    window <<= 1;
-    
-    for (size_t i = 0; i < ((array->len / window) + 1); ++i) {
-      /* Divide into two windows */
-      size_t window_one_start = i * window;
-      size_t window_two_start = window_one_start + (window / 2);
-      
-      size_t j = window_one_start;
-      size_t k = window_two_start;
-      size_t p = window_one_start;
-      
-      while (j < min(window_two_start, array->len) &&
-             k < min(window_one_start + window, array->len)) {
-        int res = cmp(input->pdata[j], input->pdata[k]);
-        output->pdata[p++] = (res > 0) ? input->pdata[k++] : input->pdata[j++];
-      }
-      
-      while (j < min(window_two_start, array->len)) {
-        output->pdata[p++] = input->pdata[j++];
-      }
-      
-      /* Now, one of j or k will be exhausted, fill the rest
-       * of the array from the array that remains */
-      while (k < min(window_one_start + window, array->len)) {
-        output->pdata[p++] = input->pdata[k++];
-      }
+  GAlgorithmMergeSortState state;
+
+  G_ALGORITHM_OPERATION_BEGIN (merge_sort, array->len);
+
+  g_algorithm_merge_sort_state_init (&state, array, cmp);
+  while (g_algorithm_merge_sort_state_step (&state, G_MAXSIZE));
+  g_algorithm_merge_sort_state_clear (&state);
+
+  G_ALGORITHM_OPERATION_END (merge_sort, array->len);
+
+  return array;
+}
+
+typedef struct {
+  gpointer key;
+  gpointer element;
+} KeyedEntry;
+
+/**
+ * g_algorithm_merge_sort_by_key:
+ * @array: (element-type GObject): A #GPtrArray
+ * @key_func: (scope call): A #GAlgorithmKeyFunc to compute the sort key
+ *            of each element.
+ * @key_cmp: (scope call): A #GAlgorithmCompareFunc to compare two keys
+ *           returned by @key_func.
+ * @key_destroy: (scope call) (nullable): A #GDestroyNotify to free each key
+ *               once sorting is done, or %NULL.
+ *
+ * Do a stable merge sort on @array by the key returned by @key_func,
+ * returning a reference to @array (for composability).
+ *
+ * This is a decorate-sort-undecorate sort: @key_func is called exactly
+ * once for each element, with the keys cached next to their elements
+ * in a contiguous buffer. Only @key_cmp is called during the merge
+ * passes, so use this instead of g_algorithm_merge_sort() when comparing
+ * two elements directly is expensive (looking up properties, collating
+ * strings and so on).
+ *
+ * Return: (transfer none) (element-type GObject): @array, sorted in-place.
+ */
+GPtrArray * g_algorithm_merge_sort_by_key (GPtrArray             *array,
+                                           GAlgorithmKeyFunc      key_func,
+                                           GAlgorithmCompareFunc  key_cmp,
+                                           GDestroyNotify         key_destroy)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(key_func != NULL, NULL);
+  g_return_val_if_fail(key_cmp != NULL, NULL);
+
+  size_t len = array->len;
+
+  if (len <= 1)
+    return array;
+
+  G_ALGORITHM_OPERATION_BEGIN (merge_sort_by_key, len);
+
+  /* Decorate: compute each key exactly once */
+  g_autofree KeyedEntry *entries = g_new (KeyedEntry, len);
+  g_autofree KeyedEntry *scratch = g_new (KeyedEntry, len);
+
+  G_ALGORITHM_STATS_ADD (scratch_bytes, 2 * len * sizeof (KeyedEntry));
+
+  for (size_t i = 0; i < len; ++i)
+    {
+      entries[i].key = key_func (array->pdata[i]);
+      entries[i].element = array->pdata[i];
     }
-    
-    /* Buffer swap */
-    GPtrArray *tmp = input;
-    input = output;
-    output = tmp;
-  }
-
-  /* Now, quickly check if our output buffer was the same as @array,
-   * if not, we'll need to do one more copy to ensure that the sorted elements
-   * end up in @array */
-  if (output != array) {
-    for (size_t i = 0; i < array->len; ++i) {
-      array->pdata[i] = output->pdata[i];
+
+  /* Sort: bottom-up merge passes, swapping between the two
+   * buffers after each pass */
+  KeyedEntry *input = entries;
+  KeyedEntry *output = scratch;
+
+  for (size_t window = 1; window < len; window <<= 1)
+    {
+      for (size_t start = 0; start < len; start += 2 * window)
+        {
+          size_t middle = min (start + window, len);
+          size_t end = min (start + 2 * window, len);
+          size_t j = start;
+          size_t k = middle;
+          size_t p = start;
+
+          /* Take from the left run on ties to keep the sort stable */
+          while (j < middle && k < end)
+            output[p++] = key_cmp (input[k].key, input[j].key) < 0 ? input[k++] : input[j++];
+
+          G_ALGORITHM_STATS_ADD (comparisons, p - start);
+
+          while (j < middle)
+            output[p++] = input[j++];
+
+          while (k < end)
+            output[p++] = input[k++];
+        }
+
+      /* Buffer swap */
+      KeyedEntry *tmp = input;
+      input = output;
+      output = tmp;
+
+      G_ALGORITHM_STATS_ADD (moves, len);
+      G_ALGORITHM_STATS_ADD (passes, 1);
     }
-  }
 
-  /* buf gets released here */
+  /* Undecorate: write the elements back in sorted order and
+   * release the keys */
+  for (size_t i = 0; i < len; ++i)
+    {
+      array->pdata[i] = input[i].element;
+
+      if (key_destroy != NULL)
+        key_destroy (input[i].key);
+    }
+
+  G_ALGORITHM_OPERATION_END (merge_sort_by_key, len);
+
   return array;
 }
@@ -29,7 +29,23 @@ G_BEGIN_DECLS
 
 typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
 
+/**
+ * GAlgorithmKeyFunc:
+ * @element: An element of the array being sorted.
+ *
+ * Compute a sort key for @element, for example a property value or
+ * a collation key.
+ *
+ * Returns: The key for @element.
+ */
+typedef gpointer (*GAlgorithmKeyFunc) (gconstpointer element);
+
 GPtrArray * g_algorithm_merge_sort (GPtrArray             *array,
                                     GAlgorithmCompareFunc  cmp);
 
+GPtrArray * g_algorithm_merge_sort_by_key (GPtrArray             *array,
+                                           GAlgorithmKeyFunc      key_func,
+                                           GAlgorithmCompareFunc  key_cmp,
+                                           GDestroyNotify         key_destroy);
+
 G_END_DECLS
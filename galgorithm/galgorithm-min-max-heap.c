@@ -0,0 +1,365 @@
+/*
+ * /galgorithm/galgorithm-min-max-heap.c
+ *
+ * Implementation for GAlgorithm Min-Max Heap, a double-ended priority
+ * queue in a single dense array. Runs in O(N) time to build and
+ * O(log N) time to insert or pop from either end.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-min-max-heap.h>
+#include <galgorithm/galgorithm-stats-private.h>
+
+/* The heap is stored with the root at index 0 and the children of i
+ * at 2i + 1 and 2i + 2. Even levels of the tree are min levels, where
+ * each element is no greater than any of its descendants, and odd
+ * levels are max levels, where each element is no less than any of its
+ * descendants. So the minimum is the root and the maximum is one of
+ * its children.
+ *
+ * Most of the operations are the same on both kinds of level with the
+ * comparison flipped, so they take a direction which is 1 on min
+ * levels and -1 on max levels. */
+#define MIN_LEVEL 1
+#define MAX_LEVEL -1
+
+static inline int
+level_direction (size_t index)
+{
+  return (g_bit_storage (index + 1) % 2 == 1) ? MIN_LEVEL : MAX_LEVEL;
+}
+
+/* Whether @lhs belongs nearer the root than @rhs on a level
+ * going in @direction */
+static inline gboolean
+heap_before (gconstpointer          lhs,
+             gconstpointer          rhs,
+             int                    direction,
+             GAlgorithmCompareFunc  cmp)
+{
+  return direction * G_ALGORITHM_STATS_COMPARE (cmp, lhs, rhs) < 0;
+}
+
+static inline void
+swap (gpointer *lhs, gpointer *rhs)
+{
+  gpointer tmp = *lhs;
+  *lhs = *rhs;
+  *rhs = tmp;
+
+  G_ALGORITHM_STATS_ADD (swaps, 1);
+}
+
+static void
+trickle_down (GPtrArray             *array,
+              size_t                 index,
+              GAlgorithmCompareFunc  cmp)
+{
+  gpointer *pdata = array->pdata;
+  size_t len = array->len;
+  int direction = level_direction (index);
+
+  while (2 * index + 1 < len)
+    {
+      /* Find whichever of the children and grandchildren belongs
+       * nearest the root */
+      size_t best = 2 * index + 1;
+      size_t first_grandchild = 4 * index + 3;
+
+      if (best + 1 < len && heap_before (pdata[best + 1], pdata[best], direction, cmp))
+        best = best + 1;
+
+      for (size_t g = first_grandchild; g < first_grandchild + 4 && g < len; ++g)
+        if (heap_before (pdata[g], pdata[best], direction, cmp))
+          best = g;
+
+      if (!heap_before (pdata[best], pdata[index], direction, cmp))
+        break;
+
+      swap (&pdata[best], &pdata[index]);
+
+      /* A child is on the opposite kind of level, so it has no
+       * descendants that could be out of order now */
+      if (best < first_grandchild)
+        break;
+
+      /* The element that came down might now be on the wrong side of
+       * the grandchild's parent, which is on the opposite kind of level */
+      size_t parent = (best - 1) / 2;
+
+      if (heap_before (pdata[best], pdata[parent], -direction, cmp))
+        swap (&pdata[parent], &pdata[best]);
+
+      index = best;
+    }
+}
+
+/* Move the element at @index up through the levels going in
+ * @direction, skipping a level each time */
+static void
+bubble_up_grandparents (GPtrArray             *array,
+                        size_t                 index,
+                        int                    direction,
+                        GAlgorithmCompareFunc  cmp)
+{
+  gpointer *pdata = array->pdata;
+
+  while (index > 2)
+    {
+      size_t grandparent = (((index - 1) / 2) - 1) / 2;
+
+      if (!heap_before (pdata[index], pdata[grandparent], direction, cmp))
+        break;
+
+      swap (&pdata[index], &pdata[grandparent]);
+      index = grandparent;
+    }
+}
+
+static void
+bubble_up (GPtrArray             *array,
+           size_t                 index,
+           GAlgorithmCompareFunc  cmp)
+{
+  if (index == 0)
+    return;
+
+  gpointer *pdata = array->pdata;
+  size_t parent = (index - 1) / 2;
+  int direction = level_direction (index);
+
+  /* If the new element belongs on the parent's kind of level, it
+   * moves there and continues up those levels instead */
+  if (heap_before (pdata[parent], pdata[index], direction, cmp))
+    {
+      swap (&pdata[parent], &pdata[index]);
+      bubble_up_grandparents (array, parent, -direction, cmp);
+    }
+  else
+    {
+      bubble_up_grandparents (array, index, direction, cmp);
+    }
+}
+
+static size_t
+max_index (GPtrArray             *array,
+           GAlgorithmCompareFunc  cmp)
+{
+  if (array->len < 3)
+    return array->len - 1;
+
+  return G_ALGORITHM_STATS_COMPARE (cmp, array->pdata[1], array->pdata[2]) >= 0 ? 1 : 2;
+}
+
+/**
+ * g_algorithm_min_max_heapify:
+ * @array: (element-type GObject): A #GPtrArray.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Arrange the elements of @array into a min-max heap in O(N) time,
+ * after which both the smallest and the largest element can be popped
+ * in O(log N) time.
+ *
+ * Return: (transfer none) (element-type GObject): @array, rearranged in-place.
+ */
+GPtrArray * g_algorithm_min_max_heapify (GPtrArray             *array,
+                                         GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  G_ALGORITHM_OPERATION_BEGIN (min_max_heapify, array->len);
+
+  for (size_t i = array->len / 2; i > 0; --i)
+    trickle_down (array, i - 1, cmp);
+
+  G_ALGORITHM_OPERATION_END (min_max_heapify, array->len);
+
+  return array;
+}
+
+/**
+ * g_algorithm_min_max_heap_insert:
+ * @array: (element-type GObject): A #GPtrArray holding a min-max heap.
+ * @element: (transfer full): The element to insert.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Insert @element into the min-max heap in @array.
+ */
+void
+g_algorithm_min_max_heap_insert (GPtrArray             *array,
+                                 gpointer               element,
+                                 GAlgorithmCompareFunc  cmp)
+{
+  g_return_if_fail(array != NULL);
+  g_return_if_fail(cmp != NULL);
+
+  G_ALGORITHM_OPERATION_BEGIN (min_max_heap_insert, array->len);
+
+  g_ptr_array_add (array, element);
+  bubble_up (array, array->len - 1, cmp);
+
+  G_ALGORITHM_OPERATION_END (min_max_heap_insert, array->len);
+}
+
+/**
+ * g_algorithm_min_max_heap_insert_bounded:
+ * @array: (element-type GObject): A #GPtrArray holding a min-max heap.
+ * @element: (transfer full): The element to insert.
+ * @max_length: The most elements @array may hold.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Insert @element into the min-max heap in @array, then if @array holds
+ * more than @max_length elements, evict the largest one. If @element
+ * would be the largest, it is returned straight away without touching
+ * the heap.
+ *
+ * Returns: (transfer full) (nullable): The evicted element, or %NULL
+ *          if nothing was evicted.
+ */
+gpointer
+g_algorithm_min_max_heap_insert_bounded (GPtrArray             *array,
+                                         gpointer               element,
+                                         size_t                 max_length,
+                                         GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  if (array->len < max_length)
+    {
+      g_algorithm_min_max_heap_insert (array, element, cmp);
+      return NULL;
+    }
+
+  if (array->len == 0 ||
+      G_ALGORITHM_STATS_COMPARE (cmp, element, array->pdata[max_index (array, cmp)]) >= 0)
+    return element;
+
+  gpointer evicted = g_algorithm_min_max_heap_pop_max (array, cmp);
+
+  g_algorithm_min_max_heap_insert (array, element, cmp);
+  return evicted;
+}
+
+/**
+ * g_algorithm_min_max_heap_peek_min:
+ * @array: (element-type GObject): A #GPtrArray holding a min-max heap.
+ *
+ * Get the smallest element of the min-max heap in @array.
+ *
+ * Returns: (transfer none) (nullable): The smallest element, or %NULL
+ *          if @array is empty.
+ */
+gpointer
+g_algorithm_min_max_heap_peek_min (GPtrArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+
+  return array->len > 0 ? array->pdata[0] : NULL;
+}
+
+/**
+ * g_algorithm_min_max_heap_peek_max:
+ * @array: (element-type GObject): A #GPtrArray holding a min-max heap.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Get the largest element of the min-max heap in @array.
+ *
+ * Returns: (transfer none) (nullable): The largest element, or %NULL
+ *          if @array is empty.
+ */
+gpointer
+g_algorithm_min_max_heap_peek_max (GPtrArray             *array,
+                                   GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  return array->len > 0 ? array->pdata[max_index (array, cmp)] : NULL;
+}
+
+/**
+ * g_algorithm_min_max_heap_pop_min:
+ * @array: (element-type GObject): A #GPtrArray holding a min-max heap.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Remove the smallest element from the min-max heap in @array. The
+ * element free function of @array is not called on it.
+ *
+ * Returns: (transfer full) (nullable): The smallest element, or %NULL
+ *          if @array is empty.
+ */
+gpointer
+g_algorithm_min_max_heap_pop_min (GPtrArray             *array,
+                                  GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  if (array->len == 0)
+    return NULL;
+
+  G_ALGORITHM_OPERATION_BEGIN (min_max_heap_pop_min, array->len);
+
+  /* The last element takes the place of the root and sinks down */
+  gpointer min = g_ptr_array_steal_index_fast (array, 0);
+
+  if (array->len > 0)
+    trickle_down (array, 0, cmp);
+
+  G_ALGORITHM_OPERATION_END (min_max_heap_pop_min, array->len);
+
+  return min;
+}
+
+/**
+ * g_algorithm_min_max_heap_pop_max:
+ * @array: (element-type GObject): A #GPtrArray holding a min-max heap.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc to compare two elements.
+ *
+ * Remove the largest element from the min-max heap in @array. The
+ * element free function of @array is not called on it.
+ *
+ * Returns: (transfer full) (nullable): The largest element, or %NULL
+ *          if @array is empty.
+ */
+gpointer
+g_algorithm_min_max_heap_pop_max (GPtrArray             *array,
+                                  GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  if (array->len == 0)
+    return NULL;
+
+  G_ALGORITHM_OPERATION_BEGIN (min_max_heap_pop_max, array->len);
+
+  size_t index = max_index (array, cmp);
+  gpointer max = g_ptr_array_steal_index_fast (array, index);
+
+  if (index < array->len)
+    trickle_down (array, index, cmp);
+
+  G_ALGORITHM_OPERATION_END (min_max_heap_pop_max, array->len);
+
+  return max;
+}
@@ -0,0 +1,55 @@
+/*
+ * /galgorithm/galgorithm-min-max-heap.h
+ *
+ * Forward declarations for GAlgorithm Min-Max Heap.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+GPtrArray * g_algorithm_min_max_heapify (GPtrArray             *array,
+                                         GAlgorithmCompareFunc  cmp);
+
+void g_algorithm_min_max_heap_insert (GPtrArray             *array,
+                                      gpointer               element,
+                                      GAlgorithmCompareFunc  cmp);
+
+gpointer g_algorithm_min_max_heap_insert_bounded (GPtrArray             *array,
+                                                  gpointer               element,
+                                                  size_t                 max_length,
+                                                  GAlgorithmCompareFunc  cmp);
+
+gpointer g_algorithm_min_max_heap_peek_min (GPtrArray *array);
+
+gpointer g_algorithm_min_max_heap_peek_max (GPtrArray             *array,
+                                            GAlgorithmCompareFunc  cmp);
+
+gpointer g_algorithm_min_max_heap_pop_min (GPtrArray             *array,
+                                           GAlgorithmCompareFunc  cmp);
+
+gpointer g_algorithm_min_max_heap_pop_max (GPtrArray             *array,
+                                           GAlgorithmCompareFunc  cmp);
+
+G_END_DECLS
@@ -27,6 +27,7 @@
 #include <glib.h>
 
 #include <galgorithm/galgorithm-minheap.h>
+#include <galgorithm/galgorithm-stats-private.h>
 
 /* Grow the minheap so that it can fit an element at
  * position */
@@ -41,12 +42,37 @@ minheap_grow (GPtrArray *array, size_t position)
     g_ptr_array_set_size (array, last_child + 1);
 }
 
+/* The elements of the heap are always packed into the front of
+ * the array from position 1 onwards, with NULL after them, so the
+ * first empty position can be binary searched for. Returns the
+ * length of @array if it is full. */
+static size_t
+minheap_first_empty (GPtrArray *array)
+{
+  size_t floor_index = 1;
+  size_t ceil_index = array->len;
+
+  while (floor_index < ceil_index)
+    {
+      size_t midpoint = floor_index + ((ceil_index - floor_index) / 2);
+
+      if (array->pdata[midpoint] != NULL)
+        floor_index = midpoint + 1;
+      else
+        ceil_index = midpoint;
+    }
+
+  return floor_index;
+}
+
 static inline void
 swap (gpointer *lhs, gpointer *rhs)
 {
   gpointer tmp = *lhs;
   *lhs = *rhs;
   *rhs = tmp;
+
+  G_ALGORITHM_STATS_ADD (swaps, 1);
 }
 
 /**
@@ -65,29 +91,21 @@ g_algorithm_insert_minheap (GPtrArray             *array,
   /* Ensure we have a length of at least one */
   minheap_grow (array, 1);
 
-  size_t insert_position = 0;
+  G_ALGORITHM_OPERATION_BEGIN (minheap_insert, array->len);
 
   /* Start at the first available node */
-  for (int i = 1; i < array->len; ++i)
-    {
-      /* Insert the child at that position */
-      if (array->pdata[i] == NULL) {
-        array->pdata[i] = candidate;
-        insert_position = i;
-        break;
-      }
-    }
+  size_t insert_position = minheap_first_empty (array);
 
   /* We didn't find a node to insert into! */
-  if (insert_position == 0)
+  if (insert_position == array->len)
     {
       /* Grow big enough that we can fit the children
        * of the last child. */
-      insert_position = array->len;
       minheap_grow (array, array->len);
-      array->pdata[insert_position] = candidate;
     }
 
+  array->pdata[insert_position] = candidate;
+
   /* Now, we need to reheapify from that position */
   size_t i = insert_position;
 
@@ -96,13 +114,15 @@ g_algorithm_insert_minheap (GPtrArray             *array,
       size_t parent = i / 2;
 
       /* Parent is greater than us, we need to swap */
-      if (cmp (array->pdata[parent], array->pdata[i]) > 0)
+      if (G_ALGORITHM_STATS_COMPARE (cmp, array->pdata[parent], array->pdata[i]) > 0)
         swap (&array->pdata[parent], &array->pdata[i]);
       else
         break;
 
       i = parent;
     }
+
+  G_ALGORITHM_OPERATION_END (minheap_insert, array->len);
 }
 
 /**
@@ -127,37 +147,39 @@ g_algorithm_minheap_pop (GPtrArray             *array,
       return NULL;
     }
 
+  G_ALGORITHM_OPERATION_BEGIN (minheap_pop, array->len);
+
   gpointer root = array->pdata[1];
-  array->pdata[1] = NULL;
 
-  /* Find the first non-null leaf node starting from the end
-   * of the tree */
-  for (int i = array->len - 1; i >= 1; --i)
-    {
-      if (array->pdata[i] != NULL)
-        {
-          swap (&array->pdata[i], &array->pdata[1]);
-          break;
-        }
-    }
+  /* Move the last leaf node into the root */
+  size_t last = minheap_first_empty (array) - 1;
+
+  array->pdata[1] = array->pdata[last];
+  array->pdata[last] = NULL;
 
   /* OK, now that we've done that, we need to percolate the
-   * root node down the tree */
+   * root node down the tree, always towards the smaller child */
   size_t i = 1;
 
-  while (i < array->len && array->pdata[i] != NULL)
+  while (array->pdata[i] != NULL)
     {
-      size_t child = i * 2;
+      size_t smallest = i;
 
-      if (array->pdata[child] != NULL &&
-          cmp (array->pdata[child], array->pdata[i]) < 0)
+      for (size_t child = 2 * i; child <= 2 * i + 1 && child < array->len; ++child)
         {
-          swap (&array->pdata[child], &array->pdata[i]);
-          break;
+          if (array->pdata[child] != NULL &&
+              G_ALGORITHM_STATS_COMPARE (cmp, array->pdata[child], array->pdata[smallest]) < 0)
+            smallest = child;
         }
-      
-      i = child;
+
+      if (smallest == i)
+        break;
+
+      swap (&array->pdata[smallest], &array->pdata[i]);
+      i = smallest;
     }
 
+  G_ALGORITHM_OPERATION_END (minheap_pop, array->len);
+
   return root;
 }
\ No newline at end of file
@@ -0,0 +1,482 @@
+/*
+ * /galgorithm/galgorithm-pairing-heap.c
+ *
+ * Implementation for GAlgorithm Pairing Heap. Insert and meld run in
+ * O(1) time and pop_min in amortized O(log N) time.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <glib-object.h>
+#include <glib.h>
+
+#include <galgorithm/galgorithm-pairing-heap.h>
+#include <galgorithm/galgorithm-stats-private.h>
+
+/* Nodes are carved out of slabs which double in size up to a limit,
+ * so that a heap which churns through nodes never calls malloc once
+ * it has reached its largest size */
+#define SLAB_MIN_NODES 64
+#define SLAB_MAX_NODES 4096
+
+/* The children of a node form a doubly linked list. prev points at the
+ * parent for the first child, and at the previous sibling otherwise.
+ * Free nodes are chained through next. */
+struct _GAlgorithmPairingHeapNode {
+  gpointer                   element;
+  GAlgorithmPairingHeapNode *child;
+  GAlgorithmPairingHeapNode *next;
+  GAlgorithmPairingHeapNode *prev;
+};
+
+typedef struct _PairingSlab PairingSlab;
+
+struct _PairingSlab {
+  PairingSlab               *next;
+  GAlgorithmPairingHeapNode  nodes[];
+};
+
+struct _GAlgorithmPairingHeap {
+  volatile gint              ref_count;
+  GAlgorithmCompareFunc      cmp;
+  GAlgorithmPairingHeapNode *root;
+  size_t                     length;
+
+  /* Slabs and free nodes are kept as lists with tails, so that melding
+   * can take over another heap's nodes in O(1) time */
+  PairingSlab               *slabs_head;
+  PairingSlab               *slabs_tail;
+  size_t                     next_slab_nodes;
+  GAlgorithmPairingHeapNode *free_head;
+  GAlgorithmPairingHeapNode *free_tail;
+};
+
+G_DEFINE_BOXED_TYPE (GAlgorithmPairingHeap,
+                     g_algorithm_pairing_heap,
+                     g_algorithm_pairing_heap_ref,
+                     g_algorithm_pairing_heap_unref)
+
+static void
+pairing_heap_grow (GAlgorithmPairingHeap *heap)
+{
+  size_t n_nodes = heap->next_slab_nodes;
+  PairingSlab *slab = g_malloc (sizeof (PairingSlab) +
+                                n_nodes * sizeof (GAlgorithmPairingHeapNode));
+
+  slab->next = NULL;
+
+  if (heap->slabs_tail != NULL)
+    heap->slabs_tail->next = slab;
+  else
+    heap->slabs_head = slab;
+
+  heap->slabs_tail = slab;
+  heap->next_slab_nodes = MIN (n_nodes * 2, SLAB_MAX_NODES);
+
+  /* Only called with an empty free list */
+  for (size_t i = 0; i + 1 < n_nodes; ++i)
+    slab->nodes[i].next = &slab->nodes[i + 1];
+
+  slab->nodes[n_nodes - 1].next = NULL;
+  heap->free_head = &slab->nodes[0];
+  heap->free_tail = &slab->nodes[n_nodes - 1];
+}
+
+static GAlgorithmPairingHeapNode *
+pairing_heap_node_alloc (GAlgorithmPairingHeap *heap)
+{
+  if (heap->free_head == NULL)
+    pairing_heap_grow (heap);
+
+  GAlgorithmPairingHeapNode *node = heap->free_head;
+
+  heap->free_head = node->next;
+
+  if (heap->free_head == NULL)
+    heap->free_tail = NULL;
+
+  return node;
+}
+
+static void
+pairing_heap_node_release (GAlgorithmPairingHeap     *heap,
+                           GAlgorithmPairingHeapNode *node)
+{
+  node->element = NULL;
+  node->child = NULL;
+  node->prev = NULL;
+  node->next = heap->free_head;
+
+  if (heap->free_head == NULL)
+    heap->free_tail = node;
+
+  heap->free_head = node;
+}
+
+/* Link two roots, making the greater one the first child of the
+ * lesser one, which is returned. Ties go to @a. The sibling links of
+ * the returned root are left for the caller to set. */
+static GAlgorithmPairingHeapNode *
+pairing_heap_link (GAlgorithmPairingHeap     *heap,
+                   GAlgorithmPairingHeapNode *a,
+                   GAlgorithmPairingHeapNode *b)
+{
+  if (G_ALGORITHM_STATS_COMPARE (heap->cmp, b->element, a->element) < 0)
+    {
+      GAlgorithmPairingHeapNode *tmp = a;
+      a = b;
+      b = tmp;
+    }
+
+  b->prev = a;
+  b->next = a->child;
+
+  if (a->child != NULL)
+    a->child->prev = b;
+
+  a->child = b;
+
+  return a;
+}
+
+/* Combine the list of siblings starting at @first into one tree with
+ * the standard two pass method. The first pass links pairs from left
+ * to right, chaining the results backwards through prev. The second
+ * links them from right to left into the last one. */
+static GAlgorithmPairingHeapNode *
+pairing_heap_merge_pairs (GAlgorithmPairingHeap     *heap,
+                          GAlgorithmPairingHeapNode *first)
+{
+  if (first == NULL)
+    return NULL;
+
+  GAlgorithmPairingHeapNode *last = NULL;
+
+  while (first != NULL)
+    {
+      GAlgorithmPairingHeapNode *a = first;
+      GAlgorithmPairingHeapNode *b = a->next;
+
+      if (b == NULL)
+        {
+          a->prev = last;
+          last = a;
+          break;
+        }
+
+      first = b->next;
+
+      GAlgorithmPairingHeapNode *linked = pairing_heap_link (heap, a, b);
+
+      linked->prev = last;
+      last = linked;
+    }
+
+  GAlgorithmPairingHeapNode *root = last;
+
+  last = last->prev;
+
+  while (last != NULL)
+    {
+      GAlgorithmPairingHeapNode *prev = last->prev;
+
+      root = pairing_heap_link (heap, last, root);
+      last = prev;
+    }
+
+  root->prev = NULL;
+  root->next = NULL;
+
+  return root;
+}
+
+/**
+ * g_algorithm_pairing_heap_new:
+ * @cmp: (scope forever): A #GAlgorithmCompareFunc to order elements by.
+ *
+ * Create a new, empty pairing heap ordered by @cmp, with the least
+ * element at the top.
+ *
+ * Unlike the array backed minheap, two pairing heaps can be melded in
+ * O(1) time, and the key of an element can be decreased through the
+ * #GAlgorithmPairingHeapNode returned when it was inserted. Nodes come
+ * from slabs owned by the heap and are reused once their element is
+ * popped.
+ *
+ * Returns: (transfer full): A new #GAlgorithmPairingHeap.
+ */
+GAlgorithmPairingHeap *
+g_algorithm_pairing_heap_new (GAlgorithmCompareFunc cmp)
+{
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  GAlgorithmPairingHeap *heap = g_new0 (GAlgorithmPairingHeap, 1);
+
+  heap->ref_count = 1;
+  heap->cmp = cmp;
+  heap->next_slab_nodes = SLAB_MIN_NODES;
+
+  return heap;
+}
+
+/**
+ * g_algorithm_pairing_heap_ref:
+ * @heap: A #GAlgorithmPairingHeap.
+ *
+ * Take a reference on @heap.
+ *
+ * Returns: (transfer full): @heap.
+ */
+GAlgorithmPairingHeap *
+g_algorithm_pairing_heap_ref (GAlgorithmPairingHeap *heap)
+{
+  g_return_val_if_fail(heap != NULL, NULL);
+
+  g_atomic_int_inc (&heap->ref_count);
+  return heap;
+}
+
+/**
+ * g_algorithm_pairing_heap_unref:
+ * @heap: (transfer full): A #GAlgorithmPairingHeap.
+ *
+ * Release a reference on @heap. Elements still in the heap are not
+ * freed, and any nodes for them become invalid.
+ */
+void
+g_algorithm_pairing_heap_unref (GAlgorithmPairingHeap *heap)
+{
+  g_return_if_fail(heap != NULL);
+
+  if (!g_atomic_int_dec_and_test (&heap->ref_count))
+    return;
+
+  PairingSlab *slab = heap->slabs_head;
+
+  while (slab != NULL)
+    {
+      PairingSlab *next = slab->next;
+
+      g_free (slab);
+      slab = next;
+    }
+
+  g_free (heap);
+}
+
+/**
+ * g_algorithm_pairing_heap_insert:
+ * @heap: A #GAlgorithmPairingHeap.
+ * @element: The element to insert.
+ *
+ * Insert @element into @heap in O(1) time.
+ *
+ * Returns: (transfer none): A #GAlgorithmPairingHeapNode for @element,
+ *          which can be passed to g_algorithm_pairing_heap_decrease_key().
+ */
+GAlgorithmPairingHeapNode *
+g_algorithm_pairing_heap_insert (GAlgorithmPairingHeap *heap,
+                                 gpointer               element)
+{
+  g_return_val_if_fail(heap != NULL, NULL);
+
+  GAlgorithmPairingHeapNode *node = pairing_heap_node_alloc (heap);
+
+  node->element = element;
+  node->child = NULL;
+  node->next = NULL;
+  node->prev = NULL;
+
+  heap->root = heap->root != NULL ? pairing_heap_link (heap, heap->root, node) : node;
+  heap->length++;
+
+  return node;
+}
+
+/**
+ * g_algorithm_pairing_heap_peek_min:
+ * @heap: A #GAlgorithmPairingHeap.
+ *
+ * Get the least element of @heap without removing it.
+ *
+ * Returns: (transfer none) (nullable): The least element, or %NULL if
+ *          @heap is empty.
+ */
+gpointer
+g_algorithm_pairing_heap_peek_min (GAlgorithmPairingHeap *heap)
+{
+  g_return_val_if_fail(heap != NULL, NULL);
+
+  return heap->root != NULL ? heap->root->element : NULL;
+}
+
+/**
+ * g_algorithm_pairing_heap_pop_min:
+ * @heap: A #GAlgorithmPairingHeap.
+ *
+ * Remove the least element of @heap in amortized O(log N) time. The
+ * node for it becomes invalid.
+ *
+ * Returns: (transfer none) (nullable): The least element, or %NULL if
+ *          @heap is empty.
+ */
+gpointer
+g_algorithm_pairing_heap_pop_min (GAlgorithmPairingHeap *heap)
+{
+  g_return_val_if_fail(heap != NULL, NULL);
+
+  if (heap->root == NULL)
+    return NULL;
+
+  G_ALGORITHM_OPERATION_BEGIN (pairing_heap_pop_min, heap->length);
+
+  GAlgorithmPairingHeapNode *root = heap->root;
+  gpointer element = root->element;
+
+  heap->root = pairing_heap_merge_pairs (heap, root->child);
+  heap->length--;
+  pairing_heap_node_release (heap, root);
+
+  G_ALGORITHM_OPERATION_END (pairing_heap_pop_min, heap->length);
+
+  return element;
+}
+
+/**
+ * g_algorithm_pairing_heap_decrease_key:
+ * @heap: A #GAlgorithmPairingHeap.
+ * @node: A #GAlgorithmPairingHeapNode in @heap.
+ * @element: The element to replace the one at @node with, which must
+ *           not compare greater than it.
+ *
+ * Replace the element at @node with one that is no greater, moving it
+ * up @heap in O(1) time. To make an element greater, pop it and insert
+ * it again.
+ */
+void
+g_algorithm_pairing_heap_decrease_key (GAlgorithmPairingHeap     *heap,
+                                       GAlgorithmPairingHeapNode *node,
+                                       gpointer                   element)
+{
+  g_return_if_fail(heap != NULL);
+  g_return_if_fail(node != NULL);
+
+  node->element = element;
+
+  if (node == heap->root)
+    return;
+
+  /* Cut the subtree at @node away from its parent and link it back in
+   * at the root. Its children stay in order beneath it. */
+  if (node->prev->child == node)
+    node->prev->child = node->next;
+  else
+    node->prev->next = node->next;
+
+  if (node->next != NULL)
+    node->next->prev = node->prev;
+
+  node->next = NULL;
+  node->prev = NULL;
+
+  heap->root = pairing_heap_link (heap, heap->root, node);
+}
+
+/**
+ * g_algorithm_pairing_heap_meld:
+ * @heap: A #GAlgorithmPairingHeap.
+ * @other: Another #GAlgorithmPairingHeap with the same #GAlgorithmCompareFunc.
+ *
+ * Move all of the elements of @other into @heap in O(1) time, leaving
+ * @other empty. @heap takes over the slabs of @other, so the nodes for
+ * the elements stay valid and now belong to @heap.
+ */
+void
+g_algorithm_pairing_heap_meld (GAlgorithmPairingHeap *heap,
+                               GAlgorithmPairingHeap *other)
+{
+  g_return_if_fail(heap != NULL);
+  g_return_if_fail(other != NULL);
+  g_return_if_fail(heap != other);
+  g_return_if_fail(heap->cmp == other->cmp);
+
+  if (other->root != NULL)
+    {
+      heap->root = heap->root != NULL ? pairing_heap_link (heap, heap->root, other->root) : other->root;
+      heap->length += other->length;
+    }
+
+  if (other->slabs_head != NULL)
+    {
+      if (heap->slabs_tail != NULL)
+        heap->slabs_tail->next = other->slabs_head;
+      else
+        heap->slabs_head = other->slabs_head;
+
+      heap->slabs_tail = other->slabs_tail;
+      heap->next_slab_nodes = MAX (heap->next_slab_nodes, other->next_slab_nodes);
+    }
+
+  if (other->free_head != NULL)
+    {
+      if (heap->free_tail != NULL)
+        heap->free_tail->next = other->free_head;
+      else
+        heap->free_head = other->free_head;
+
+      heap->free_tail = other->free_tail;
+    }
+
+  other->root = NULL;
+  other->length = 0;
+  other->slabs_head = NULL;
+  other->slabs_tail = NULL;
+  other->free_head = NULL;
+  other->free_tail = NULL;
+}
+
+/**
+ * g_algorithm_pairing_heap_get_length:
+ * @heap: A #GAlgorithmPairingHeap.
+ *
+ * Get the number of elements in @heap.
+ *
+ * Returns: The number of elements in @heap.
+ */
+size_t
+g_algorithm_pairing_heap_get_length (GAlgorithmPairingHeap *heap)
+{
+  g_return_val_if_fail(heap != NULL, 0);
+
+  return heap->length;
+}
+
+/**
+ * g_algorithm_pairing_heap_node_get_element:
+ * @node: A #GAlgorithmPairingHeapNode.
+ *
+ * Get the element currently at @node.
+ *
+ * Returns: (transfer none): The element at @node.
+ */
+gpointer
+g_algorithm_pairing_heap_node_get_element (GAlgorithmPairingHeapNode *node)
+{
+  g_return_val_if_fail(node != NULL, NULL);
+
+  return node->element;
+}
@@ -0,0 +1,76 @@
+/*
+ * /galgorithm/galgorithm-pairing-heap.h
+ *
+ * Forward declarations for GAlgorithm Pairing Heap.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#pragma once
+
+#include <glib-object.h>
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+#define G_ALGORITHM_TYPE_PAIRING_HEAP (g_algorithm_pairing_heap_get_type ())
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+typedef struct _GAlgorithmPairingHeap GAlgorithmPairingHeap;
+
+/**
+ * GAlgorithmPairingHeapNode:
+ *
+ * Identifies an element inserted into a #GAlgorithmPairingHeap, so that
+ * its key can be decreased. A node stays valid until its element is
+ * popped or the heap holding it is freed, including after the heap it
+ * was inserted into is melded into another one.
+ */
+typedef struct _GAlgorithmPairingHeapNode GAlgorithmPairingHeapNode;
+
+GType g_algorithm_pairing_heap_get_type (void);
+
+GAlgorithmPairingHeap * g_algorithm_pairing_heap_new (GAlgorithmCompareFunc cmp);
+
+GAlgorithmPairingHeap * g_algorithm_pairing_heap_ref (GAlgorithmPairingHeap *heap);
+
+void g_algorithm_pairing_heap_unref (GAlgorithmPairingHeap *heap);
+
+GAlgorithmPairingHeapNode * g_algorithm_pairing_heap_insert (GAlgorithmPairingHeap *heap,
+                                                             gpointer               element);
+
+gpointer g_algorithm_pairing_heap_peek_min (GAlgorithmPairingHeap *heap);
+
+gpointer g_algorithm_pairing_heap_pop_min (GAlgorithmPairingHeap *heap);
+
+void g_algorithm_pairing_heap_decrease_key (GAlgorithmPairingHeap     *heap,
+                                            GAlgorithmPairingHeapNode *node,
+                                            gpointer                   element);
+
+void g_algorithm_pairing_heap_meld (GAlgorithmPairingHeap *heap,
+                                    GAlgorithmPairingHeap *other);
+
+size_t g_algorithm_pairing_heap_get_length (GAlgorithmPairingHeap *heap);
+
+gpointer g_algorithm_pairing_heap_node_get_element (GAlgorithmPairingHeapNode *node);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GAlgorithmPairingHeap, g_algorithm_pairing_heap_unref)
+
+G_END_DECLS
@@ -0,0 +1,384 @@
+/*
+ * /galgorithm/galgorithm-primitive-sort-avx2.c
+ *
+ * AVX2 kernels for GAlgorithm Primitive Sort. Blocks of 64 (for 32 bit
+ * keys) or 16 (for 64 bit keys) elements are sorted with a column-wise
+ * sorting network followed by a register transpose, then the sorted runs
+ * are combined with vectorized bitonic merges. Runs in O(4N) space and
+ * O(N log N) time.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-primitive-sort-private.h>
+
+#ifdef G_ALGORITHM_HAVE_AVX2_KERNELS
+
+#include <immintrin.h>
+
+#define AVX2_FUNC __attribute__ ((target ("avx2")))
+
+/* Compare-exchange two registers lane by lane, so that
+ * lo ends up with the minimums and hi with the maximums */
+#define COMPARE_EXCHANGE_EPI32(lo, hi)                  \
+  do {                                                  \
+    __m256i _min = _mm256_min_epi32 ((lo), (hi));       \
+    (hi) = _mm256_max_epi32 ((lo), (hi));               \
+    (lo) = _min;                                        \
+  } while (0)
+
+#define COMPARE_EXCHANGE_EPI64(lo, hi)                  \
+  do {                                                  \
+    __m256i _min = min_epi64 ((lo), (hi));              \
+    (hi) = max_epi64 ((lo), (hi));                      \
+    (lo) = _min;                                        \
+  } while (0)
+
+gboolean
+g_algorithm_avx2_supported (void)
+{
+  return __builtin_cpu_supports ("avx2");
+}
+
+/* AVX2 has no 64 bit min and max, so build them from a compare */
+static inline AVX2_FUNC __m256i
+min_epi64 (__m256i a, __m256i b)
+{
+  return _mm256_blendv_epi8 (a, b, _mm256_cmpgt_epi64 (a, b));
+}
+
+static inline AVX2_FUNC __m256i
+max_epi64 (__m256i a, __m256i b)
+{
+  return _mm256_blendv_epi8 (b, a, _mm256_cmpgt_epi64 (a, b));
+}
+
+/* Sort a bitonic register of eight 32 bit keys with three
+ * half-cleaner stages of distance 4, 2 and 1 */
+static inline AVX2_FUNC __m256i
+bitonic_clean_epi32 (__m256i v)
+{
+  __m256i p;
+
+  p = _mm256_permute2x128_si256 (v, v, 0x01);
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, p), _mm256_max_epi32 (v, p), 0xf0);
+
+  p = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (1, 0, 3, 2));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, p), _mm256_max_epi32 (v, p), 0xcc);
+
+  p = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (2, 3, 0, 1));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, p), _mm256_max_epi32 (v, p), 0xaa);
+
+  return v;
+}
+
+/* Same as above, for a register of four 64 bit keys */
+static inline AVX2_FUNC __m256i
+bitonic_clean_epi64 (__m256i v)
+{
+  __m256i p;
+
+  p = _mm256_permute4x64_epi64 (v, _MM_SHUFFLE (1, 0, 3, 2));
+  v = _mm256_blend_epi32 (min_epi64 (v, p), max_epi64 (v, p), 0xf0);
+
+  p = _mm256_permute4x64_epi64 (v, _MM_SHUFFLE (2, 3, 0, 1));
+  v = _mm256_blend_epi32 (min_epi64 (v, p), max_epi64 (v, p), 0xcc);
+
+  return v;
+}
+
+/* Merge two sorted registers, leaving the smallest keys in
+ * sorted order in *a and the largest in sorted order in *b.
+ * Reversing *b makes the concatenation bitonic. */
+static inline AVX2_FUNC void
+bitonic_merge_epi32 (__m256i *a, __m256i *b)
+{
+  __m256i reversed = _mm256_permutevar8x32_epi32 (*b, _mm256_setr_epi32 (7, 6, 5, 4, 3, 2, 1, 0));
+
+  *b = bitonic_clean_epi32 (_mm256_max_epi32 (*a, reversed));
+  *a = bitonic_clean_epi32 (_mm256_min_epi32 (*a, reversed));
+}
+
+static inline AVX2_FUNC void
+bitonic_merge_epi64 (__m256i *a, __m256i *b)
+{
+  __m256i reversed = _mm256_permute4x64_epi64 (*b, _MM_SHUFFLE (0, 1, 2, 3));
+
+  *b = bitonic_clean_epi64 (max_epi64 (*a, reversed));
+  *a = bitonic_clean_epi64 (min_epi64 (*a, reversed));
+}
+
+/* Sort 64 keys into eight sorted runs of eight. The 19 comparator
+ * sorting network sorts each column across the eight registers, then
+ * transposing turns each column into a register. */
+static AVX2_FUNC void
+sort_block_epi32 (gint32 *data)
+{
+  __m256i r0 = _mm256_loadu_si256 ((const __m256i *) (data + 0));
+  __m256i r1 = _mm256_loadu_si256 ((const __m256i *) (data + 8));
+  __m256i r2 = _mm256_loadu_si256 ((const __m256i *) (data + 16));
+  __m256i r3 = _mm256_loadu_si256 ((const __m256i *) (data + 24));
+  __m256i r4 = _mm256_loadu_si256 ((const __m256i *) (data + 32));
+  __m256i r5 = _mm256_loadu_si256 ((const __m256i *) (data + 40));
+  __m256i r6 = _mm256_loadu_si256 ((const __m256i *) (data + 48));
+  __m256i r7 = _mm256_loadu_si256 ((const __m256i *) (data + 56));
+
+  COMPARE_EXCHANGE_EPI32 (r0, r2);
+  COMPARE_EXCHANGE_EPI32 (r1, r3);
+  COMPARE_EXCHANGE_EPI32 (r4, r6);
+  COMPARE_EXCHANGE_EPI32 (r5, r7);
+  COMPARE_EXCHANGE_EPI32 (r0, r4);
+  COMPARE_EXCHANGE_EPI32 (r1, r5);
+  COMPARE_EXCHANGE_EPI32 (r2, r6);
+  COMPARE_EXCHANGE_EPI32 (r3, r7);
+  COMPARE_EXCHANGE_EPI32 (r0, r1);
+  COMPARE_EXCHANGE_EPI32 (r2, r3);
+  COMPARE_EXCHANGE_EPI32 (r4, r5);
+  COMPARE_EXCHANGE_EPI32 (r6, r7);
+  COMPARE_EXCHANGE_EPI32 (r2, r4);
+  COMPARE_EXCHANGE_EPI32 (r3, r5);
+  COMPARE_EXCHANGE_EPI32 (r1, r4);
+  COMPARE_EXCHANGE_EPI32 (r3, r6);
+  COMPARE_EXCHANGE_EPI32 (r1, r2);
+  COMPARE_EXCHANGE_EPI32 (r3, r4);
+  COMPARE_EXCHANGE_EPI32 (r5, r6);
+
+  /* 8x8 transpose */
+  __m256i t0 = _mm256_unpacklo_epi32 (r0, r1);
+  __m256i t1 = _mm256_unpackhi_epi32 (r0, r1);
+  __m256i t2 = _mm256_unpacklo_epi32 (r2, r3);
+  __m256i t3 = _mm256_unpackhi_epi32 (r2, r3);
+  __m256i t4 = _mm256_unpacklo_epi32 (r4, r5);
+  __m256i t5 = _mm256_unpackhi_epi32 (r4, r5);
+  __m256i t6 = _mm256_unpacklo_epi32 (r6, r7);
+  __m256i t7 = _mm256_unpackhi_epi32 (r6, r7);
+
+  __m256i u0 = _mm256_unpacklo_epi64 (t0, t2);
+  __m256i u1 = _mm256_unpackhi_epi64 (t0, t2);
+  __m256i u2 = _mm256_unpacklo_epi64 (t1, t3);
+  __m256i u3 = _mm256_unpackhi_epi64 (t1, t3);
+  __m256i u4 = _mm256_unpacklo_epi64 (t4, t6);
+  __m256i u5 = _mm256_unpackhi_epi64 (t4, t6);
+  __m256i u6 = _mm256_unpacklo_epi64 (t5, t7);
+  __m256i u7 = _mm256_unpackhi_epi64 (t5, t7);
+
+  _mm256_storeu_si256 ((__m256i *) (data + 0), _mm256_permute2x128_si256 (u0, u4, 0x20));
+  _mm256_storeu_si256 ((__m256i *) (data + 8), _mm256_permute2x128_si256 (u1, u5, 0x20));
+  _mm256_storeu_si256 ((__m256i *) (data + 16), _mm256_permute2x128_si256 (u2, u6, 0x20));
+  _mm256_storeu_si256 ((__m256i *) (data + 24), _mm256_permute2x128_si256 (u3, u7, 0x20));
+  _mm256_storeu_si256 ((__m256i *) (data + 32), _mm256_permute2x128_si256 (u0, u4, 0x31));
+  _mm256_storeu_si256 ((__m256i *) (data + 40), _mm256_permute2x128_si256 (u1, u5, 0x31));
+  _mm256_storeu_si256 ((__m256i *) (data + 48), _mm256_permute2x128_si256 (u2, u6, 0x31));
+  _mm256_storeu_si256 ((__m256i *) (data + 56), _mm256_permute2x128_si256 (u3, u7, 0x31));
+}
+
+/* Sort 16 keys into four sorted runs of four, using the five
+ * comparator network and a 4x4 transpose */
+static AVX2_FUNC void
+sort_block_epi64 (gint64 *data)
+{
+  __m256i r0 = _mm256_loadu_si256 ((const __m256i *) (data + 0));
+  __m256i r1 = _mm256_loadu_si256 ((const __m256i *) (data + 4));
+  __m256i r2 = _mm256_loadu_si256 ((const __m256i *) (data + 8));
+  __m256i r3 = _mm256_loadu_si256 ((const __m256i *) (data + 12));
+
+  COMPARE_EXCHANGE_EPI64 (r0, r1);
+  COMPARE_EXCHANGE_EPI64 (r2, r3);
+  COMPARE_EXCHANGE_EPI64 (r0, r2);
+  COMPARE_EXCHANGE_EPI64 (r1, r3);
+  COMPARE_EXCHANGE_EPI64 (r1, r2);
+
+  /* 4x4 transpose */
+  __m256i t0 = _mm256_unpacklo_epi64 (r0, r1);
+  __m256i t1 = _mm256_unpackhi_epi64 (r0, r1);
+  __m256i t2 = _mm256_unpacklo_epi64 (r2, r3);
+  __m256i t3 = _mm256_unpackhi_epi64 (r2, r3);
+
+  _mm256_storeu_si256 ((__m256i *) (data + 0), _mm256_permute2x128_si256 (t0, t2, 0x20));
+  _mm256_storeu_si256 ((__m256i *) (data + 4), _mm256_permute2x128_si256 (t1, t3, 0x20));
+  _mm256_storeu_si256 ((__m256i *) (data + 8), _mm256_permute2x128_si256 (t0, t2, 0x31));
+  _mm256_storeu_si256 ((__m256i *) (data + 12), _mm256_permute2x128_si256 (t1, t3, 0x31));
+}
+
+/* Merge the sorted runs [a, a + a_len) and [b, b + b_len) into out.
+ * Both lengths must be non-zero multiples of the register width.
+ *
+ * We keep the largest keys seen so far in a register and repeatedly
+ * merge it with the next register from whichever run has the smaller
+ * next key. The smaller half of each merge can never be beaten by a
+ * key that is still to come, so it is written straight out. */
+static AVX2_FUNC void
+merge_runs_epi32 (const gint32 *a,
+                  size_t        a_len,
+                  const gint32 *b,
+                  size_t        b_len,
+                  gint32       *out)
+{
+  __m256i lo = _mm256_loadu_si256 ((const __m256i *) a);
+  __m256i hi = _mm256_loadu_si256 ((const __m256i *) b);
+  size_t i = 8, j = 8;
+
+  bitonic_merge_epi32 (&lo, &hi);
+  _mm256_storeu_si256 ((__m256i *) out, lo);
+  out += 8;
+
+  while (i < a_len || j < b_len)
+    {
+      if (j >= b_len || (i < a_len && a[i] <= b[j]))
+        {
+          lo = _mm256_loadu_si256 ((const __m256i *) (a + i));
+          i += 8;
+        }
+      else
+        {
+          lo = _mm256_loadu_si256 ((const __m256i *) (b + j));
+          j += 8;
+        }
+
+      bitonic_merge_epi32 (&lo, &hi);
+      _mm256_storeu_si256 ((__m256i *) out, lo);
+      out += 8;
+    }
+
+  _mm256_storeu_si256 ((__m256i *) out, hi);
+}
+
+static AVX2_FUNC void
+merge_runs_epi64 (const gint64 *a,
+                  size_t        a_len,
+                  const gint64 *b,
+                  size_t        b_len,
+                  gint64       *out)
+{
+  __m256i lo = _mm256_loadu_si256 ((const __m256i *) a);
+  __m256i hi = _mm256_loadu_si256 ((const __m256i *) b);
+  size_t i = 4, j = 4;
+
+  bitonic_merge_epi64 (&lo, &hi);
+  _mm256_storeu_si256 ((__m256i *) out, lo);
+  out += 4;
+
+  while (i < a_len || j < b_len)
+    {
+      if (j >= b_len || (i < a_len && a[i] <= b[j]))
+        {
+          lo = _mm256_loadu_si256 ((const __m256i *) (a + i));
+          i += 4;
+        }
+      else
+        {
+          lo = _mm256_loadu_si256 ((const __m256i *) (b + j));
+          j += 4;
+        }
+
+      bitonic_merge_epi64 (&lo, &hi);
+      _mm256_storeu_si256 ((__m256i *) out, lo);
+      out += 4;
+    }
+
+  _mm256_storeu_si256 ((__m256i *) out, hi);
+}
+
+/* Sort @data in place. Only call this if
+ * g_algorithm_avx2_supported() returns TRUE. */
+AVX2_FUNC void
+g_algorithm_avx2_sort_int32 (gint32 *data,
+                             size_t  len)
+{
+  /* Pad up to a whole number of blocks with the largest possible
+   * key. The padding sorts to the end and is never copied back. */
+  size_t padded_len = (len + 63) & ~((size_t) 63);
+  g_autofree gint32 *input = g_new (gint32, padded_len);
+  g_autofree gint32 *output = g_new (gint32, padded_len);
+
+  memcpy (input, data, len * sizeof (gint32));
+  for (size_t i = len; i < padded_len; ++i)
+    input[i] = G_MAXINT32;
+
+  for (size_t i = 0; i < padded_len; i += 64)
+    sort_block_epi32 (&input[i]);
+
+  for (size_t run = 8; run < padded_len; run <<= 1)
+    {
+      for (size_t start = 0; start < padded_len; start += 2 * run)
+        {
+          size_t middle = MIN (start + run, padded_len);
+          size_t end = MIN (start + 2 * run, padded_len);
+
+          if (middle == end)
+            memcpy (&output[start], &input[start], (end - start) * sizeof (gint32));
+          else
+            merge_runs_epi32 (&input[start], middle - start,
+                              &input[middle], end - middle,
+                              &output[start]);
+        }
+
+      /* Buffer swap */
+      gint32 *tmp = input;
+      input = output;
+      output = tmp;
+    }
+
+  memcpy (data, input, len * sizeof (gint32));
+}
+
+/* Sort @data in place. Only call this if
+ * g_algorithm_avx2_supported() returns TRUE. */
+AVX2_FUNC void
+g_algorithm_avx2_sort_int64 (gint64 *data,
+                             size_t  len)
+{
+  size_t padded_len = (len + 15) & ~((size_t) 15);
+  g_autofree gint64 *input = g_new (gint64, padded_len);
+  g_autofree gint64 *output = g_new (gint64, padded_len);
+
+  memcpy (input, data, len * sizeof (gint64));
+  for (size_t i = len; i < padded_len; ++i)
+    input[i] = G_MAXINT64;
+
+  for (size_t i = 0; i < padded_len; i += 16)
+    sort_block_epi64 (&input[i]);
+
+  for (size_t run = 4; run < padded_len; run <<= 1)
+    {
+      for (size_t start = 0; start < padded_len; start += 2 * run)
+        {
+          size_t middle = MIN (start + run, padded_len);
+          size_t end = MIN (start + 2 * run, padded_len);
+
+          if (middle == end)
+            memcpy (&output[start], &input[start], (end - start) * sizeof (gint64));
+          else
+            merge_runs_epi64 (&input[start], middle - start,
+                              &input[middle], end - middle,
+                              &output[start]);
+        }
+
+      /* Buffer swap */
+      gint64 *tmp = input;
+      input = output;
+      output = tmp;
+    }
+
+  memcpy (data, input, len * sizeof (gint64));
+}
+
+#endif
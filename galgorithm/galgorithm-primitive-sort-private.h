@@ -0,0 +1,45 @@
+/*
+ * /galgorithm/galgorithm-primitive-sort-private.h
+ *
+ * Private declarations for the vectorized GAlgorithm primitive
+ * sorting kernels.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define G_ALGORITHM_HAVE_AVX2_KERNELS 1
+#endif
+
+#ifdef G_ALGORITHM_HAVE_AVX2_KERNELS
+gboolean g_algorithm_avx2_supported (void);
+
+void g_algorithm_avx2_sort_int32 (gint32 *data,
+                                  size_t  len);
+
+void g_algorithm_avx2_sort_int64 (gint64 *data,
+                                  size_t  len);
+#endif
+
+G_END_DECLS
@@ -0,0 +1,373 @@
+/*
+ * /galgorithm/galgorithm-primitive-sort.c
+ *
+ * Implementation for GAlgorithm Primitive Sort, sorting GArrays of
+ * integer and floating point keys directly. Uses the AVX2 kernels in
+ * galgorithm-primitive-sort-avx2.c where the CPU supports them and a
+ * scalar merge sort otherwise. Runs in O(2N) space and O(N log N) time.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-primitive-sort.h>
+#include <galgorithm/galgorithm-primitive-sort-private.h>
+
+/* Runs of this length are insertion sorted before merging */
+#define SCALAR_RUN_LENGTH 16
+
+typedef struct {
+  gint64  key;
+  guint32 index;
+} IndexedKey64;
+
+#define KEY_LESS(a, b) ((a) < (b))
+#define INDEXED_KEY_LESS(a, b) ((a).key < (b).key)
+
+/* Stable bottom-up merge sort over a plain C array, used on CPUs
+ * without vector kernels and for keys that the kernels can't carry. */
+#define DEFINE_SCALAR_MERGE_SORT(name, type, less)                            \
+static void                                                                   \
+name (type *data, size_t len)                                                 \
+{                                                                             \
+  for (size_t start = 0; start < len; start += SCALAR_RUN_LENGTH)             \
+    {                                                                         \
+      size_t end = MIN (start + SCALAR_RUN_LENGTH, len);                      \
+                                                                              \
+      for (size_t i = start + 1; i < end; ++i)                                \
+        {                                                                     \
+          type candidate = data[i];                                           \
+          size_t j = i;                                                       \
+                                                                              \
+          for (; j > start && less (candidate, data[j - 1]); --j)             \
+            data[j] = data[j - 1];                                            \
+                                                                              \
+          data[j] = candidate;                                                \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+  if (len <= SCALAR_RUN_LENGTH)                                               \
+    return;                                                                   \
+                                                                              \
+  g_autofree type *scratch = g_new (type, len);                               \
+  type *input = data;                                                         \
+  type *output = scratch;                                                     \
+                                                                              \
+  for (size_t run = SCALAR_RUN_LENGTH; run < len; run <<= 1)                  \
+    {                                                                         \
+      for (size_t start = 0; start < len; start += 2 * run)                   \
+        {                                                                     \
+          size_t middle = MIN (start + run, len);                             \
+          size_t end = MIN (start + 2 * run, len);                            \
+          size_t j = start, k = middle, p = start;                            \
+                                                                              \
+          while (j < middle && k < end)                                       \
+            output[p++] = less (input[k], input[j]) ? input[k++] : input[j++]; \
+          while (j < middle)                                                  \
+            output[p++] = input[j++];                                         \
+          while (k < end)                                                     \
+            output[p++] = input[k++];                                         \
+        }                                                                     \
+                                                                              \
+      /* Buffer swap */                                                       \
+      type *tmp = input;                                                      \
+      input = output;                                                         \
+      output = tmp;                                                           \
+    }                                                                         \
+                                                                              \
+  if (input != data)                                                          \
+    memcpy (data, input, len * sizeof (type));                                \
+}
+
+DEFINE_SCALAR_MERGE_SORT (scalar_sort_int32, gint32, KEY_LESS)
+DEFINE_SCALAR_MERGE_SORT (scalar_sort_int64, gint64, KEY_LESS)
+DEFINE_SCALAR_MERGE_SORT (scalar_sort_indexed_int64, IndexedKey64, INDEXED_KEY_LESS)
+
+static void
+sort_int32 (gint32 *data, size_t len)
+{
+#ifdef G_ALGORITHM_HAVE_AVX2_KERNELS
+  if (len >= 64 && g_algorithm_avx2_supported ())
+    {
+      g_algorithm_avx2_sort_int32 (data, len);
+      return;
+    }
+#endif
+
+  scalar_sort_int32 (data, len);
+}
+
+static void
+sort_int64 (gint64 *data, size_t len)
+{
+#ifdef G_ALGORITHM_HAVE_AVX2_KERNELS
+  if (len >= 16 && g_algorithm_avx2_supported ())
+    {
+      g_algorithm_avx2_sort_int64 (data, len);
+      return;
+    }
+#endif
+
+  scalar_sort_int64 (data, len);
+}
+
+/* Reinterpret IEEE 754 floats as integers with the same ordering.
+ * Negative floats order in reverse of their magnitude bits, so flip
+ * everything but the sign for those. Applying this twice gets the
+ * original bits back. NaNs end up at either end. */
+static void
+float_bits_to_sortable (gint32 *bits, size_t len)
+{
+  for (size_t i = 0; i < len; ++i)
+    bits[i] ^= (bits[i] >> 31) & G_MAXINT32;
+}
+
+static void
+double_bits_to_sortable (gint64 *bits, size_t len)
+{
+  for (size_t i = 0; i < len; ++i)
+    bits[i] ^= (bits[i] >> 63) & G_MAXINT64;
+}
+
+/* 32 bit keys carry their index by packing both into one 64 bit key.
+ * The key goes in the high half so it dominates the ordering, and the
+ * unique index breaks ties, which also makes the sort stable. */
+static GArray *
+sort_int32_with_index (gint32 *data, size_t len)
+{
+  GArray *indices = g_array_sized_new (FALSE, FALSE, sizeof (guint32), len);
+  g_autofree gint64 *packed = g_new (gint64, len);
+
+  g_array_set_size (indices, len);
+
+  for (size_t i = 0; i < len; ++i)
+    packed[i] = (gint64) (((guint64) (guint32) data[i] << 32) | (guint32) i);
+
+  sort_int64 (packed, len);
+
+  for (size_t i = 0; i < len; ++i)
+    {
+      data[i] = (gint32) (packed[i] >> 32);
+      g_array_index (indices, guint32, i) = (guint32) packed[i];
+    }
+
+  return indices;
+}
+
+static GArray *
+sort_int64_with_index (gint64 *data, size_t len)
+{
+  GArray *indices = g_array_sized_new (FALSE, FALSE, sizeof (guint32), len);
+  g_autofree IndexedKey64 *entries = g_new (IndexedKey64, len);
+
+  g_array_set_size (indices, len);
+
+  for (size_t i = 0; i < len; ++i)
+    {
+      entries[i].key = data[i];
+      entries[i].index = (guint32) i;
+    }
+
+  scalar_sort_indexed_int64 (entries, len);
+
+  for (size_t i = 0; i < len; ++i)
+    {
+      data[i] = entries[i].key;
+      g_array_index (indices, guint32, i) = entries[i].index;
+    }
+
+  return indices;
+}
+
+/**
+ * g_algorithm_sort_int32:
+ * @array: (element-type gint32): A #GArray of #gint32.
+ *
+ * Sort @array in ascending order, returning a reference to @array. Uses
+ * vectorized sorting networks and merges on CPUs that support AVX2.
+ *
+ * Return: (transfer none) (element-type gint32): @array, sorted in-place.
+ */
+GArray * g_algorithm_sort_int32 (GArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (array) == sizeof (gint32), NULL);
+
+  sort_int32 ((gint32 *) array->data, array->len);
+  return array;
+}
+
+/**
+ * g_algorithm_sort_int64:
+ * @array: (element-type gint64): A #GArray of #gint64.
+ *
+ * Sort @array in ascending order, returning a reference to @array. Uses
+ * vectorized sorting networks and merges on CPUs that support AVX2.
+ *
+ * Return: (transfer none) (element-type gint64): @array, sorted in-place.
+ */
+GArray * g_algorithm_sort_int64 (GArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (array) == sizeof (gint64), NULL);
+
+  sort_int64 ((gint64 *) array->data, array->len);
+  return array;
+}
+
+/**
+ * g_algorithm_sort_float:
+ * @array: (element-type gfloat): A #GArray of #gfloat.
+ *
+ * Sort @array in ascending order, returning a reference to @array. -0.0
+ * sorts before 0.0, negative NaNs sort first and positive NaNs sort last.
+ *
+ * Return: (transfer none) (element-type gfloat): @array, sorted in-place.
+ */
+GArray * g_algorithm_sort_float (GArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (array) == sizeof (gfloat), NULL);
+
+  gint32 *bits = (gint32 *) array->data;
+
+  float_bits_to_sortable (bits, array->len);
+  sort_int32 (bits, array->len);
+  float_bits_to_sortable (bits, array->len);
+
+  return array;
+}
+
+/**
+ * g_algorithm_sort_double:
+ * @array: (element-type gdouble): A #GArray of #gdouble.
+ *
+ * Sort @array in ascending order, returning a reference to @array. -0.0
+ * sorts before 0.0, negative NaNs sort first and positive NaNs sort last.
+ *
+ * Return: (transfer none) (element-type gdouble): @array, sorted in-place.
+ */
+GArray * g_algorithm_sort_double (GArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (array) == sizeof (gdouble), NULL);
+
+  gint64 *bits = (gint64 *) array->data;
+
+  double_bits_to_sortable (bits, array->len);
+  sort_int64 (bits, array->len);
+  double_bits_to_sortable (bits, array->len);
+
+  return array;
+}
+
+/**
+ * g_algorithm_sort_int32_with_index:
+ * @array: (element-type gint32): A #GArray of #gint32.
+ *
+ * Stable sort @array in ascending order, carrying the original index of
+ * each key along with it.
+ *
+ * Return: (transfer full) (element-type guint32): A new #GArray where the
+ *         element at each position is the index that the key now at that
+ *         position in @array had before sorting.
+ */
+GArray * g_algorithm_sort_int32_with_index (GArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (array) == sizeof (gint32), NULL);
+  g_return_val_if_fail(array->len <= G_MAXUINT32, NULL);
+
+  return sort_int32_with_index ((gint32 *) array->data, array->len);
+}
+
+/**
+ * g_algorithm_sort_int64_with_index:
+ * @array: (element-type gint64): A #GArray of #gint64.
+ *
+ * Stable sort @array in ascending order, carrying the original index of
+ * each key along with it. 64 bit keys always use the scalar sort.
+ *
+ * Return: (transfer full) (element-type guint32): A new #GArray where the
+ *         element at each position is the index that the key now at that
+ *         position in @array had before sorting.
+ */
+GArray * g_algorithm_sort_int64_with_index (GArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (array) == sizeof (gint64), NULL);
+  g_return_val_if_fail(array->len <= G_MAXUINT32, NULL);
+
+  return sort_int64_with_index ((gint64 *) array->data, array->len);
+}
+
+/**
+ * g_algorithm_sort_float_with_index:
+ * @array: (element-type gfloat): A #GArray of #gfloat.
+ *
+ * Stable sort @array in ascending order, carrying the original index of
+ * each key along with it. See g_algorithm_sort_float() for how NaNs and
+ * signed zeros are ordered.
+ *
+ * Return: (transfer full) (element-type guint32): A new #GArray where the
+ *         element at each position is the index that the key now at that
+ *         position in @array had before sorting.
+ */
+GArray * g_algorithm_sort_float_with_index (GArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (array) == sizeof (gfloat), NULL);
+  g_return_val_if_fail(array->len <= G_MAXUINT32, NULL);
+
+  gint32 *bits = (gint32 *) array->data;
+
+  float_bits_to_sortable (bits, array->len);
+  GArray *indices = sort_int32_with_index (bits, array->len);
+  float_bits_to_sortable (bits, array->len);
+
+  return indices;
+}
+
+/**
+ * g_algorithm_sort_double_with_index:
+ * @array: (element-type gdouble): A #GArray of #gdouble.
+ *
+ * Stable sort @array in ascending order, carrying the original index of
+ * each key along with it. See g_algorithm_sort_double() for how NaNs and
+ * signed zeros are ordered.
+ *
+ * Return: (transfer full) (element-type guint32): A new #GArray where the
+ *         element at each position is the index that the key now at that
+ *         position in @array had before sorting.
+ */
+GArray * g_algorithm_sort_double_with_index (GArray *array)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (array) == sizeof (gdouble), NULL);
+  g_return_val_if_fail(array->len <= G_MAXUINT32, NULL);
+
+  gint64 *bits = (gint64 *) array->data;
+
+  double_bits_to_sortable (bits, array->len);
+  GArray *indices = sort_int64_with_index (bits, array->len);
+  double_bits_to_sortable (bits, array->len);
+
+  return indices;
+}
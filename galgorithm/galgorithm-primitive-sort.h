@@ -0,0 +1,46 @@
+/*
+ * /galgorithm/galgorithm-primitive-sort.h
+ *
+ * Forward declarations for GAlgorithm Primitive Sort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+GArray * g_algorithm_sort_int32 (GArray *array);
+
+GArray * g_algorithm_sort_int64 (GArray *array);
+
+GArray * g_algorithm_sort_float (GArray *array);
+
+GArray * g_algorithm_sort_double (GArray *array);
+
+GArray * g_algorithm_sort_int32_with_index (GArray *array);
+
+GArray * g_algorithm_sort_int64_with_index (GArray *array);
+
+GArray * g_algorithm_sort_float_with_index (GArray *array);
+
+GArray * g_algorithm_sort_double_with_index (GArray *array);
+
+G_END_DECLS
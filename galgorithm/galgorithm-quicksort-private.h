@@ -0,0 +1,48 @@
+/*
+ * /galgorithm/galgorithm-quicksort-private.h
+ *
+ * Private declarations for GAlgorithm Quicksort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+#include <galgorithm/galgorithm-quicksort.h>
+
+G_BEGIN_DECLS
+
+/* Called after every partition with the number of elements that are
+ * known to be in their final position. Return FALSE to stop sorting. */
+typedef gboolean (*GAlgorithmQuicksortCheckFunc) (size_t   sorted,
+                                                  size_t   total,
+                                                  gpointer user_data);
+
+/* Sort @array like g_algorithm_quicksort_full, calling @check_func (if
+ * not NULL) as the sort progresses. @array is always left holding all of
+ * its elements, even if the sort was stopped. Returns FALSE if
+ * @check_func stopped the sort. */
+gboolean g_algorithm_quicksort_with_check (GPtrArray                    *array,
+                                           GAlgorithmCompareFunc         cmp,
+                                           GAlgorithmQuicksortPartition  partition_scheme,
+                                           GAlgorithmQuicksortCheckFunc  check_func,
+                                           gpointer                      user_data);
+
+G_END_DECLS
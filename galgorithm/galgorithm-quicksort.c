@@ -24,6 +24,8 @@
 #include <glib.h>
 
 #include <galgorithm/galgorithm-quicksort.h>
+#include <galgorithm/galgorithm-quicksort-private.h>
+#include <galgorithm/galgorithm-stats-private.h>
 
 static inline void
 swap (gpointer *lhs, gpointer *rhs)
@@ -31,6 +33,8 @@ swap (gpointer *lhs, gpointer *rhs)
   gpointer tmp = *lhs;
   *lhs = *rhs;
   *rhs = tmp;
+
+  G_ALGORITHM_STATS_ADD (swaps, 1);
 }
 
 /*
@@ -53,10 +57,140 @@ partition (GPtrArray             *array,
         }
     }
 
+  G_ALGORITHM_STATS_ADD (comparisons, upper - lower);
+
   swap(&array->pdata[upper], &array->pdata[pivotReplacementIdx]);
   return pivotReplacementIdx;
 }
 
+/* Number of elements classified per block in block_partition. Offsets
+ * within a block are stored as unsigned chars, so this must not
+ * exceed 256. */
+#define BLOCK_SIZE 128
+
+/*
+ * Move the median of the first, middle and last elements of
+ * [@lower, @upper] into @upper, so that it gets used as the pivot.
+ */
+static void
+median_of_three_to_upper (GPtrArray             *array,
+                          GAlgorithmCompareFunc  cmp,
+                          size_t                 lower,
+                          size_t                 upper)
+{
+  size_t middle = lower + (upper - lower) / 2;
+  gpointer *pdata = array->pdata;
+
+  if (G_ALGORITHM_STATS_COMPARE (cmp, pdata[middle], pdata[lower]) < 0)
+    swap (&pdata[middle], &pdata[lower]);
+  if (G_ALGORITHM_STATS_COMPARE (cmp, pdata[upper], pdata[lower]) < 0)
+    swap (&pdata[upper], &pdata[lower]);
+  if (G_ALGORITHM_STATS_COMPARE (cmp, pdata[middle], pdata[upper]) < 0)
+    swap (&pdata[middle], &pdata[upper]);
+}
+
+/*
+ * Block partition the array (Edelkamp and Weiß, "BlockQuicksort").
+ * @lower and @upper are inclusive bounds, same as partition.
+ *
+ * Instead of branching on each comparison, we scan a block of
+ * BLOCK_SIZE elements from each end and unconditionally write the
+ * offset of every element into an offsets buffer, only advancing the
+ * buffer when the element is on the wrong side of the pivot. Then we
+ * swap the misplaced elements pairwise in a second pass. Elements equal
+ * to the pivot count as misplaced on both sides, which keeps the
+ * partition balanced when there are lots of duplicates.
+ */
+static size_t
+block_partition (GPtrArray             *array,
+                 GAlgorithmCompareFunc  cmp,
+                 size_t                 lower,
+                 size_t                 upper)
+{
+  gpointer *pdata = array->pdata;
+  unsigned char offsets_left[BLOCK_SIZE];
+  unsigned char offsets_right[BLOCK_SIZE];
+  size_t num_left = 0, num_right = 0;
+  size_t start_left = 0, start_right = 0;
+
+  if (upper - lower >= 2)
+    median_of_three_to_upper (array, cmp, lower, upper);
+
+  gpointer pivot = pdata[upper];
+
+  /* The unpartitioned region is [left, right), everything before
+   * left is <= pivot and everything from right up to (but not including)
+   * upper is >= pivot. */
+  size_t left = lower;
+  size_t right = upper;
+
+  while (right - left > 2 * BLOCK_SIZE)
+    {
+      if (num_left == 0)
+        {
+          start_left = 0;
+          for (size_t i = 0; i < BLOCK_SIZE; ++i)
+            {
+              offsets_left[num_left] = (unsigned char) i;
+              num_left += (cmp (pdata[left + i], pivot) >= 0);
+            }
+
+          G_ALGORITHM_STATS_ADD (comparisons, BLOCK_SIZE);
+        }
+
+      if (num_right == 0)
+        {
+          start_right = 0;
+          for (size_t i = 0; i < BLOCK_SIZE; ++i)
+            {
+              offsets_right[num_right] = (unsigned char) i;
+              num_right += (cmp (pivot, pdata[right - 1 - i]) >= 0);
+            }
+
+          G_ALGORITHM_STATS_ADD (comparisons, BLOCK_SIZE);
+        }
+
+      /* Second pass, swap as many misplaced pairs as we can */
+      size_t num = num_left < num_right ? num_left : num_right;
+
+      for (size_t j = 0; j < num; ++j)
+        swap (&pdata[left + offsets_left[start_left + j]],
+              &pdata[right - 1 - offsets_right[start_right + j]]);
+
+      num_left -= num;
+      num_right -= num;
+      start_left += num;
+      start_right += num;
+
+      /* A block is done once all of its misplaced elements are gone */
+      if (num_left == 0)
+        left += BLOCK_SIZE;
+      if (num_right == 0)
+        right -= BLOCK_SIZE;
+    }
+
+  /* At most one block still has misplaced elements in it, and there
+   * are fewer than three blocks worth of elements left. Just finish
+   * off the remaining region with a plain Hoare-style scan. */
+  for (;;)
+    {
+      while (left < right && G_ALGORITHM_STATS_COMPARE (cmp, pdata[left], pivot) < 0)
+        ++left;
+      while (left < right && G_ALGORITHM_STATS_COMPARE (cmp, pivot, pdata[right - 1]) < 0)
+        --right;
+
+      if (right - left <= 1)
+        break;
+
+      swap (&pdata[left++], &pdata[--right]);
+    }
+
+  /* Everything before right is now <= pivot and everything from right
+   * onwards is >= pivot, so put the pivot in between */
+  swap (&pdata[upper], &pdata[right]);
+  return right;
+}
+
 
 /**
  * g_algorithm_quicksort:
@@ -72,13 +206,48 @@ partition (GPtrArray             *array,
  */
 GPtrArray * g_algorithm_quicksort (GPtrArray            *array,
                                    GAlgorithmCompareFunc cmp)
+{
+  return g_algorithm_quicksort_full (array,
+                                     cmp,
+                                     G_ALGORITHM_QUICKSORT_PARTITION_LOMUTO);
+}
+
+/**
+ * g_algorithm_quicksort_full:
+ * @array: (element-type GObject): A #GPtrArray
+ * @cmp: (scope async): A #GAlgorithmCompareFunc to compare two elements.
+ * @partition_scheme: A #GAlgorithmQuicksortPartition to partition with.
+ *
+ * Do quicksort on the array using @partition_scheme, returning a
+ * reference to the array. %G_ALGORITHM_QUICKSORT_PARTITION_BLOCK is
+ * usually faster on large, randomly ordered arrays.
+ *
+ * Return: (transfer none) (element-type GObject): @array, sorted in-place.
+ */
+GPtrArray * g_algorithm_quicksort_full (GPtrArray                    *array,
+                                        GAlgorithmCompareFunc         cmp,
+                                        GAlgorithmQuicksortPartition  partition_scheme)
 {
   g_return_val_if_fail(array != NULL, NULL);
   g_return_val_if_fail(cmp != NULL, NULL);
 
+  g_algorithm_quicksort_with_check (array, cmp, partition_scheme, NULL, NULL);
+  return array;
+}
+
+/* Not part of the public API, see galgorithm-quicksort-private.h */
+gboolean
+g_algorithm_quicksort_with_check (GPtrArray                    *array,
+                                  GAlgorithmCompareFunc         cmp,
+                                  GAlgorithmQuicksortPartition  partition_scheme,
+                                  GAlgorithmQuicksortCheckFunc  check_func,
+                                  gpointer                      user_data)
+{
   /* Quick check, an empty array can't be accessed */
   if (array->len <= 1)
-    return array;
+    return TRUE;
+
+  G_ALGORITHM_OPERATION_BEGIN (quicksort, array->len);
 
   /* Non-recursive quicksort, here is how it works
    *
@@ -94,6 +263,9 @@ GPtrArray * g_algorithm_quicksort (GPtrArray            *array,
   size_t *stack_data = (size_t *) stack->data;
   stack->len = array->len;
   size_t top = 0;
+  size_t sorted = 0;
+
+  G_ALGORITHM_STATS_ADD (scratch_bytes, array->len * sizeof (size_t));
 
   stack_data[top++] = 0;
   stack_data[top++] = array->len - 1;
@@ -103,7 +275,9 @@ GPtrArray * g_algorithm_quicksort (GPtrArray            *array,
       size_t upper = stack_data[--top];
       size_t lower = stack_data[--top];
 
-      size_t pivot = partition(array, cmp, lower, upper);
+      size_t pivot = partition_scheme == G_ALGORITHM_QUICKSORT_PARTITION_BLOCK ?
+                     block_partition (array, cmp, lower, upper) :
+                     partition (array, cmp, lower, upper);
 
       /* We have now done the partition, check if we have any work
        * left to do on the lower and upper partitions */
@@ -122,7 +296,20 @@ GPtrArray * g_algorithm_quicksort (GPtrArray            *array,
           stack_data[top++] = pivot + 1;
           stack_data[top++] = upper;
         }
+
+      /* The pivot is now in its final position, and so is the
+       * element after it if that was all that was left */
+      sorted += (pivot + 1 == upper) ? 2 : 1;
+      G_ALGORITHM_STATS_ADD (passes, 1);
+
+      if (check_func != NULL && !check_func (sorted, array->len, user_data))
+        {
+          G_ALGORITHM_OPERATION_END (quicksort, array->len);
+          return FALSE;
+        }
     }
-  
-  return array;
+
+  G_ALGORITHM_OPERATION_END (quicksort, array->len);
+
+  return TRUE;
 }
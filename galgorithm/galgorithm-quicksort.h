@@ -0,0 +1,55 @@
+/*
+ * /galgorithm/galgorithm-quicksort.h
+ *
+ * Forward declarations for GAlgorithm Quicksort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+/**
+ * GAlgorithmQuicksortPartition:
+ * @G_ALGORITHM_QUICKSORT_PARTITION_LOMUTO: Classic single-scan partition
+ *   using the last element of the range as the pivot.
+ * @G_ALGORITHM_QUICKSORT_PARTITION_BLOCK: Block partition (BlockQuicksort).
+ *   Comparison outcomes are buffered into offset arrays a block at a time
+ *   without branching and the swaps are done in a second pass, which
+ *   avoids most branch mispredictions on random data.
+ *
+ * The partitioning scheme used by g_algorithm_quicksort_full().
+ */
+typedef enum {
+  G_ALGORITHM_QUICKSORT_PARTITION_LOMUTO,
+  G_ALGORITHM_QUICKSORT_PARTITION_BLOCK
+} GAlgorithmQuicksortPartition;
+
+GPtrArray * g_algorithm_quicksort (GPtrArray             *array,
+                                   GAlgorithmCompareFunc  cmp);
+
+GPtrArray * g_algorithm_quicksort_full (GPtrArray                    *array,
+                                        GAlgorithmCompareFunc         cmp,
+                                        GAlgorithmQuicksortPartition  partition_scheme);
+
+G_END_DECLS
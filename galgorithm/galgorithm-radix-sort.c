@@ -0,0 +1,394 @@
+/*
+ * /galgorithm/galgorithm-radix-sort.c
+ *
+ * Implementation for GAlgorithm Radix Sort. Runs in O(4N) space
+ * and O(8N) time.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-radix-sort.h>
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (sizeof (guint64) * 8 / RADIX_BITS)
+
+/* Below this many elements per thread, the cost of starting the
+ * threads outweighs the work they would do */
+#define RADIX_MIN_ELEMENTS_PER_THREAD (1 << 14)
+
+typedef struct {
+  guint64  key;
+  gpointer element;
+} RadixEntry;
+
+typedef struct _RadixParallelSort RadixParallelSort;
+
+typedef struct {
+  RadixParallelSort *sort;
+  guint              index;
+  size_t             begin;
+  size_t             end;
+  size_t             counts[RADIX_BUCKETS];
+} RadixWorker;
+
+/* GLib has no barrier, so build one out of a mutex and a condition.
+ * The generation count lets the barrier be waited on again straight
+ * after it releases. */
+typedef struct {
+  GMutex mutex;
+  GCond  cond;
+  guint  n_threads;
+  guint  n_waiting;
+  guint  generation;
+} RadixBarrier;
+
+/* The workers are started once per sort and run every pass, meeting
+ * at the barrier between counting and scattering. */
+struct _RadixParallelSort {
+  RadixEntry   *buffers[2];
+  const guint  *passes;
+  guint         n_passes;
+  RadixWorker  *workers;
+  guint         n_workers;
+  RadixBarrier  barrier;
+};
+
+static inline unsigned int
+radix_digit (guint64 key, unsigned int shift)
+{
+  return (unsigned int) (key >> shift) & (RADIX_BUCKETS - 1);
+}
+
+/* Map the key onto an unsigned integer with the same ordering, so
+ * that all of the passes can treat it as plain bytes. */
+static inline guint64
+radix_key_to_unsigned (guint64 key, GAlgorithmRadixKeyType key_type)
+{
+  switch (key_type)
+    {
+      case G_ALGORITHM_RADIX_KEY_SIGNED:
+        /* Flipping the sign bit moves negative numbers below
+         * positive ones */
+        return key ^ (G_GUINT64_CONSTANT (1) << 63);
+      case G_ALGORITHM_RADIX_KEY_FLOAT:
+        {
+          /* Negative floats sort in reverse order of their magnitude
+           * bits, so flip all of them. Positive floats only need the
+           * sign bit set to go above the negative ones. */
+          guint32 bits = (guint32) key;
+          return (bits & 0x80000000u) ? (guint32) ~bits : (bits | 0x80000000u);
+        }
+      case G_ALGORITHM_RADIX_KEY_DOUBLE:
+        return (key & (G_GUINT64_CONSTANT (1) << 63)) ?
+               ~key : (key | (G_GUINT64_CONSTANT (1) << 63));
+      case G_ALGORITHM_RADIX_KEY_UNSIGNED:
+      default:
+        return key;
+    }
+}
+
+static void
+radix_barrier_wait (RadixBarrier *barrier)
+{
+  g_mutex_lock (&barrier->mutex);
+
+  guint generation = barrier->generation;
+
+  if (++barrier->n_waiting == barrier->n_threads)
+    {
+      barrier->n_waiting = 0;
+      barrier->generation++;
+      g_cond_broadcast (&barrier->cond);
+    }
+  else
+    {
+      while (generation == barrier->generation)
+        g_cond_wait (&barrier->cond, &barrier->mutex);
+    }
+
+  g_mutex_unlock (&barrier->mutex);
+}
+
+/* Do every pass over this worker's chunk. In each pass, every worker
+ * counts its own chunk, then lays out the offsets digit-major,
+ * worker-minor, which keeps the scatter stable. */
+static gpointer
+radix_worker_run (gpointer data)
+{
+  RadixWorker *worker = data;
+  RadixParallelSort *sort = worker->sort;
+  size_t offsets[RADIX_BUCKETS];
+
+  for (guint p = 0; p < sort->n_passes; ++p)
+    {
+      const RadixEntry *src = sort->buffers[p % 2];
+      RadixEntry *dst = sort->buffers[(p + 1) % 2];
+      unsigned int shift = sort->passes[p] * RADIX_BITS;
+
+      memset (worker->counts, 0, sizeof (worker->counts));
+
+      for (size_t i = worker->begin; i < worker->end; ++i)
+        worker->counts[radix_digit (src[i].key, shift)]++;
+
+      radix_barrier_wait (&sort->barrier);
+
+      size_t offset = 0;
+      for (unsigned int digit = 0; digit < RADIX_BUCKETS; ++digit)
+        {
+          for (guint t = 0; t < sort->n_workers; ++t)
+            {
+              if (t == worker->index)
+                offsets[digit] = offset;
+
+              offset += sort->workers[t].counts[digit];
+            }
+        }
+
+      for (size_t i = worker->begin; i < worker->end; ++i)
+        {
+          unsigned int digit = radix_digit (src[i].key, shift);
+          dst[offsets[digit]++] = src[i];
+        }
+
+      /* Nobody may start counting the next pass until the scatter
+       * into its source is finished */
+      radix_barrier_wait (&sort->barrier);
+    }
+
+  return NULL;
+}
+
+/* Do all of @passes in parallel across @n_workers threads, using the
+ * calling thread for the first one. The result ends up in
+ * buffers[n_passes % 2]. */
+static void
+radix_parallel_sort (RadixEntry  *entries,
+                     RadixEntry  *scratch,
+                     size_t       len,
+                     const guint *passes,
+                     guint        n_passes,
+                     guint        n_workers)
+{
+  g_autofree RadixWorker *workers = g_new0 (RadixWorker, n_workers);
+  g_autofree GThread **threads = g_new0 (GThread *, n_workers);
+  RadixParallelSort sort = {
+    .buffers = { entries, scratch },
+    .passes = passes,
+    .n_passes = n_passes,
+    .workers = workers,
+    .n_workers = n_workers
+  };
+
+  g_mutex_init (&sort.barrier.mutex);
+  g_cond_init (&sort.barrier.cond);
+  sort.barrier.n_threads = n_workers;
+
+  for (guint t = 0; t < n_workers; ++t)
+    {
+      workers[t].sort = &sort;
+      workers[t].index = t;
+      workers[t].begin = (len * t) / n_workers;
+      workers[t].end = (len * (t + 1)) / n_workers;
+    }
+
+  for (guint t = 1; t < n_workers; ++t)
+    threads[t] = g_thread_new ("galgorithm-radix", radix_worker_run, &workers[t]);
+
+  radix_worker_run (&workers[0]);
+
+  for (guint t = 1; t < n_workers; ++t)
+    g_thread_join (threads[t]);
+
+  g_cond_clear (&sort.barrier.cond);
+  g_mutex_clear (&sort.barrier.mutex);
+}
+
+static void
+radix_serial_pass (const RadixEntry *src,
+                   RadixEntry       *dst,
+                   size_t            len,
+                   const size_t     *counts,
+                   unsigned int      shift)
+{
+  size_t offsets[RADIX_BUCKETS];
+  size_t offset = 0;
+
+  for (unsigned int digit = 0; digit < RADIX_BUCKETS; ++digit)
+    {
+      offsets[digit] = offset;
+      offset += counts[digit];
+    }
+
+  for (size_t i = 0; i < len; ++i)
+    dst[offsets[radix_digit (src[i].key, shift)]++] = src[i];
+}
+
+/**
+ * g_algorithm_radix_key_from_float:
+ * @value: A #gfloat key.
+ *
+ * Encode @value for use with %G_ALGORITHM_RADIX_KEY_FLOAT.
+ *
+ * Returns: The bits of @value as a #guint64.
+ */
+guint64
+g_algorithm_radix_key_from_float (gfloat value)
+{
+  guint32 bits;
+
+  memcpy (&bits, &value, sizeof (bits));
+  return bits;
+}
+
+/**
+ * g_algorithm_radix_key_from_double:
+ * @value: A #gdouble key.
+ *
+ * Encode @value for use with %G_ALGORITHM_RADIX_KEY_DOUBLE.
+ *
+ * Returns: The bits of @value as a #guint64.
+ */
+guint64
+g_algorithm_radix_key_from_double (gdouble value)
+{
+  guint64 bits;
+
+  memcpy (&bits, &value, sizeof (bits));
+  return bits;
+}
+
+/**
+ * g_algorithm_radix_sort:
+ * @array: (element-type GObject): A #GPtrArray
+ * @key_func: (scope call): A #GAlgorithmRadixKeyFunc to extract the key
+ *            from each element.
+ * @key_type: The #GAlgorithmRadixKeyType that @key_func returns.
+ *
+ * Do a stable least-significant-digit radix sort on @array by the
+ * integer or floating point key returned by @key_func, returning a
+ * reference to @array. @key_func is called exactly once per element.
+ *
+ * Return: (transfer none) (element-type GObject): @array, sorted in-place.
+ */
+GPtrArray * g_algorithm_radix_sort (GPtrArray              *array,
+                                    GAlgorithmRadixKeyFunc  key_func,
+                                    GAlgorithmRadixKeyType  key_type)
+{
+  return g_algorithm_radix_sort_full (array, key_func, key_type, 1);
+}
+
+/**
+ * g_algorithm_radix_sort_full:
+ * @array: (element-type GObject): A #GPtrArray
+ * @key_func: (scope call): A #GAlgorithmRadixKeyFunc to extract the key
+ *            from each element.
+ * @key_type: The #GAlgorithmRadixKeyType that @key_func returns.
+ * @n_threads: The number of threads to count and scatter with, or 0
+ *             to use one per processor.
+ *
+ * Like g_algorithm_radix_sort(), but splits the histogram and scatter
+ * step of each pass across up to @n_threads threads. Small arrays are
+ * always sorted on the calling thread. @key_func is only ever called
+ * from the calling thread.
+ *
+ * Return: (transfer none) (element-type GObject): @array, sorted in-place.
+ */
+GPtrArray * g_algorithm_radix_sort_full (GPtrArray              *array,
+                                         GAlgorithmRadixKeyFunc  key_func,
+                                         GAlgorithmRadixKeyType  key_type,
+                                         guint                   n_threads)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(key_func != NULL, NULL);
+
+  size_t len = array->len;
+
+  if (len <= 1)
+    return array;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  n_threads = MIN (n_threads, MAX (len / RADIX_MIN_ELEMENTS_PER_THREAD, 1));
+
+  /* Extract every key exactly once into a contiguous buffer, so that
+   * the passes never have to chase the element pointers. */
+  g_autofree RadixEntry *entries = g_new (RadixEntry, len);
+  g_autofree RadixEntry *scratch = g_new (RadixEntry, len);
+
+  for (size_t i = 0; i < len; ++i)
+    {
+      entries[i].key = radix_key_to_unsigned (key_func (array->pdata[i]), key_type);
+      entries[i].element = array->pdata[i];
+    }
+
+  /* The number of keys with each digit does not depend on the order of
+   * the keys, so we can count every pass up front. A pass where all the
+   * keys share the same digit would not move anything, so skip it.
+   * Knowing which passes to do up front also lets the threads run
+   * all of them without coming back to us in between. */
+  g_autofree size_t *counts = g_new0 (size_t, RADIX_PASSES * RADIX_BUCKETS);
+
+  for (size_t i = 0; i < len; ++i)
+    for (unsigned int pass = 0; pass < RADIX_PASSES; ++pass)
+      counts[pass * RADIX_BUCKETS + radix_digit (entries[i].key, pass * RADIX_BITS)]++;
+
+  guint passes[RADIX_PASSES];
+  guint n_passes = 0;
+
+  for (unsigned int pass = 0; pass < RADIX_PASSES; ++pass)
+    {
+      const size_t *pass_counts = &counts[pass * RADIX_BUCKETS];
+
+      if (pass_counts[radix_digit (entries[0].key, pass * RADIX_BITS)] != len)
+        passes[n_passes++] = pass;
+    }
+
+  RadixEntry *src = entries;
+  RadixEntry *dst = scratch;
+
+  if (n_threads > 1)
+    {
+      radix_parallel_sort (entries, scratch, len, passes, n_passes, n_threads);
+
+      if (n_passes % 2 != 0)
+        src = scratch;
+    }
+  else
+    {
+      for (guint p = 0; p < n_passes; ++p)
+        {
+          radix_serial_pass (src, dst, len, &counts[passes[p] * RADIX_BUCKETS], passes[p] * RADIX_BITS);
+
+          /* Buffer swap */
+          RadixEntry *tmp = src;
+          src = dst;
+          dst = tmp;
+        }
+    }
+
+  /* Scatter the pointers back into @array in their sorted order */
+  for (size_t i = 0; i < len; ++i)
+    array->pdata[i] = src[i].element;
+
+  return array;
+}
@@ -0,0 +1,74 @@
+/*
+ * /galgorithm/galgorithm-radix-sort.h
+ *
+ * Forward declarations for GAlgorithm Radix Sort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GAlgorithmRadixKeyType:
+ * @G_ALGORITHM_RADIX_KEY_UNSIGNED: Keys are unsigned 64 bit integers.
+ * @G_ALGORITHM_RADIX_KEY_SIGNED: Keys are signed 64 bit integers, cast
+ *   to #guint64.
+ * @G_ALGORITHM_RADIX_KEY_FLOAT: Keys are the bits of a #gfloat, as returned
+ *   by g_algorithm_radix_key_from_float().
+ * @G_ALGORITHM_RADIX_KEY_DOUBLE: Keys are the bits of a #gdouble, as returned
+ *   by g_algorithm_radix_key_from_double().
+ *
+ * How the #guint64 returned by a #GAlgorithmRadixKeyFunc should be
+ * interpreted when ordering elements.
+ */
+typedef enum {
+  G_ALGORITHM_RADIX_KEY_UNSIGNED,
+  G_ALGORITHM_RADIX_KEY_SIGNED,
+  G_ALGORITHM_RADIX_KEY_FLOAT,
+  G_ALGORITHM_RADIX_KEY_DOUBLE
+} GAlgorithmRadixKeyType;
+
+/**
+ * GAlgorithmRadixKeyFunc:
+ * @element: An element of the array being sorted.
+ *
+ * Extract the sort key from @element, encoded according to the
+ * #GAlgorithmRadixKeyType passed to the sort.
+ *
+ * Returns: The key for @element.
+ */
+typedef guint64 (*GAlgorithmRadixKeyFunc) (gconstpointer element);
+
+guint64 g_algorithm_radix_key_from_float (gfloat value);
+
+guint64 g_algorithm_radix_key_from_double (gdouble value);
+
+GPtrArray * g_algorithm_radix_sort (GPtrArray              *array,
+                                    GAlgorithmRadixKeyFunc  key_func,
+                                    GAlgorithmRadixKeyType  key_type);
+
+GPtrArray * g_algorithm_radix_sort_full (GPtrArray              *array,
+                                         GAlgorithmRadixKeyFunc  key_func,
+                                         GAlgorithmRadixKeyType  key_type,
+                                         guint                   n_threads);
+
+G_END_DECLS
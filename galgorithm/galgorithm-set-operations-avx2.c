@@ -0,0 +1,110 @@
+/*
+ * /galgorithm/galgorithm-set-operations-avx2.c
+ *
+ * AVX2 kernels for GAlgorithm Set Operations. Blocks of eight integers
+ * from each array are compared all-against-all with one compare per
+ * rotation of the second block, then whichever block ends first is
+ * replaced. Runs in O(N + M) time.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-set-operations-private.h>
+
+#ifdef G_ALGORITHM_HAVE_AVX2_KERNELS
+
+#include <immintrin.h>
+
+#define AVX2_FUNC __attribute__ ((target ("avx2")))
+
+/* Return a bitmask of the lanes of @va that are equal to any
+ * lane of @vb */
+static inline AVX2_FUNC unsigned int
+match_mask_epi32 (__m256i va, __m256i vb)
+{
+  /* The in-lane rotations pair each element with the other
+   * three in its half, and swapping the halves covers the rest */
+  __m256i vb_swapped = _mm256_permute2x128_si256 (vb, vb, 0x01);
+  __m256i matches = _mm256_cmpeq_epi32 (va, vb);
+
+  matches = _mm256_or_si256 (matches, _mm256_cmpeq_epi32 (va, _mm256_shuffle_epi32 (vb, 0x39)));
+  matches = _mm256_or_si256 (matches, _mm256_cmpeq_epi32 (va, _mm256_shuffle_epi32 (vb, 0x4e)));
+  matches = _mm256_or_si256 (matches, _mm256_cmpeq_epi32 (va, _mm256_shuffle_epi32 (vb, 0x93)));
+  matches = _mm256_or_si256 (matches, _mm256_cmpeq_epi32 (va, vb_swapped));
+  matches = _mm256_or_si256 (matches, _mm256_cmpeq_epi32 (va, _mm256_shuffle_epi32 (vb_swapped, 0x39)));
+  matches = _mm256_or_si256 (matches, _mm256_cmpeq_epi32 (va, _mm256_shuffle_epi32 (vb_swapped, 0x4e)));
+  matches = _mm256_or_si256 (matches, _mm256_cmpeq_epi32 (va, _mm256_shuffle_epi32 (vb_swapped, 0x93)));
+
+  return (unsigned int) _mm256_movemask_ps (_mm256_castsi256_ps (matches));
+}
+
+/* Both @a and @b must be strictly increasing, otherwise an element
+ * could match more than once. @out needs room for the shorter of the
+ * two arrays. */
+AVX2_FUNC size_t
+g_algorithm_avx2_intersect_uint32 (const guint32 *a,
+                                   size_t         a_len,
+                                   const guint32 *b,
+                                   size_t         b_len,
+                                   guint32       *out)
+{
+  size_t i = 0;
+  size_t j = 0;
+  size_t n = 0;
+
+  while (i + 8 <= a_len && j + 8 <= b_len)
+    {
+      __m256i va = _mm256_loadu_si256 ((const __m256i *) &a[i]);
+      __m256i vb = _mm256_loadu_si256 ((const __m256i *) &b[j]);
+      unsigned int mask = match_mask_epi32 (va, vb);
+      guint32 a_last = a[i + 7];
+      guint32 b_last = b[j + 7];
+
+      while (mask != 0)
+        {
+          out[n++] = a[i + __builtin_ctz (mask)];
+          mask &= mask - 1;
+        }
+
+      if (a_last <= b_last)
+        i += 8;
+
+      if (b_last <= a_last)
+        j += 8;
+    }
+
+  /* Finish off the tails */
+  while (i < a_len && j < b_len)
+    {
+      if (a[i] < b[j])
+        ++i;
+      else if (a[i] > b[j])
+        ++j;
+      else
+        {
+          out[n++] = a[i];
+          ++i;
+          ++j;
+        }
+    }
+
+  return n;
+}
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ * /galgorithm/galgorithm-set-operations-private.h
+ *
+ * Vectorized kernels for GAlgorithm Set Operations.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+#include <galgorithm/galgorithm-primitive-sort-private.h>
+
+G_BEGIN_DECLS
+
+#ifdef G_ALGORITHM_HAVE_AVX2_KERNELS
+size_t g_algorithm_avx2_intersect_uint32 (const guint32 *a,
+                                          size_t         a_len,
+                                          const guint32 *b,
+                                          size_t         b_len,
+                                          guint32       *out);
+#endif
+
+G_END_DECLS
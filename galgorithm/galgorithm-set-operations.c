@@ -0,0 +1,478 @@
+/*
+ * /galgorithm/galgorithm-set-operations.c
+ *
+ * Implementation for GAlgorithm Set Operations on sorted arrays. Runs
+ * in O(N + M) time, or O(N log (M / N)) for intersections of arrays
+ * with very different sizes.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-set-operations.h>
+#include <galgorithm/galgorithm-set-operations-private.h>
+
+/* When one array is at least this many times longer than the other,
+ * searching the longer one for each element of the shorter one does
+ * fewer comparisons than walking both */
+#define GALLOP_RATIO 32
+
+/* Find the first index from @begin of @data whose element is not less
+ * than @needle. Probes exponentially further ahead of @begin before
+ * binary searching the last step, so that it is cheap when the answer
+ * is close to @begin. */
+static size_t
+gallop_lower_bound (gpointer              *data,
+                    size_t                 begin,
+                    size_t                 len,
+                    gconstpointer          needle,
+                    GAlgorithmCompareFunc  cmp)
+{
+  size_t lo = begin;
+  size_t hi = begin;
+  size_t step = 1;
+
+  while (hi < len && cmp (data[hi], needle) < 0)
+    {
+      lo = hi + 1;
+      hi = lo + step;
+      step *= 2;
+    }
+
+  hi = MIN (hi, len);
+
+  while (lo < hi)
+    {
+      size_t midpoint = lo + ((hi - lo) / 2);
+
+      if (cmp (data[midpoint], needle) < 0)
+        lo = midpoint + 1;
+      else
+        hi = midpoint;
+    }
+
+  return lo;
+}
+
+static size_t
+gallop_lower_bound_uint32 (const guint32 *data,
+                           size_t         begin,
+                           size_t         len,
+                           guint32        needle)
+{
+  size_t lo = begin;
+  size_t hi = begin;
+  size_t step = 1;
+
+  while (hi < len && data[hi] < needle)
+    {
+      lo = hi + 1;
+      hi = lo + step;
+      step *= 2;
+    }
+
+  hi = MIN (hi, len);
+
+  while (lo < hi)
+    {
+      size_t midpoint = lo + ((hi - lo) / 2);
+
+      if (data[midpoint] < needle)
+        lo = midpoint + 1;
+      else
+        hi = midpoint;
+    }
+
+  return lo;
+}
+
+/* Intersect @a and @b into @result, always taking the elements
+ * from @a. */
+static void
+intersect_into (GPtrArray             *result,
+                GPtrArray             *a,
+                GPtrArray             *b,
+                GAlgorithmCompareFunc  cmp)
+{
+  if ((size_t) a->len * GALLOP_RATIO <= b->len ||
+      (size_t) b->len * GALLOP_RATIO <= a->len)
+    {
+      gboolean a_is_shorter = a->len <= b->len;
+      GPtrArray *shorter = a_is_shorter ? a : b;
+      GPtrArray *longer = a_is_shorter ? b : a;
+      size_t j = 0;
+
+      for (size_t i = 0; i < shorter->len && j < longer->len; ++i)
+        {
+          j = gallop_lower_bound (longer->pdata, j, longer->len, shorter->pdata[i], cmp);
+
+          if (j < longer->len && cmp (longer->pdata[j], shorter->pdata[i]) == 0)
+            {
+              g_ptr_array_add (result, a_is_shorter ? shorter->pdata[i] : longer->pdata[j]);
+              ++j;
+            }
+        }
+
+      return;
+    }
+
+  size_t i = 0;
+  size_t j = 0;
+
+  while (i < a->len && j < b->len)
+    {
+      int cmp_result = cmp (a->pdata[i], b->pdata[j]);
+
+      if (cmp_result < 0)
+        ++i;
+      else if (cmp_result > 0)
+        ++j;
+      else
+        {
+          g_ptr_array_add (result, a->pdata[i]);
+          ++i;
+          ++j;
+        }
+    }
+}
+
+static size_t
+intersect_uint32_merge (const guint32 *a,
+                        size_t         a_len,
+                        const guint32 *b,
+                        size_t         b_len,
+                        guint32       *out)
+{
+  size_t i = 0;
+  size_t j = 0;
+  size_t n = 0;
+
+  while (i < a_len && j < b_len)
+    {
+      if (a[i] < b[j])
+        ++i;
+      else if (a[i] > b[j])
+        ++j;
+      else
+        {
+          out[n++] = a[i];
+          ++i;
+          ++j;
+        }
+    }
+
+  return n;
+}
+
+static size_t
+intersect_uint32_gallop (const guint32 *shorter,
+                         size_t         shorter_len,
+                         const guint32 *longer,
+                         size_t         longer_len,
+                         guint32       *out)
+{
+  size_t j = 0;
+  size_t n = 0;
+
+  for (size_t i = 0; i < shorter_len && j < longer_len; ++i)
+    {
+      j = gallop_lower_bound_uint32 (longer, j, longer_len, shorter[i]);
+
+      if (j < longer_len && longer[j] == shorter[i])
+        {
+          out[n++] = shorter[i];
+          ++j;
+        }
+    }
+
+  return n;
+}
+
+/**
+ * g_algorithm_unique:
+ * @array: (element-type GObject): A #GPtrArray, sorted according to @cmp.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc.
+ *
+ * Remove all but the first of each run of elements that compare equal
+ * from @array, returning a reference to @array. The removed elements are
+ * freed with the free function of @array, if it has one.
+ *
+ * Return: (transfer none) (element-type GObject): @array, with duplicates
+ *         removed.
+ */
+GPtrArray * g_algorithm_unique (GPtrArray             *array,
+                                GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  if (array->len <= 1)
+    return array;
+
+  size_t write = 1;
+
+  for (size_t read = 1; read < array->len; ++read)
+    {
+      if (cmp (array->pdata[write - 1], array->pdata[read]) == 0)
+        continue;
+
+      /* Swap instead of overwriting, so the duplicates collect at the
+       * end where g_ptr_array_set_size() can free them */
+      gpointer tmp = array->pdata[write];
+      array->pdata[write++] = array->pdata[read];
+      array->pdata[read] = tmp;
+    }
+
+  g_ptr_array_set_size (array, (gint) write);
+  return array;
+}
+
+/**
+ * g_algorithm_set_union:
+ * @a: (element-type GObject): A #GPtrArray, sorted according to @cmp.
+ * @b: (element-type GObject): A #GPtrArray, sorted according to @cmp.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc.
+ *
+ * Merge @a and @b into a new sorted array. An element that appears
+ * N times in @a and M times in @b appears max(N, M) times in the
+ * result, taking the ones from @a first.
+ *
+ * Return: (transfer container) (element-type GObject): A new #GPtrArray
+ *         with the union of @a and @b. It does not own its elements.
+ */
+GPtrArray * g_algorithm_set_union (GPtrArray             *a,
+                                   GPtrArray             *b,
+                                   GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(a != NULL, NULL);
+  g_return_val_if_fail(b != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  GPtrArray *result = g_ptr_array_sized_new (a->len + b->len);
+  size_t i = 0;
+  size_t j = 0;
+
+  while (i < a->len && j < b->len)
+    {
+      int cmp_result = cmp (a->pdata[i], b->pdata[j]);
+
+      if (cmp_result < 0)
+        g_ptr_array_add (result, a->pdata[i++]);
+      else if (cmp_result > 0)
+        g_ptr_array_add (result, b->pdata[j++]);
+      else
+        {
+          g_ptr_array_add (result, a->pdata[i++]);
+          ++j;
+        }
+    }
+
+  while (i < a->len)
+    g_ptr_array_add (result, a->pdata[i++]);
+
+  while (j < b->len)
+    g_ptr_array_add (result, b->pdata[j++]);
+
+  return result;
+}
+
+/**
+ * g_algorithm_set_intersection:
+ * @a: (element-type GObject): A #GPtrArray, sorted according to @cmp.
+ * @b: (element-type GObject): A #GPtrArray, sorted according to @cmp.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc.
+ *
+ * Find the elements of @a that are also in @b. An element that appears
+ * N times in @a and M times in @b appears min(N, M) times in the result.
+ * If one array is much longer than the other, each element of the
+ * shorter one is found in the longer one with an exponential search
+ * instead of walking both.
+ *
+ * Return: (transfer container) (element-type GObject): A new #GPtrArray
+ *         with the intersection of @a and @b, taken from @a. It does not
+ *         own its elements.
+ */
+GPtrArray * g_algorithm_set_intersection (GPtrArray             *a,
+                                          GPtrArray             *b,
+                                          GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(a != NULL, NULL);
+  g_return_val_if_fail(b != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  GPtrArray *result = g_ptr_array_sized_new (MIN (a->len, b->len));
+
+  intersect_into (result, a, b, cmp);
+  return result;
+}
+
+/**
+ * g_algorithm_set_intersection_many:
+ * @arrays: (array length=n_arrays): The #GPtrArray instances to
+ *          intersect, each sorted according to @cmp.
+ * @n_arrays: The number of arrays in @arrays.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc.
+ *
+ * Find the elements that are in all of @arrays. The arrays are
+ * intersected from the shortest to the longest, so that the
+ * intermediate results stay as small as possible and the longer
+ * arrays can be searched exponentially.
+ *
+ * Return: (transfer container) (element-type GObject): A new #GPtrArray
+ *         with the intersection of @arrays, taken from the shortest
+ *         array. It does not own its elements.
+ */
+GPtrArray * g_algorithm_set_intersection_many (GPtrArray             **arrays,
+                                               size_t                  n_arrays,
+                                               GAlgorithmCompareFunc   cmp)
+{
+  g_return_val_if_fail(arrays != NULL || n_arrays == 0, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  if (n_arrays == 0)
+    return g_ptr_array_new ();
+
+  /* Order the arrays by length. There are usually only a handful of
+   * them, so an insertion sort is fine. */
+  g_autofree GPtrArray **by_length = g_new (GPtrArray *, n_arrays);
+
+  for (size_t i = 0; i < n_arrays; ++i)
+    {
+      GPtrArray *array = arrays[i];
+      size_t j = i;
+
+      g_return_val_if_fail(array != NULL, NULL);
+
+      while (j > 0 && by_length[j - 1]->len > array->len)
+        {
+          by_length[j] = by_length[j - 1];
+          --j;
+        }
+
+      by_length[j] = array;
+    }
+
+  GPtrArray *result = g_ptr_array_sized_new (by_length[0]->len);
+
+  for (size_t i = 0; i < by_length[0]->len; ++i)
+    g_ptr_array_add (result, by_length[0]->pdata[i]);
+
+  for (size_t i = 1; i < n_arrays && result->len > 0; ++i)
+    {
+      GPtrArray *next = g_ptr_array_sized_new (result->len);
+
+      intersect_into (next, result, by_length[i], cmp);
+      g_ptr_array_unref (result);
+      result = next;
+    }
+
+  return result;
+}
+
+/**
+ * g_algorithm_set_difference:
+ * @a: (element-type GObject): A #GPtrArray, sorted according to @cmp.
+ * @b: (element-type GObject): A #GPtrArray, sorted according to @cmp.
+ * @cmp: (scope call): A #GAlgorithmCompareFunc.
+ *
+ * Find the elements of @a that are not in @b. An element that appears
+ * N times in @a and M times in @b appears max(N - M, 0) times in the
+ * result.
+ *
+ * Return: (transfer container) (element-type GObject): A new #GPtrArray
+ *         with the difference of @a and @b. It does not own its elements.
+ */
+GPtrArray * g_algorithm_set_difference (GPtrArray             *a,
+                                        GPtrArray             *b,
+                                        GAlgorithmCompareFunc  cmp)
+{
+  g_return_val_if_fail(a != NULL, NULL);
+  g_return_val_if_fail(b != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  GPtrArray *result = g_ptr_array_sized_new (a->len);
+  size_t i = 0;
+  size_t j = 0;
+
+  while (i < a->len && j < b->len)
+    {
+      int cmp_result = cmp (a->pdata[i], b->pdata[j]);
+
+      if (cmp_result < 0)
+        g_ptr_array_add (result, a->pdata[i++]);
+      else if (cmp_result > 0)
+        ++j;
+      else
+        {
+          ++i;
+          ++j;
+        }
+    }
+
+  while (i < a->len)
+    g_ptr_array_add (result, a->pdata[i++]);
+
+  return result;
+}
+
+/**
+ * g_algorithm_set_intersection_uint32:
+ * @a: (element-type guint32): A #GArray of strictly increasing #guint32.
+ * @b: (element-type guint32): A #GArray of strictly increasing #guint32.
+ *
+ * Find the integers that are in both @a and @b, such as the documents
+ * in two posting lists. Compares eight integers of each array against
+ * each other at once on CPUs that support AVX2, or searches the longer
+ * array exponentially if one is much longer than the other.
+ *
+ * Return: (transfer full) (element-type guint32): A new #GArray with the
+ *         intersection of @a and @b.
+ */
+GArray * g_algorithm_set_intersection_uint32 (GArray *a,
+                                              GArray *b)
+{
+  g_return_val_if_fail(a != NULL, NULL);
+  g_return_val_if_fail(b != NULL, NULL);
+  g_return_val_if_fail(g_array_get_element_size (a) == sizeof (guint32), NULL);
+  g_return_val_if_fail(g_array_get_element_size (b) == sizeof (guint32), NULL);
+
+  const guint32 *a_data = (const guint32 *) a->data;
+  const guint32 *b_data = (const guint32 *) b->data;
+  size_t a_len = a->len;
+  size_t b_len = b->len;
+  GArray *result = g_array_sized_new (FALSE, FALSE, sizeof (guint32), MIN (a_len, b_len));
+  size_t n;
+
+  g_array_set_size (result, MIN (a_len, b_len));
+
+  guint32 *out = (guint32 *) result->data;
+
+  if (a_len * GALLOP_RATIO <= b_len)
+    n = intersect_uint32_gallop (a_data, a_len, b_data, b_len, out);
+  else if (b_len * GALLOP_RATIO <= a_len)
+    n = intersect_uint32_gallop (b_data, b_len, a_data, a_len, out);
+#ifdef G_ALGORITHM_HAVE_AVX2_KERNELS
+  else if (g_algorithm_avx2_supported ())
+    n = g_algorithm_avx2_intersect_uint32 (a_data, a_len, b_data, b_len, out);
+#endif
+  else
+    n = intersect_uint32_merge (a_data, a_len, b_data, b_len, out);
+
+  g_array_set_size (result, n);
+  return result;
+}
@@ -0,0 +1,54 @@
+/*
+ * /galgorithm/galgorithm-set-operations.h
+ *
+ * Forward declarations for GAlgorithm Set Operations.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+GPtrArray * g_algorithm_unique (GPtrArray             *array,
+                                GAlgorithmCompareFunc  cmp);
+
+GPtrArray * g_algorithm_set_union (GPtrArray             *a,
+                                   GPtrArray             *b,
+                                   GAlgorithmCompareFunc  cmp);
+
+GPtrArray * g_algorithm_set_intersection (GPtrArray             *a,
+                                          GPtrArray             *b,
+                                          GAlgorithmCompareFunc  cmp);
+
+GPtrArray * g_algorithm_set_intersection_many (GPtrArray             **arrays,
+                                               size_t                  n_arrays,
+                                               GAlgorithmCompareFunc   cmp);
+
+GPtrArray * g_algorithm_set_difference (GPtrArray             *a,
+                                        GPtrArray             *b,
+                                        GAlgorithmCompareFunc  cmp);
+
+GArray * g_algorithm_set_intersection_uint32 (GArray *a,
+                                              GArray *b);
+
+G_END_DECLS
@@ -0,0 +1,44 @@
+/*
+ * /galgorithm/galgorithm-sort-private.h
+ *
+ * Private declarations for the GAlgorithm adaptive sort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+#include <galgorithm/galgorithm-sort.h>
+
+G_BEGIN_DECLS
+
+/* Pick the strategy that g_algorithm_sort() would use for @array
+ * without sorting it. */
+GAlgorithmSortStrategy g_algorithm_sort_choose_strategy (GPtrArray             *array,
+                                                         GAlgorithmCompareFunc  cmp,
+                                                         GAlgorithmSortFlags    flags);
+
+/* Sort @array with @strategy regardless of what it looks like, so
+ * that the benchmarks can compare strategies against each other. */
+GPtrArray * g_algorithm_sort_with_strategy (GPtrArray              *array,
+                                            GAlgorithmCompareFunc   cmp,
+                                            GAlgorithmSortStrategy  strategy);
+
+G_END_DECLS
@@ -0,0 +1,658 @@
+/*
+ * /galgorithm/galgorithm-sort-spec.c
+ *
+ * Implementation for GAlgorithm Sort Specs, declarative descriptions
+ * of an ordering over GObject properties which are evaluated entirely
+ * in native code.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <glib-object.h>
+#include <glib.h>
+
+#include <galgorithm/galgorithm-sort-spec.h>
+
+/* Runs shorter than this are insertion sorted before merging */
+#define SORT_SPEC_INSERTION_RUN 16
+
+typedef struct {
+  const gchar              *property_name;
+  GAlgorithmSortKeyType     key_type;
+  GAlgorithmSortOrder       order;
+  GAlgorithmStringSortMode  collation;
+} SortSpecKey;
+
+typedef union {
+  gint64   i;
+  guint64  u;
+  gdouble  d;
+  gchar   *s;
+} SortKeyValue;
+
+typedef struct {
+  gpointer      element;
+  SortKeyValue *values;
+} SortSpecEntry;
+
+struct _GAlgorithmSortSpec {
+  volatile gint  ref_count;
+  GArray        *keys;
+};
+
+G_DEFINE_BOXED_TYPE (GAlgorithmSortSpec,
+                     g_algorithm_sort_spec,
+                     g_algorithm_sort_spec_ref,
+                     g_algorithm_sort_spec_unref)
+
+static GType
+sort_key_type_to_gtype (GAlgorithmSortKeyType key_type)
+{
+  switch (key_type)
+    {
+      case G_ALGORITHM_SORT_KEY_UINT:
+        return G_TYPE_UINT64;
+      case G_ALGORITHM_SORT_KEY_DOUBLE:
+        return G_TYPE_DOUBLE;
+      case G_ALGORITHM_SORT_KEY_STRING:
+        return G_TYPE_STRING;
+      case G_ALGORITHM_SORT_KEY_INT:
+      default:
+        return G_TYPE_INT64;
+    }
+}
+
+typedef struct {
+  GType        object_type;
+  GParamSpec  *pspec;
+  gboolean     native;
+  GValue       property_value;
+} SortSpecResolvedKey;
+
+/* Whether a property of @property_type can be read straight into a
+ * key of @key_type, without going through g_value_transform(). This
+ * covers the conversions that GLib registers between the numeric
+ * fundamental types, which are plain casts. */
+static gboolean
+sort_key_reads_natively (GAlgorithmSortKeyType key_type,
+                         GType                 property_type)
+{
+  switch (G_TYPE_FUNDAMENTAL (property_type))
+    {
+      case G_TYPE_CHAR:
+      case G_TYPE_UCHAR:
+      case G_TYPE_INT:
+      case G_TYPE_UINT:
+      case G_TYPE_LONG:
+      case G_TYPE_ULONG:
+      case G_TYPE_INT64:
+      case G_TYPE_UINT64:
+      case G_TYPE_FLOAT:
+      case G_TYPE_DOUBLE:
+        return key_type != G_ALGORITHM_SORT_KEY_STRING;
+      case G_TYPE_BOOLEAN:
+      case G_TYPE_ENUM:
+      case G_TYPE_FLAGS:
+        return key_type == G_ALGORITHM_SORT_KEY_INT ||
+               key_type == G_ALGORITHM_SORT_KEY_UINT;
+      case G_TYPE_STRING:
+        return key_type == G_ALGORITHM_SORT_KEY_STRING;
+      default:
+        return FALSE;
+    }
+}
+
+/* Read the numeric @value into @out as a key of @key_type */
+static void
+sort_key_value_read_number (GAlgorithmSortKeyType  key_type,
+                            const GValue          *value,
+                            SortKeyValue          *out)
+{
+  GAlgorithmSortKeyType number_type = G_ALGORITHM_SORT_KEY_INT;
+  SortKeyValue number;
+
+  switch (G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (value)))
+    {
+      case G_TYPE_BOOLEAN:
+        number.i = g_value_get_boolean (value);
+        break;
+      case G_TYPE_CHAR:
+        number.i = g_value_get_schar (value);
+        break;
+      case G_TYPE_INT:
+        number.i = g_value_get_int (value);
+        break;
+      case G_TYPE_LONG:
+        number.i = g_value_get_long (value);
+        break;
+      case G_TYPE_INT64:
+        number.i = g_value_get_int64 (value);
+        break;
+      case G_TYPE_ENUM:
+        number.i = g_value_get_enum (value);
+        break;
+      case G_TYPE_UCHAR:
+        number.u = g_value_get_uchar (value);
+        number_type = G_ALGORITHM_SORT_KEY_UINT;
+        break;
+      case G_TYPE_UINT:
+        number.u = g_value_get_uint (value);
+        number_type = G_ALGORITHM_SORT_KEY_UINT;
+        break;
+      case G_TYPE_ULONG:
+        number.u = g_value_get_ulong (value);
+        number_type = G_ALGORITHM_SORT_KEY_UINT;
+        break;
+      case G_TYPE_UINT64:
+        number.u = g_value_get_uint64 (value);
+        number_type = G_ALGORITHM_SORT_KEY_UINT;
+        break;
+      case G_TYPE_FLAGS:
+        number.u = g_value_get_flags (value);
+        number_type = G_ALGORITHM_SORT_KEY_UINT;
+        break;
+      case G_TYPE_FLOAT:
+        number.d = g_value_get_float (value);
+        number_type = G_ALGORITHM_SORT_KEY_DOUBLE;
+        break;
+      case G_TYPE_DOUBLE:
+        number.d = g_value_get_double (value);
+        number_type = G_ALGORITHM_SORT_KEY_DOUBLE;
+        break;
+      default:
+        g_assert_not_reached ();
+    }
+
+  switch (key_type)
+    {
+      case G_ALGORITHM_SORT_KEY_INT:
+        out->i = number_type == G_ALGORITHM_SORT_KEY_INT ? number.i :
+                 number_type == G_ALGORITHM_SORT_KEY_UINT ? (gint64) number.u :
+                 (gint64) number.d;
+        break;
+      case G_ALGORITHM_SORT_KEY_UINT:
+        out->u = number_type == G_ALGORITHM_SORT_KEY_INT ? (guint64) number.i :
+                 number_type == G_ALGORITHM_SORT_KEY_UINT ? number.u :
+                 (guint64) number.d;
+        break;
+      case G_ALGORITHM_SORT_KEY_DOUBLE:
+        out->d = number_type == G_ALGORITHM_SORT_KEY_INT ? (gdouble) number.i :
+                 number_type == G_ALGORITHM_SORT_KEY_UINT ? (gdouble) number.u :
+                 number.d;
+        break;
+      default:
+        g_assert_not_reached ();
+    }
+}
+
+static gchar *
+sort_key_string_dup (const SortSpecKey *key,
+                     const gchar       *str)
+{
+  if (str == NULL)
+    return NULL;
+  else if (key->collation == G_ALGORITHM_STRING_SORT_COLLATE)
+    return g_utf8_collate_key (str, -1);
+  else if (key->collation == G_ALGORITHM_STRING_SORT_COLLATE_FILENAME)
+    return g_utf8_collate_key_for_filename (str, -1);
+  else
+    return g_strdup (str);
+}
+
+/* Look up the property for @key on the type of @object, so that
+ * reading it from each element of that type needs neither a property
+ * lookup nor a transform lookup. If the property cannot be read as
+ * the requested key type, @resolved is left without a pspec. */
+static void
+sort_spec_key_resolve (const SortSpecKey   *key,
+                       SortSpecResolvedKey *resolved,
+                       GObject             *object)
+{
+  GParamSpec *pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (object),
+                                                    key->property_name);
+
+  resolved->object_type = G_OBJECT_TYPE (object);
+  resolved->pspec = NULL;
+
+  if (G_IS_VALUE (&resolved->property_value))
+    g_value_unset (&resolved->property_value);
+
+  if (pspec == NULL)
+    {
+      g_warning ("%s has no property named '%s' to sort by",
+                 G_OBJECT_TYPE_NAME (object),
+                 key->property_name);
+      return;
+    }
+
+  GType property_type = G_PARAM_SPEC_VALUE_TYPE (pspec);
+  GType key_type = sort_key_type_to_gtype (key->key_type);
+
+  resolved->native = sort_key_reads_natively (key->key_type, property_type);
+
+  if (!resolved->native && !g_value_type_transformable (property_type, key_type))
+    {
+      g_warning ("Cannot sort by property '%s' of type %s as %s",
+                 key->property_name,
+                 g_type_name (property_type),
+                 g_type_name (key_type));
+      return;
+    }
+
+  resolved->pspec = pspec;
+  g_value_init (&resolved->property_value, property_type);
+}
+
+/* Read the property for @key from @object into @out, resolving it
+ * first if @object is of a different type to the last one. If the
+ * property cannot be read as the requested key type, @out is left as
+ * zero (or %NULL, for strings). */
+static void
+sort_spec_key_extract (const SortSpecKey   *key,
+                       SortSpecResolvedKey *resolved,
+                       GObject             *object,
+                       SortKeyValue        *out)
+{
+  memset (out, 0, sizeof (*out));
+
+  if (resolved->object_type != G_OBJECT_TYPE (object))
+    sort_spec_key_resolve (key, resolved, object);
+
+  if (resolved->pspec == NULL)
+    return;
+
+  g_auto(GValue) key_value = G_VALUE_INIT;
+  const GValue *value = &resolved->property_value;
+
+  g_object_get_property (object, resolved->pspec->name, &resolved->property_value);
+
+  if (!resolved->native)
+    {
+      g_value_init (&key_value, sort_key_type_to_gtype (key->key_type));
+      value = &key_value;
+
+      if (!g_value_transform (&resolved->property_value, &key_value))
+        {
+          g_value_reset (&resolved->property_value);
+          return;
+        }
+    }
+
+  if (key->key_type == G_ALGORITHM_SORT_KEY_STRING)
+    out->s = sort_key_string_dup (key, g_value_get_string (value));
+  else
+    sort_key_value_read_number (key->key_type, value, out);
+
+  g_value_reset (&resolved->property_value);
+}
+
+/* Resolved properties are only valid for the duration of one sort or
+ * search, since nothing stops the caller from installing more
+ * properties afterwards. */
+static SortSpecResolvedKey *
+sort_spec_resolved_keys_new (GAlgorithmSortSpec *spec)
+{
+  return g_new0 (SortSpecResolvedKey, MAX (spec->keys->len, 1));
+}
+
+static void
+sort_spec_resolved_keys_free (GAlgorithmSortSpec  *spec,
+                              SortSpecResolvedKey *resolved)
+{
+  for (guint k = 0; k < spec->keys->len; ++k)
+    if (G_IS_VALUE (&resolved[k].property_value))
+      g_value_unset (&resolved[k].property_value);
+
+  g_free (resolved);
+}
+
+static void
+sort_spec_extract (GAlgorithmSortSpec  *spec,
+                   SortSpecResolvedKey *resolved,
+                   GObject             *object,
+                   SortKeyValue        *values)
+{
+  for (guint k = 0; k < spec->keys->len; ++k)
+    sort_spec_key_extract (&g_array_index (spec->keys, SortSpecKey, k),
+                           &resolved[k],
+                           object,
+                           &values[k]);
+}
+
+static void
+sort_spec_values_clear (GAlgorithmSortSpec *spec,
+                        SortKeyValue       *values)
+{
+  for (guint k = 0; k < spec->keys->len; ++k)
+    if (g_array_index (spec->keys, SortSpecKey, k).key_type == G_ALGORITHM_SORT_KEY_STRING)
+      g_free (values[k].s);
+}
+
+static inline int
+sort_key_value_compare (const SortSpecKey  *key,
+                        const SortKeyValue *a,
+                        const SortKeyValue *b)
+{
+  switch (key->key_type)
+    {
+      case G_ALGORITHM_SORT_KEY_INT:
+        return (a->i > b->i) - (a->i < b->i);
+      case G_ALGORITHM_SORT_KEY_UINT:
+        return (a->u > b->u) - (a->u < b->u);
+      case G_ALGORITHM_SORT_KEY_DOUBLE:
+        /* Give NaN a place in the order, otherwise the sort
+         * would not be well defined */
+        if (isnan (a->d) || isnan (b->d))
+          return (isnan (a->d) != 0) - (isnan (b->d) != 0);
+        return (a->d > b->d) - (a->d < b->d);
+      case G_ALGORITHM_SORT_KEY_STRING:
+        if (a->s == NULL || b->s == NULL)
+          return (a->s != NULL) - (b->s != NULL);
+        return strcmp (a->s, b->s);
+      default:
+        g_assert_not_reached ();
+    }
+}
+
+static inline int
+sort_spec_values_compare (GAlgorithmSortSpec *spec,
+                          const SortKeyValue *a,
+                          const SortKeyValue *b)
+{
+  for (guint k = 0; k < spec->keys->len; ++k)
+    {
+      const SortSpecKey *key = &g_array_index (spec->keys, SortSpecKey, k);
+      int result = sort_key_value_compare (key, &a[k], &b[k]);
+
+      if (result != 0)
+        return key->order == G_ALGORITHM_SORT_DESCENDING ? -result : result;
+    }
+
+  return 0;
+}
+
+static void
+sort_spec_insertion_sort (GAlgorithmSortSpec *spec,
+                          SortSpecEntry      *entries,
+                          size_t              len)
+{
+  for (size_t i = 1; i < len; ++i)
+    {
+      SortSpecEntry entry = entries[i];
+      size_t j = i;
+
+      while (j > 0 && sort_spec_values_compare (spec, entries[j - 1].values, entry.values) > 0)
+        {
+          entries[j] = entries[j - 1];
+          --j;
+        }
+
+      entries[j] = entry;
+    }
+}
+
+/* Stable bottom-up merge sort of @entries, which may end up in either
+ * @entries or @scratch. Returns whichever one holds the result. */
+static SortSpecEntry *
+sort_spec_merge_sort (GAlgorithmSortSpec *spec,
+                      SortSpecEntry      *entries,
+                      SortSpecEntry      *scratch,
+                      size_t              len)
+{
+  for (size_t begin = 0; begin < len; begin += SORT_SPEC_INSERTION_RUN)
+    sort_spec_insertion_sort (spec,
+                              &entries[begin],
+                              MIN (SORT_SPEC_INSERTION_RUN, len - begin));
+
+  SortSpecEntry *input = entries;
+  SortSpecEntry *output = scratch;
+
+  for (size_t window = SORT_SPEC_INSERTION_RUN; window < len; window *= 2)
+    {
+      for (size_t begin = 0; begin < len; begin += window * 2)
+        {
+          size_t middle = MIN (begin + window, len);
+          size_t end = MIN (begin + window * 2, len);
+          size_t j = begin;
+          size_t k = middle;
+          size_t p = begin;
+
+          while (j < middle && k < end)
+            {
+              /* Take from the left on ties to stay stable */
+              if (sort_spec_values_compare (spec, input[k].values, input[j].values) < 0)
+                output[p++] = input[k++];
+              else
+                output[p++] = input[j++];
+            }
+
+          while (j < middle)
+            output[p++] = input[j++];
+
+          while (k < end)
+            output[p++] = input[k++];
+        }
+
+      SortSpecEntry *tmp = input;
+      input = output;
+      output = tmp;
+    }
+
+  return input;
+}
+
+/**
+ * g_algorithm_sort_spec_new:
+ *
+ * Create a new, empty #GAlgorithmSortSpec. Add keys to it with
+ * g_algorithm_sort_spec_add_key(). A spec without any keys considers
+ * all elements equal.
+ *
+ * Returns: (transfer full): A new #GAlgorithmSortSpec.
+ */
+GAlgorithmSortSpec *
+g_algorithm_sort_spec_new (void)
+{
+  GAlgorithmSortSpec *spec = g_new0 (GAlgorithmSortSpec, 1);
+
+  spec->ref_count = 1;
+  spec->keys = g_array_new (FALSE, FALSE, sizeof (SortSpecKey));
+
+  return spec;
+}
+
+/**
+ * g_algorithm_sort_spec_ref:
+ * @spec: A #GAlgorithmSortSpec.
+ *
+ * Take a reference on @spec.
+ *
+ * Returns: (transfer full): @spec.
+ */
+GAlgorithmSortSpec *
+g_algorithm_sort_spec_ref (GAlgorithmSortSpec *spec)
+{
+  g_return_val_if_fail(spec != NULL, NULL);
+
+  g_atomic_int_inc (&spec->ref_count);
+  return spec;
+}
+
+/**
+ * g_algorithm_sort_spec_unref:
+ * @spec: (transfer full): A #GAlgorithmSortSpec.
+ *
+ * Release a reference on @spec.
+ */
+void
+g_algorithm_sort_spec_unref (GAlgorithmSortSpec *spec)
+{
+  g_return_if_fail(spec != NULL);
+
+  if (!g_atomic_int_dec_and_test (&spec->ref_count))
+    return;
+
+  g_array_unref (spec->keys);
+  g_free (spec);
+}
+
+/**
+ * g_algorithm_sort_spec_add_key:
+ * @spec: A #GAlgorithmSortSpec.
+ * @property_name: The name of the #GObject property to order by.
+ * @key_type: A #GAlgorithmSortKeyType to compare the property as.
+ * @order: A #GAlgorithmSortOrder.
+ * @collation: A #GAlgorithmStringSortMode for string keys. Ignored for
+ *             other key types.
+ *
+ * Add a key to @spec. Elements that compare equal on all of the keys
+ * added before this one are ordered by this key.
+ */
+void
+g_algorithm_sort_spec_add_key (GAlgorithmSortSpec       *spec,
+                               const char               *property_name,
+                               GAlgorithmSortKeyType     key_type,
+                               GAlgorithmSortOrder       order,
+                               GAlgorithmStringSortMode  collation)
+{
+  g_return_if_fail(spec != NULL);
+  g_return_if_fail(property_name != NULL);
+  g_return_if_fail(key_type <= G_ALGORITHM_SORT_KEY_STRING);
+
+  SortSpecKey key = {
+    .property_name = g_intern_string (property_name),
+    .key_type = key_type,
+    .order = order,
+    .collation = collation
+  };
+
+  g_array_append_val (spec->keys, key);
+}
+
+/**
+ * g_algorithm_sort_by_spec:
+ * @array: (element-type GObject): A #GPtrArray of #GObject
+ * @spec: A #GAlgorithmSortSpec describing the order.
+ *
+ * Do a stable sort on @array in the order described by @spec,
+ * returning a reference to @array.
+ *
+ * The keys of each element are read exactly once and compared
+ * natively, so unlike the sorts that take a #GAlgorithmCompareFunc,
+ * bindings never have to call back into the language runtime while
+ * sorting. Each property is looked up once per element type, not once
+ * per element.
+ *
+ * Return: (transfer none) (element-type GObject): @array, sorted in-place.
+ */
+GPtrArray * g_algorithm_sort_by_spec (GPtrArray          *array,
+                                      GAlgorithmSortSpec *spec)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(spec != NULL, NULL);
+
+  size_t len = array->len;
+  size_t n_keys = spec->keys->len;
+
+  if (len <= 1 || n_keys == 0)
+    return array;
+
+  g_autofree SortKeyValue *values = g_new (SortKeyValue, len * n_keys);
+  g_autofree SortSpecEntry *entries = g_new (SortSpecEntry, len);
+  g_autofree SortSpecEntry *scratch = g_new (SortSpecEntry, len);
+  SortSpecResolvedKey *resolved = sort_spec_resolved_keys_new (spec);
+
+  for (size_t i = 0; i < len; ++i)
+    {
+      entries[i].element = array->pdata[i];
+      entries[i].values = &values[i * n_keys];
+      sort_spec_extract (spec, resolved, G_OBJECT (array->pdata[i]), entries[i].values);
+    }
+
+  sort_spec_resolved_keys_free (spec, resolved);
+
+  SortSpecEntry *sorted = sort_spec_merge_sort (spec, entries, scratch, len);
+
+  for (size_t i = 0; i < len; ++i)
+    array->pdata[i] = sorted[i].element;
+
+  for (size_t i = 0; i < len; ++i)
+    sort_spec_values_clear (spec, &values[i * n_keys]);
+
+  return array;
+}
+
+/**
+ * g_algorithm_binary_search_by_spec:
+ * @array: (element-type GObject): A #GPtrArray of #GObject, sorted in
+ *         the order described by @spec.
+ * @needle: A #GObject with the keys to search for.
+ * @spec: A #GAlgorithmSortSpec describing the order of @array.
+ *
+ * Do a binary search on sorted data for an element whose keys are all
+ * equal to those of @needle. Like g_algorithm_sort_by_spec(), this never
+ * calls back into bindings.
+ *
+ * Return: The index of a matching element in @array on success, -1 on
+ *         failure.
+ */
+int64_t g_algorithm_binary_search_by_spec (GPtrArray          *array,
+                                           GObject            *needle,
+                                           GAlgorithmSortSpec *spec)
+{
+  g_return_val_if_fail(array != NULL, -1);
+  g_return_val_if_fail(G_IS_OBJECT (needle), -1);
+  g_return_val_if_fail(spec != NULL, -1);
+
+  size_t n_keys = spec->keys->len;
+  g_autofree SortKeyValue *needle_values = g_new (SortKeyValue, MAX (n_keys, 1));
+  g_autofree SortKeyValue *probe_values = g_new (SortKeyValue, MAX (n_keys, 1));
+  size_t floor_index = 0;
+  size_t ceil_index = array->len;
+  int64_t found = -1;
+  SortSpecResolvedKey *resolved = sort_spec_resolved_keys_new (spec);
+
+  sort_spec_extract (spec, resolved, needle, needle_values);
+
+  while (floor_index < ceil_index)
+    {
+      size_t midpoint = floor_index + ((ceil_index - floor_index) / 2);
+
+      sort_spec_extract (spec, resolved, G_OBJECT (array->pdata[midpoint]), probe_values);
+      int cmp_result = sort_spec_values_compare (spec, needle_values, probe_values);
+      sort_spec_values_clear (spec, probe_values);
+
+      if (cmp_result == 0)
+        {
+          found = (int64_t) midpoint;
+          break;
+        }
+
+      if (cmp_result > 0)
+        floor_index = midpoint + 1;
+      else
+        ceil_index = midpoint;
+    }
+
+  sort_spec_values_clear (spec, needle_values);
+  sort_spec_resolved_keys_free (spec, resolved);
+
+  return found;
+}
@@ -0,0 +1,93 @@
+/*
+ * /galgorithm/galgorithm-sort-spec.h
+ *
+ * Forward declarations for GAlgorithm Sort Specs.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+#include <glib.h>
+#include <stdint.h>
+
+#include <galgorithm/galgorithm-string-sort.h>
+
+G_BEGIN_DECLS
+
+#define G_ALGORITHM_TYPE_SORT_SPEC (g_algorithm_sort_spec_get_type ())
+
+typedef struct _GAlgorithmSortSpec GAlgorithmSortSpec;
+
+/**
+ * GAlgorithmSortKeyType:
+ * @G_ALGORITHM_SORT_KEY_INT: Order by the property as a signed 64 bit
+ *   integer. Works for signed integer, boolean and enum properties.
+ * @G_ALGORITHM_SORT_KEY_UINT: Order by the property as an unsigned 64 bit
+ *   integer. Works for unsigned integer and flags properties.
+ * @G_ALGORITHM_SORT_KEY_DOUBLE: Order by the property as a #gdouble. NaN
+ *   sorts after every other value.
+ * @G_ALGORITHM_SORT_KEY_STRING: Order by the property as a string. %NULL
+ *   sorts before every other value.
+ *
+ * How the value of a property is compared. The property value is
+ * converted to the key type with g_value_transform().
+ */
+typedef enum {
+  G_ALGORITHM_SORT_KEY_INT,
+  G_ALGORITHM_SORT_KEY_UINT,
+  G_ALGORITHM_SORT_KEY_DOUBLE,
+  G_ALGORITHM_SORT_KEY_STRING
+} GAlgorithmSortKeyType;
+
+/**
+ * GAlgorithmSortOrder:
+ * @G_ALGORITHM_SORT_ASCENDING: Smallest key first.
+ * @G_ALGORITHM_SORT_DESCENDING: Largest key first.
+ *
+ * The direction that a key of a #GAlgorithmSortSpec is ordered in.
+ */
+typedef enum {
+  G_ALGORITHM_SORT_ASCENDING,
+  G_ALGORITHM_SORT_DESCENDING
+} GAlgorithmSortOrder;
+
+GType g_algorithm_sort_spec_get_type (void);
+
+GAlgorithmSortSpec * g_algorithm_sort_spec_new (void);
+
+GAlgorithmSortSpec * g_algorithm_sort_spec_ref (GAlgorithmSortSpec *spec);
+
+void g_algorithm_sort_spec_unref (GAlgorithmSortSpec *spec);
+
+void g_algorithm_sort_spec_add_key (GAlgorithmSortSpec       *spec,
+                                    const char               *property_name,
+                                    GAlgorithmSortKeyType     key_type,
+                                    GAlgorithmSortOrder       order,
+                                    GAlgorithmStringSortMode  collation);
+
+GPtrArray * g_algorithm_sort_by_spec (GPtrArray          *array,
+                                      GAlgorithmSortSpec *spec);
+
+int64_t g_algorithm_binary_search_by_spec (GPtrArray          *array,
+                                           GObject            *needle,
+                                           GAlgorithmSortSpec *spec);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GAlgorithmSortSpec, g_algorithm_sort_spec_unref)
+
+G_END_DECLS
@@ -0,0 +1,642 @@
+/*
+ * /galgorithm/galgorithm-sort.c
+ *
+ * Implementation for the GAlgorithm adaptive sort, which looks at a
+ * small sample of the array to pick a sorting algorithm for it.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-sort.h>
+#include <galgorithm/galgorithm-sort-private.h>
+
+/* The thresholds below were picked with galgorithm-sort-benchmark
+ * on random, presorted, reversed and few-distinct inputs. */
+
+/* Arrays and partitions up to this size are insertion sorted */
+#define SORT_INSERTION_THRESHOLD 24
+
+/* If fewer than 1 in this many sampled neighbours are out of order
+ * (or in order), the array is treated as presorted */
+#define SORT_PRESORTED_DIVISOR 16
+
+/* If at least 1 in this many neighbours of the sorted sample are
+ * equal, the array is treated as having many duplicates */
+#define SORT_DUPLICATE_DIVISOR 8
+
+static inline void
+swap_elements (gpointer *data, size_t i, size_t j)
+{
+  gpointer tmp = data[i];
+  data[i] = data[j];
+  data[j] = tmp;
+}
+
+static void
+reverse_elements (gpointer *data, size_t begin, size_t end)
+{
+  while (begin + 1 < end)
+    swap_elements (data, begin++, --end);
+}
+
+static void
+insertion_sort (gpointer              *data,
+                size_t                 len,
+                GAlgorithmCompareFunc  cmp)
+{
+  for (size_t i = 1; i < len; ++i)
+    {
+      gpointer element = data[i];
+      size_t j = i;
+
+      while (j > 0 && cmp (data[j - 1], element) > 0)
+        {
+          data[j] = data[j - 1];
+          --j;
+        }
+
+      data[j] = element;
+    }
+}
+
+static void
+sift_down (gpointer              *data,
+           size_t                 root,
+           size_t                 len,
+           GAlgorithmCompareFunc  cmp)
+{
+  for (;;)
+    {
+      size_t child = root * 2 + 1;
+
+      if (child >= len)
+        return;
+
+      if (child + 1 < len && cmp (data[child], data[child + 1]) < 0)
+        ++child;
+
+      if (cmp (data[root], data[child]) >= 0)
+        return;
+
+      swap_elements (data, root, child);
+      root = child;
+    }
+}
+
+static void
+heap_sort (gpointer              *data,
+           size_t                 len,
+           GAlgorithmCompareFunc  cmp)
+{
+  for (size_t i = len / 2; i > 0; --i)
+    sift_down (data, i - 1, len, cmp);
+
+  for (size_t end = len; end > 1; --end)
+    {
+      swap_elements (data, 0, end - 1);
+      sift_down (data, 0, end - 1, cmp);
+    }
+}
+
+/* Move the median of the first, middle and last elements to the
+ * front, to be used as the pivot */
+static void
+median_of_three_to_front (gpointer              *data,
+                          size_t                 len,
+                          GAlgorithmCompareFunc  cmp)
+{
+  size_t middle = len / 2;
+  size_t last = len - 1;
+
+  if (cmp (data[middle], data[0]) < 0)
+    swap_elements (data, middle, 0);
+  if (cmp (data[last], data[middle]) < 0)
+    {
+      swap_elements (data, last, middle);
+      if (cmp (data[middle], data[0]) < 0)
+        swap_elements (data, middle, 0);
+    }
+
+  swap_elements (data, 0, middle);
+}
+
+static void
+introsort_loop (gpointer              *data,
+                size_t                 len,
+                GAlgorithmCompareFunc  cmp,
+                guint                  depth_limit)
+{
+  while (len > SORT_INSERTION_THRESHOLD)
+    {
+      if (depth_limit-- == 0)
+        {
+          heap_sort (data, len, cmp);
+          return;
+        }
+
+      median_of_three_to_front (data, len, cmp);
+
+      /* Hoare partition. Both scans stop on elements equal to the
+       * pivot, which keeps the partitions balanced on duplicates. */
+      gpointer pivot = data[0];
+      size_t i = 0;
+      size_t j = len;
+
+      for (;;)
+        {
+          do
+            ++i;
+          while (i < len && cmp (data[i], pivot) < 0);
+
+          do
+            --j;
+          while (cmp (data[j], pivot) > 0);
+
+          if (i >= j)
+            break;
+
+          swap_elements (data, i, j);
+        }
+
+      swap_elements (data, 0, j);
+
+      /* Recurse into the smaller side, so that the stack stays
+       * O(log N) deep */
+      if (j < len - j - 1)
+        {
+          introsort_loop (data, j, cmp, depth_limit);
+          data += j + 1;
+          len -= j + 1;
+        }
+      else
+        {
+          introsort_loop (data + j + 1, len - j - 1, cmp, depth_limit);
+          len = j;
+        }
+    }
+
+  insertion_sort (data, len, cmp);
+}
+
+static void
+three_way_quicksort_loop (gpointer              *data,
+                          size_t                 len,
+                          GAlgorithmCompareFunc  cmp,
+                          guint                  depth_limit)
+{
+  while (len > SORT_INSERTION_THRESHOLD)
+    {
+      if (depth_limit-- == 0)
+        {
+          heap_sort (data, len, cmp);
+          return;
+        }
+
+      median_of_three_to_front (data, len, cmp);
+
+      /* Dijkstra partition into [0, lt) < pivot, [lt, gt) == pivot
+       * and [gt, len) > pivot. Runs of duplicates are done as soon
+       * as they land in the middle. */
+      gpointer pivot = data[0];
+      size_t lt = 0;
+      size_t gt = len;
+      size_t i = 0;
+
+      while (i < gt)
+        {
+          int cmp_result = cmp (data[i], pivot);
+
+          if (cmp_result < 0)
+            swap_elements (data, lt++, i++);
+          else if (cmp_result > 0)
+            swap_elements (data, i, --gt);
+          else
+            ++i;
+        }
+
+      if (lt < len - gt)
+        {
+          three_way_quicksort_loop (data, lt, cmp, depth_limit);
+          data += gt;
+          len -= gt;
+        }
+      else
+        {
+          three_way_quicksort_loop (data + gt, len - gt, cmp, depth_limit);
+          len = lt;
+        }
+    }
+
+  insertion_sort (data, len, cmp);
+}
+
+static guint
+depth_limit_for (size_t len)
+{
+  return 2 * g_bit_storage (len);
+}
+
+/* Merge the sorted runs [begin, middle) and [middle, end), copying
+ * only the left run out to @scratch */
+static void
+merge_runs (gpointer              *data,
+            gpointer              *scratch,
+            size_t                 begin,
+            size_t                 middle,
+            size_t                 end,
+            GAlgorithmCompareFunc  cmp)
+{
+  /* Already in order, which is common on presorted input */
+  if (cmp (data[middle - 1], data[middle]) <= 0)
+    return;
+
+  size_t left_len = middle - begin;
+  size_t j = 0;
+  size_t k = middle;
+  size_t p = begin;
+
+  memcpy (scratch, &data[begin], left_len * sizeof (gpointer));
+
+  while (j < left_len && k < end)
+    {
+      /* Take from the left on ties to stay stable */
+      if (cmp (data[k], scratch[j]) < 0)
+        data[p++] = data[k++];
+      else
+        data[p++] = scratch[j++];
+    }
+
+  /* Anything left on the right is already in place */
+  while (j < left_len)
+    data[p++] = scratch[j++];
+}
+
+static void
+run_merge_sort (gpointer              *data,
+                size_t                 len,
+                GAlgorithmCompareFunc  cmp)
+{
+  g_autoptr(GArray) run_ends = g_array_new (FALSE, FALSE, sizeof (size_t));
+
+  /* Find the runs, reversing strictly descending ones (which keeps
+   * them stable) and extending short ones with insertion sort */
+  for (size_t begin = 0; begin < len;)
+    {
+      size_t end = begin + 1;
+
+      if (end < len && cmp (data[end], data[begin]) < 0)
+        {
+          while (end < len && cmp (data[end], data[end - 1]) < 0)
+            ++end;
+
+          reverse_elements (data, begin, end);
+        }
+      else
+        {
+          while (end < len && cmp (data[end], data[end - 1]) >= 0)
+            ++end;
+        }
+
+      if (end - begin < SORT_INSERTION_THRESHOLD)
+        {
+          end = MIN (begin + SORT_INSERTION_THRESHOLD, len);
+          insertion_sort (&data[begin], end - begin, cmp);
+        }
+
+      g_array_append_val (run_ends, end);
+      begin = end;
+    }
+
+  g_autofree gpointer *scratch = g_new (gpointer, len);
+
+  /* Merge neighbouring runs until there is only one left */
+  while (run_ends->len > 1)
+    {
+      size_t *ends = (size_t *) run_ends->data;
+      guint n_merged = 0;
+      size_t begin = 0;
+
+      for (guint r = 0; r < run_ends->len; r += 2)
+        {
+          if (r + 1 < run_ends->len)
+            {
+              merge_runs (data, scratch, begin, ends[r], ends[r + 1], cmp);
+              ends[n_merged++] = ends[r + 1];
+            }
+          else
+            ends[n_merged++] = ends[r];
+
+          begin = ends[n_merged - 1];
+        }
+
+      g_array_set_size (run_ends, n_merged);
+    }
+}
+
+static size_t
+lower_bound (gpointer              *data,
+             size_t                 begin,
+             size_t                 end,
+             gconstpointer          needle,
+             GAlgorithmCompareFunc  cmp)
+{
+  while (begin < end)
+    {
+      size_t midpoint = begin + ((end - begin) / 2);
+
+      if (cmp (data[midpoint], needle) < 0)
+        begin = midpoint + 1;
+      else
+        end = midpoint;
+    }
+
+  return begin;
+}
+
+static size_t
+upper_bound (gpointer              *data,
+             size_t                 begin,
+             size_t                 end,
+             gconstpointer          needle,
+             GAlgorithmCompareFunc  cmp)
+{
+  while (begin < end)
+    {
+      size_t midpoint = begin + ((end - begin) / 2);
+
+      if (cmp (needle, data[midpoint]) < 0)
+        end = midpoint;
+      else
+        begin = midpoint + 1;
+    }
+
+  return begin;
+}
+
+/* Swap the blocks [begin, middle) and [middle, end) */
+static void
+rotate_elements (gpointer *data, size_t begin, size_t middle, size_t end)
+{
+  reverse_elements (data, begin, middle);
+  reverse_elements (data, middle, end);
+  reverse_elements (data, begin, end);
+}
+
+/* Stable merge of [begin, middle) and [middle, end) without a buffer.
+ * Split the longer run in half, find where its middle element goes in
+ * the other run, rotate the two inner blocks past each other and
+ * merge both halves. */
+static void
+merge_runs_in_place (gpointer              *data,
+                     size_t                 begin,
+                     size_t                 middle,
+                     size_t                 end,
+                     GAlgorithmCompareFunc  cmp)
+{
+  size_t left_len = middle - begin;
+  size_t right_len = end - middle;
+
+  if (left_len == 0 || right_len == 0)
+    return;
+
+  if (cmp (data[middle - 1], data[middle]) <= 0)
+    return;
+
+  if (left_len + right_len == 2)
+    {
+      swap_elements (data, begin, middle);
+      return;
+    }
+
+  size_t left_cut;
+  size_t right_cut;
+
+  if (left_len > right_len)
+    {
+      left_cut = begin + left_len / 2;
+      right_cut = lower_bound (data, middle, end, data[left_cut], cmp);
+    }
+  else
+    {
+      right_cut = middle + right_len / 2;
+      left_cut = upper_bound (data, begin, middle, data[right_cut], cmp);
+    }
+
+  rotate_elements (data, left_cut, middle, right_cut);
+
+  size_t new_middle = left_cut + (right_cut - middle);
+
+  merge_runs_in_place (data, begin, left_cut, new_middle, cmp);
+  merge_runs_in_place (data, new_middle, right_cut, end, cmp);
+}
+
+static void
+in_place_merge_sort (gpointer              *data,
+                     size_t                 len,
+                     GAlgorithmCompareFunc  cmp)
+{
+  for (size_t begin = 0; begin < len; begin += SORT_INSERTION_THRESHOLD)
+    insertion_sort (&data[begin], MIN (SORT_INSERTION_THRESHOLD, len - begin), cmp);
+
+  for (size_t window = SORT_INSERTION_THRESHOLD; window < len; window *= 2)
+    for (size_t begin = 0; begin + window < len; begin += window * 2)
+      merge_runs_in_place (data,
+                           begin,
+                           begin + window,
+                           MIN (begin + window * 2, len),
+                           cmp);
+}
+
+static GAlgorithmSortStrategy
+choose_strategy (gpointer              *data,
+                 size_t                 len,
+                 GAlgorithmCompareFunc  cmp,
+                 GAlgorithmSortFlags    flags)
+{
+  if (len <= SORT_INSERTION_THRESHOLD)
+    return G_ALGORITHM_SORT_STRATEGY_INSERTION;
+
+  if (flags & G_ALGORITHM_SORT_FLAGS_STABLE)
+    return (flags & G_ALGORITHM_SORT_FLAGS_IN_PLACE) ?
+           G_ALGORITHM_SORT_STRATEGY_IN_PLACE_MERGE :
+           G_ALGORITHM_SORT_STRATEGY_RUN_MERGE;
+
+  /* Look at about √N evenly spaced pairs of neighbours. This is cheap
+   * next to the sort itself, but enough to see whether the array is
+   * mostly presorted and whether it has lots of duplicates. */
+  size_t n_samples = MAX ((size_t) 1 << (g_bit_storage (len) / 2), 2);
+  size_t stride = len / n_samples;
+  size_t descents = 0;
+  size_t ascents = 0;
+  g_autofree gpointer *sample = g_new (gpointer, n_samples);
+
+  for (size_t s = 0; s < n_samples; ++s)
+    {
+      size_t i = s * stride;
+      int cmp_result = cmp (data[i], data[i + 1]);
+
+      descents += cmp_result > 0;
+      ascents += cmp_result < 0;
+      sample[s] = data[i];
+    }
+
+  if ((descents * SORT_PRESORTED_DIVISOR <= n_samples ||
+       ascents * SORT_PRESORTED_DIVISOR <= n_samples) &&
+      !(flags & G_ALGORITHM_SORT_FLAGS_IN_PLACE))
+    return G_ALGORITHM_SORT_STRATEGY_RUN_MERGE;
+
+  size_t duplicates = 0;
+
+  introsort_loop (sample, n_samples, cmp, depth_limit_for (n_samples));
+
+  for (size_t s = 1; s < n_samples; ++s)
+    duplicates += cmp (sample[s - 1], sample[s]) == 0;
+
+  if (duplicates * SORT_DUPLICATE_DIVISOR >= n_samples)
+    return G_ALGORITHM_SORT_STRATEGY_THREE_WAY_QUICKSORT;
+
+  return G_ALGORITHM_SORT_STRATEGY_INTROSORT;
+}
+
+GAlgorithmSortStrategy
+g_algorithm_sort_choose_strategy (GPtrArray             *array,
+                                  GAlgorithmCompareFunc  cmp,
+                                  GAlgorithmSortFlags    flags)
+{
+  g_return_val_if_fail(array != NULL, G_ALGORITHM_SORT_STRATEGY_INSERTION);
+  g_return_val_if_fail(cmp != NULL, G_ALGORITHM_SORT_STRATEGY_INSERTION);
+
+  return choose_strategy (array->pdata, array->len, cmp, flags);
+}
+
+GPtrArray *
+g_algorithm_sort_with_strategy (GPtrArray              *array,
+                                GAlgorithmCompareFunc   cmp,
+                                GAlgorithmSortStrategy  strategy)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  gpointer *data = array->pdata;
+  size_t len = array->len;
+
+  switch (strategy)
+    {
+      case G_ALGORITHM_SORT_STRATEGY_INSERTION:
+        insertion_sort (data, len, cmp);
+        break;
+      case G_ALGORITHM_SORT_STRATEGY_RUN_MERGE:
+        run_merge_sort (data, len, cmp);
+        break;
+      case G_ALGORITHM_SORT_STRATEGY_IN_PLACE_MERGE:
+        in_place_merge_sort (data, len, cmp);
+        break;
+      case G_ALGORITHM_SORT_STRATEGY_INTROSORT:
+        introsort_loop (data, len, cmp, depth_limit_for (len));
+        break;
+      case G_ALGORITHM_SORT_STRATEGY_THREE_WAY_QUICKSORT:
+        three_way_quicksort_loop (data, len, cmp, depth_limit_for (len));
+        break;
+      default:
+        g_assert_not_reached ();
+    }
+
+  return array;
+}
+
+/**
+ * g_algorithm_sort_strategy_get_name:
+ * @strategy: A #GAlgorithmSortStrategy.
+ *
+ * Get a short name for @strategy, for logging and diagnostics.
+ *
+ * Returns: (transfer none): The name of @strategy.
+ */
+const char *
+g_algorithm_sort_strategy_get_name (GAlgorithmSortStrategy strategy)
+{
+  switch (strategy)
+    {
+      case G_ALGORITHM_SORT_STRATEGY_INSERTION:
+        return "insertion";
+      case G_ALGORITHM_SORT_STRATEGY_RUN_MERGE:
+        return "run-merge";
+      case G_ALGORITHM_SORT_STRATEGY_IN_PLACE_MERGE:
+        return "in-place-merge";
+      case G_ALGORITHM_SORT_STRATEGY_INTROSORT:
+        return "introsort";
+      case G_ALGORITHM_SORT_STRATEGY_THREE_WAY_QUICKSORT:
+        return "three-way-quicksort";
+      default:
+        g_return_val_if_reached (NULL);
+    }
+}
+
+/**
+ * g_algorithm_sort:
+ * @array: (element-type GObject): A #GPtrArray
+ * @cmp: (scope call): A #GAlgorithmCompareFunc.
+ * @flags: #GAlgorithmSortFlags constraining the algorithm.
+ *
+ * Sort @array, picking an algorithm for it that satisfies @flags,
+ * returning a reference to @array. See g_algorithm_sort_full().
+ *
+ * Return: (transfer none) (element-type GObject): @array, sorted in-place.
+ */
+GPtrArray * g_algorithm_sort (GPtrArray             *array,
+                              GAlgorithmCompareFunc  cmp,
+                              GAlgorithmSortFlags    flags)
+{
+  return g_algorithm_sort_full (array, cmp, flags, NULL);
+}
+
+/**
+ * g_algorithm_sort_full:
+ * @array: (element-type GObject): A #GPtrArray
+ * @cmp: (scope call): A #GAlgorithmCompareFunc.
+ * @flags: #GAlgorithmSortFlags constraining the algorithm.
+ * @out_strategy: (out) (optional): Return location for the
+ *                #GAlgorithmSortStrategy that was used.
+ *
+ * Sort @array, returning a reference to @array. Small arrays are
+ * insertion sorted. Otherwise, about √N neighbouring pairs of elements
+ * are sampled: mostly presorted arrays get a merge sort over their
+ * existing runs, arrays with many duplicates get a three-way
+ * quicksort and everything else gets an introsort. Stable sorts
+ * always merge.
+ *
+ * Return: (transfer none) (element-type GObject): @array, sorted in-place.
+ */
+GPtrArray * g_algorithm_sort_full (GPtrArray              *array,
+                                   GAlgorithmCompareFunc   cmp,
+                                   GAlgorithmSortFlags     flags,
+                                   GAlgorithmSortStrategy *out_strategy)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  GAlgorithmSortStrategy strategy = choose_strategy (array->pdata, array->len, cmp, flags);
+
+  if (out_strategy != NULL)
+    *out_strategy = strategy;
+
+  return g_algorithm_sort_with_strategy (array, cmp, strategy);
+}
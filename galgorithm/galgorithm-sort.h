@@ -0,0 +1,84 @@
+/*
+ * /galgorithm/galgorithm-sort.h
+ *
+ * Forward declarations for the GAlgorithm adaptive sort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+/**
+ * GAlgorithmSortFlags:
+ * @G_ALGORITHM_SORT_FLAGS_NONE: No constraints.
+ * @G_ALGORITHM_SORT_FLAGS_STABLE: Elements that compare equal must keep
+ *   their relative order.
+ * @G_ALGORITHM_SORT_FLAGS_IN_PLACE: The sort must not allocate memory
+ *   proportional to the size of the array.
+ *
+ * Constraints on the algorithm that g_algorithm_sort() may pick.
+ */
+typedef enum {
+  G_ALGORITHM_SORT_FLAGS_NONE = 0,
+  G_ALGORITHM_SORT_FLAGS_STABLE = 1 << 0,
+  G_ALGORITHM_SORT_FLAGS_IN_PLACE = 1 << 1
+} GAlgorithmSortFlags;
+
+/**
+ * GAlgorithmSortStrategy:
+ * @G_ALGORITHM_SORT_STRATEGY_INSERTION: Insertion sort, for small arrays.
+ *   Stable and in-place.
+ * @G_ALGORITHM_SORT_STRATEGY_RUN_MERGE: Merge sort over the ascending and
+ *   descending runs already in the array, for presorted arrays. Stable.
+ * @G_ALGORITHM_SORT_STRATEGY_IN_PLACE_MERGE: Merge sort that merges by
+ *   rotating instead of through a buffer. Stable and in-place, but does
+ *   O(N log² N) moves.
+ * @G_ALGORITHM_SORT_STRATEGY_INTROSORT: Quicksort that falls back to
+ *   heapsort if the partitions become unbalanced. In-place.
+ * @G_ALGORITHM_SORT_STRATEGY_THREE_WAY_QUICKSORT: Quicksort that
+ *   partitions into less than, equal to and greater than the pivot,
+ *   for arrays with many duplicates. In-place.
+ *
+ * The algorithm that g_algorithm_sort() picked for an array.
+ */
+typedef enum {
+  G_ALGORITHM_SORT_STRATEGY_INSERTION,
+  G_ALGORITHM_SORT_STRATEGY_RUN_MERGE,
+  G_ALGORITHM_SORT_STRATEGY_IN_PLACE_MERGE,
+  G_ALGORITHM_SORT_STRATEGY_INTROSORT,
+  G_ALGORITHM_SORT_STRATEGY_THREE_WAY_QUICKSORT
+} GAlgorithmSortStrategy;
+
+const char * g_algorithm_sort_strategy_get_name (GAlgorithmSortStrategy strategy);
+
+GPtrArray * g_algorithm_sort (GPtrArray             *array,
+                              GAlgorithmCompareFunc  cmp,
+                              GAlgorithmSortFlags    flags);
+
+GPtrArray * g_algorithm_sort_full (GPtrArray              *array,
+                                   GAlgorithmCompareFunc   cmp,
+                                   GAlgorithmSortFlags     flags,
+                                   GAlgorithmSortStrategy *out_strategy);
+
+G_END_DECLS
@@ -0,0 +1,549 @@
+/*
+ * /galgorithm/galgorithm-sorted-container.c
+ *
+ * Implementation for GAlgorithm Sorted Container, a log-structured
+ * sorted multiset. Inserts run in amortized O(log N) time and lookups
+ * in O(log^2 N) time.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include <glib-object.h>
+#include <glib.h>
+
+#include <galgorithm/galgorithm-binary-search.h>
+#include <galgorithm/galgorithm-sorted-container.h>
+
+/* New elements are kept in a small sorted buffer until it holds this
+ * many, at which point the buffer becomes a new level */
+#define DELTA_CAPACITY 64
+
+/* A sorted run of elements. Removed elements stay where they are as
+ * tombstones until the level is next merged, since the ordering of the
+ * level still depends on them. */
+typedef struct {
+  GPtrArray *elements;
+  guint8    *dead;
+  size_t     n_dead;
+} SortedLevel;
+
+/* levels is laid out like a binary counter. Level i is either empty or
+ * holds roughly DELTA_CAPACITY << i elements. Flushing the delta carries
+ * it up through the occupied levels, merging as it goes, so each element
+ * gets merged O(log N) times over its lifetime. */
+struct _GAlgorithmSortedContainer {
+  volatile gint          ref_count;
+  GAlgorithmCompareFunc  cmp;
+  GDestroyNotify         element_free;
+  GPtrArray             *delta;
+  GArray                *levels;
+  size_t                 length;
+};
+
+G_DEFINE_BOXED_TYPE (GAlgorithmSortedContainer,
+                     g_algorithm_sorted_container,
+                     g_algorithm_sorted_container_ref,
+                     g_algorithm_sorted_container_unref)
+
+static inline gboolean
+sorted_level_is_dead (const SortedLevel *level, size_t index)
+{
+  return level->dead != NULL && level->dead[index];
+}
+
+static void
+sorted_level_clear (SortedLevel    *level,
+                    GDestroyNotify  element_free)
+{
+  if (level->elements == NULL)
+    return;
+
+  if (element_free != NULL)
+    g_ptr_array_foreach (level->elements, (GFunc) element_free, NULL);
+
+  g_clear_pointer (&level->elements, g_ptr_array_unref);
+  g_clear_pointer (&level->dead, g_free);
+  level->n_dead = 0;
+}
+
+/* Drop the tombstones from @level, freeing the elements behind them */
+static void
+sorted_level_drop_dead (SortedLevel    *level,
+                        GDestroyNotify  element_free)
+{
+  size_t write_index = 0;
+
+  for (size_t i = 0; i < level->elements->len; ++i)
+    {
+      gpointer element = level->elements->pdata[i];
+
+      if (!sorted_level_is_dead (level, i))
+        level->elements->pdata[write_index++] = element;
+      else if (element_free != NULL)
+        element_free (element);
+    }
+
+  g_ptr_array_set_size (level->elements, write_index);
+  g_clear_pointer (&level->dead, g_free);
+  level->n_dead = 0;
+}
+
+/* Merge @newer and @older into a new run of live elements, freeing
+ * any tombstones on the way. Both levels are emptied. */
+static SortedLevel
+sorted_level_merge (SortedLevel           *newer,
+                    SortedLevel           *older,
+                    GAlgorithmCompareFunc  cmp,
+                    GDestroyNotify         element_free)
+{
+  sorted_level_drop_dead (newer, element_free);
+  sorted_level_drop_dead (older, element_free);
+
+  GPtrArray *a = newer->elements;
+  GPtrArray *b = older->elements;
+  GPtrArray *merged = g_ptr_array_sized_new (a->len + b->len);
+  size_t i = 0;
+  size_t j = 0;
+
+  while (i < a->len && j < b->len)
+    {
+      if (cmp (b->pdata[j], a->pdata[i]) < 0)
+        g_ptr_array_add (merged, b->pdata[j++]);
+      else
+        g_ptr_array_add (merged, a->pdata[i++]);
+    }
+
+  while (i < a->len)
+    g_ptr_array_add (merged, a->pdata[i++]);
+
+  while (j < b->len)
+    g_ptr_array_add (merged, b->pdata[j++]);
+
+  g_clear_pointer (&newer->elements, g_ptr_array_unref);
+  g_clear_pointer (&older->elements, g_ptr_array_unref);
+
+  return (SortedLevel) { merged, NULL, 0 };
+}
+
+/* Find a live element in @level comparing equal to @element. The binary
+ * search may land on a tombstone, in which case the equal neighbours
+ * on both sides are checked too. */
+static int64_t
+sorted_level_find_live (const SortedLevel     *level,
+                        gconstpointer          element,
+                        GAlgorithmCompareFunc  cmp)
+{
+  GPtrArray *elements = level->elements;
+  int64_t index = g_algorithm_binary_search (elements, (gpointer) element, cmp);
+
+  if (index < 0 || !sorted_level_is_dead (level, index))
+    return index;
+
+  for (int64_t i = index - 1; i >= 0 && cmp (element, elements->pdata[i]) == 0; --i)
+    if (!sorted_level_is_dead (level, i))
+      return i;
+
+  for (int64_t i = index + 1; i < elements->len && cmp (element, elements->pdata[i]) == 0; ++i)
+    if (!sorted_level_is_dead (level, i))
+      return i;
+
+  return -1;
+}
+
+/* Find where @element would go in the delta, after any equal elements */
+static size_t
+sorted_container_delta_upper_bound (GAlgorithmSortedContainer *container,
+                                    gconstpointer              element)
+{
+  size_t floor_index = 0;
+  size_t ceil_index = container->delta->len;
+
+  while (floor_index < ceil_index)
+    {
+      size_t midpoint = floor_index + ((ceil_index - floor_index) / 2);
+
+      if (container->cmp (element, container->delta->pdata[midpoint]) < 0)
+        ceil_index = midpoint;
+      else
+        floor_index = midpoint + 1;
+    }
+
+  return floor_index;
+}
+
+/* Place @carry in the first empty level, merging it with every
+ * occupied level below that */
+static void
+sorted_container_carry (GAlgorithmSortedContainer *container,
+                        SortedLevel                carry,
+                        guint                      first_level)
+{
+  for (guint i = first_level; ; ++i)
+    {
+      if (i >= container->levels->len)
+        g_array_set_size (container->levels, i + 1);
+
+      SortedLevel *level = &g_array_index (container->levels, SortedLevel, i);
+
+      if (level->elements == NULL)
+        {
+          *level = carry;
+          return;
+        }
+
+      carry = sorted_level_merge (&carry, level, container->cmp, container->element_free);
+    }
+}
+
+static void
+sorted_container_flush_delta (GAlgorithmSortedContainer *container)
+{
+  SortedLevel carry = { container->delta, NULL, 0 };
+
+  container->delta = g_ptr_array_sized_new (DELTA_CAPACITY);
+  sorted_container_carry (container, carry, 0);
+}
+
+/**
+ * g_algorithm_sorted_container_new:
+ * @cmp: (scope forever): A #GAlgorithmCompareFunc to order the elements.
+ * @element_free: (nullable): A #GDestroyNotify to free elements with when
+ *                they are removed or the container is freed.
+ *
+ * Create a new, empty sorted container. The container is a multiset:
+ * several elements comparing equal may be inserted, and each removal
+ * takes away one of them.
+ *
+ * Inserts go into a small sorted buffer which is periodically merged
+ * into a series of sorted levels of geometrically increasing size, in
+ * the style of a log-structured merge tree. This makes inserting N
+ * elements cost O(N log N) overall, rather than the O(N^2) of keeping
+ * a single #GPtrArray sorted on every insert.
+ *
+ * Returns: (transfer full): A new #GAlgorithmSortedContainer.
+ */
+GAlgorithmSortedContainer *
+g_algorithm_sorted_container_new (GAlgorithmCompareFunc cmp,
+                                  GDestroyNotify        element_free)
+{
+  g_return_val_if_fail(cmp != NULL, NULL);
+
+  GAlgorithmSortedContainer *container = g_new0 (GAlgorithmSortedContainer, 1);
+
+  container->ref_count = 1;
+  container->cmp = cmp;
+  container->element_free = element_free;
+  container->delta = g_ptr_array_sized_new (DELTA_CAPACITY);
+  container->levels = g_array_new (FALSE, TRUE, sizeof (SortedLevel));
+  container->length = 0;
+
+  return container;
+}
+
+/**
+ * g_algorithm_sorted_container_ref:
+ * @container: A #GAlgorithmSortedContainer.
+ *
+ * Take a reference on @container.
+ *
+ * Returns: (transfer full): @container.
+ */
+GAlgorithmSortedContainer *
+g_algorithm_sorted_container_ref (GAlgorithmSortedContainer *container)
+{
+  g_return_val_if_fail(container != NULL, NULL);
+
+  g_atomic_int_inc (&container->ref_count);
+  return container;
+}
+
+/**
+ * g_algorithm_sorted_container_unref:
+ * @container: (transfer full): A #GAlgorithmSortedContainer.
+ *
+ * Release a reference on @container. When the last reference is
+ * released, every element still held is freed, including removed
+ * elements that were not yet compacted away.
+ */
+void
+g_algorithm_sorted_container_unref (GAlgorithmSortedContainer *container)
+{
+  g_return_if_fail(container != NULL);
+
+  if (!g_atomic_int_dec_and_test (&container->ref_count))
+    return;
+
+  if (container->element_free != NULL)
+    g_ptr_array_foreach (container->delta, (GFunc) container->element_free, NULL);
+
+  for (guint i = 0; i < container->levels->len; ++i)
+    sorted_level_clear (&g_array_index (container->levels, SortedLevel, i),
+                        container->element_free);
+
+  g_ptr_array_unref (container->delta);
+  g_array_unref (container->levels);
+  g_free (container);
+}
+
+/**
+ * g_algorithm_sorted_container_insert:
+ * @container: A #GAlgorithmSortedContainer.
+ * @element: (transfer full): The element to insert.
+ *
+ * Insert @element into @container. Elements comparing equal to
+ * @element that are already in @container are kept.
+ */
+void
+g_algorithm_sorted_container_insert (GAlgorithmSortedContainer *container,
+                                     gpointer                   element)
+{
+  g_return_if_fail(container != NULL);
+
+  g_ptr_array_insert (container->delta,
+                      sorted_container_delta_upper_bound (container, element),
+                      element);
+  container->length++;
+
+  if (container->delta->len >= DELTA_CAPACITY)
+    sorted_container_flush_delta (container);
+}
+
+/**
+ * g_algorithm_sorted_container_remove:
+ * @container: A #GAlgorithmSortedContainer.
+ * @element: An element comparing equal to the one to remove.
+ *
+ * Remove one element comparing equal to @element from @container.
+ *
+ * Elements that already made it into a level are only marked as
+ * removed and are freed with the element free function when that level
+ * is next merged, or once more than half of the level is removed.
+ *
+ * Returns: %TRUE if an element was removed, %FALSE if there was none.
+ */
+gboolean
+g_algorithm_sorted_container_remove (GAlgorithmSortedContainer *container,
+                                     gconstpointer              element)
+{
+  g_return_val_if_fail(container != NULL, FALSE);
+
+  int64_t index = g_algorithm_binary_search (container->delta, (gpointer) element, container->cmp);
+
+  if (index >= 0)
+    {
+      gpointer removed = g_ptr_array_remove_index (container->delta, index);
+
+      if (container->element_free != NULL)
+        container->element_free (removed);
+
+      container->length--;
+      return TRUE;
+    }
+
+  for (guint i = 0; i < container->levels->len; ++i)
+    {
+      SortedLevel *level = &g_array_index (container->levels, SortedLevel, i);
+
+      if (level->elements == NULL)
+        continue;
+
+      index = sorted_level_find_live (level, element, container->cmp);
+
+      if (index < 0)
+        continue;
+
+      if (level->dead == NULL)
+        level->dead = g_new0 (guint8, level->elements->len);
+
+      level->dead[index] = TRUE;
+      level->n_dead++;
+      container->length--;
+
+      /* Don't let a mostly-dead level slow down every lookup until
+       * it happens to be merged */
+      if (level->n_dead * 2 > level->elements->len)
+        {
+          sorted_level_drop_dead (level, container->element_free);
+
+          if (level->elements->len == 0)
+            g_clear_pointer (&level->elements, g_ptr_array_unref);
+        }
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+/**
+ * g_algorithm_sorted_container_lookup:
+ * @container: A #GAlgorithmSortedContainer.
+ * @element: The element to look for.
+ *
+ * Look up an element comparing equal to @element. Each level is
+ * searched with g_algorithm_binary_search().
+ *
+ * Returns: (transfer none) (nullable): An element of @container
+ *          comparing equal to @element, or %NULL if there is none.
+ */
+gpointer
+g_algorithm_sorted_container_lookup (GAlgorithmSortedContainer *container,
+                                     gconstpointer              element)
+{
+  g_return_val_if_fail(container != NULL, NULL);
+
+  int64_t index = g_algorithm_binary_search (container->delta, (gpointer) element, container->cmp);
+
+  if (index >= 0)
+    return container->delta->pdata[index];
+
+  for (guint i = 0; i < container->levels->len; ++i)
+    {
+      SortedLevel *level = &g_array_index (container->levels, SortedLevel, i);
+
+      if (level->elements == NULL)
+        continue;
+
+      index = sorted_level_find_live (level, element, container->cmp);
+
+      if (index >= 0)
+        return level->elements->pdata[index];
+    }
+
+  return NULL;
+}
+
+/**
+ * g_algorithm_sorted_container_get_length:
+ * @container: A #GAlgorithmSortedContainer.
+ *
+ * Get the number of elements in @container, not counting removed
+ * elements that are waiting to be compacted away.
+ *
+ * Returns: The number of elements in @container.
+ */
+size_t
+g_algorithm_sorted_container_get_length (GAlgorithmSortedContainer *container)
+{
+  g_return_val_if_fail(container != NULL, 0);
+
+  return container->length;
+}
+
+/**
+ * g_algorithm_sorted_container_compact:
+ * @container: A #GAlgorithmSortedContainer.
+ *
+ * Merge all of the elements in @container into a single level, freeing
+ * every removed element. This makes lookups as fast as they can be
+ * until the next insert, at the cost of O(N) time now.
+ */
+void
+g_algorithm_sorted_container_compact (GAlgorithmSortedContainer *container)
+{
+  g_return_if_fail(container != NULL);
+
+  SortedLevel carry = { container->delta, NULL, 0 };
+
+  container->delta = g_ptr_array_sized_new (DELTA_CAPACITY);
+
+  for (guint i = 0; i < container->levels->len; ++i)
+    {
+      SortedLevel *level = &g_array_index (container->levels, SortedLevel, i);
+
+      if (level->elements != NULL)
+        carry = sorted_level_merge (&carry, level, container->cmp, container->element_free);
+    }
+
+  g_array_set_size (container->levels, 0);
+
+  if (carry.elements->len == 0)
+    {
+      g_ptr_array_unref (carry.elements);
+      return;
+    }
+
+  /* Put the result in the level matching its size, so that later
+   * flushes don't merge into it any earlier than they otherwise would */
+  guint slot = 0;
+
+  while (((size_t) DELTA_CAPACITY << slot) < carry.elements->len)
+    ++slot;
+
+  sorted_container_carry (container, carry, slot);
+}
+
+/**
+ * g_algorithm_sorted_container_to_array:
+ * @container: A #GAlgorithmSortedContainer.
+ *
+ * Get all of the elements in @container in sorted order. The elements
+ * still belong to @container.
+ *
+ * Returns: (transfer container) (element-type gpointer): A new #GPtrArray
+ *          holding the elements of @container in sorted order.
+ */
+GPtrArray *
+g_algorithm_sorted_container_to_array (GAlgorithmSortedContainer *container)
+{
+  g_return_val_if_fail(container != NULL, NULL);
+
+  GPtrArray *result = g_ptr_array_sized_new (container->length);
+  guint n_runs = container->levels->len + 1;
+  g_autofree const SortedLevel **runs = g_new0 (const SortedLevel *, n_runs);
+  g_autofree size_t *cursors = g_new0 (size_t, n_runs);
+  SortedLevel delta = { container->delta, NULL, 0 };
+
+  runs[0] = &delta;
+  for (guint i = 0; i < container->levels->len; ++i)
+    {
+      const SortedLevel *level = &g_array_index (container->levels, SortedLevel, i);
+      runs[i + 1] = level->elements != NULL ? level : NULL;
+    }
+
+  /* There are only O(log N) runs, so picking the smallest head by
+   * scanning all of them is cheap enough */
+  while (result->len < container->length)
+    {
+      gint best = -1;
+
+      for (guint r = 0; r < n_runs; ++r)
+        {
+          const SortedLevel *run = runs[r];
+
+          if (run == NULL)
+            continue;
+
+          while (cursors[r] < run->elements->len && sorted_level_is_dead (run, cursors[r]))
+            cursors[r]++;
+
+          if (cursors[r] == run->elements->len)
+            continue;
+
+          if (best < 0 ||
+              container->cmp (run->elements->pdata[cursors[r]],
+                              runs[best]->elements->pdata[cursors[best]]) < 0)
+            best = r;
+        }
+
+      g_ptr_array_add (result, runs[best]->elements->pdata[cursors[best]++]);
+    }
+
+  return result;
+}
@@ -0,0 +1,63 @@
+/*
+ * /galgorithm/galgorithm-sorted-container.h
+ *
+ * Forward declarations for GAlgorithm Sorted Container.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+typedef int (*GAlgorithmCompareFunc) (gconstpointer a, gconstpointer b);
+
+#define G_ALGORITHM_TYPE_SORTED_CONTAINER (g_algorithm_sorted_container_get_type ())
+
+typedef struct _GAlgorithmSortedContainer GAlgorithmSortedContainer;
+
+GType g_algorithm_sorted_container_get_type (void);
+
+GAlgorithmSortedContainer * g_algorithm_sorted_container_new (GAlgorithmCompareFunc cmp,
+                                                              GDestroyNotify        element_free);
+
+GAlgorithmSortedContainer * g_algorithm_sorted_container_ref (GAlgorithmSortedContainer *container);
+
+void g_algorithm_sorted_container_unref (GAlgorithmSortedContainer *container);
+
+void g_algorithm_sorted_container_insert (GAlgorithmSortedContainer *container,
+                                          gpointer                   element);
+
+gboolean g_algorithm_sorted_container_remove (GAlgorithmSortedContainer *container,
+                                              gconstpointer              element);
+
+gpointer g_algorithm_sorted_container_lookup (GAlgorithmSortedContainer *container,
+                                              gconstpointer              element);
+
+size_t g_algorithm_sorted_container_get_length (GAlgorithmSortedContainer *container);
+
+void g_algorithm_sorted_container_compact (GAlgorithmSortedContainer *container);
+
+GPtrArray * g_algorithm_sorted_container_to_array (GAlgorithmSortedContainer *container);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GAlgorithmSortedContainer, g_algorithm_sorted_container_unref)
+
+G_END_DECLS
@@ -0,0 +1,574 @@
+/*
+ * /galgorithm/galgorithm-sorted-index-file.c
+ *
+ * Implementation for GAlgorithm Sorted Index Files, an on-disk format
+ * for sorted fixed-width keys which can be searched directly from a
+ * memory mapping without parsing or copying anything.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib-object.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <galgorithm/galgorithm-sorted-index-file.h>
+
+#define SORTED_INDEX_MAGIC "GALGIDX1"
+#define SORTED_INDEX_BYTE_ORDER 0x01020304u
+
+/* Sample roughly one key per page of keys into the fence table, so
+ * that a search only touches a single page of the key table once the
+ * fences have been searched */
+#define FENCE_TARGET_BYTES 4096
+
+/* Every section starts on a multiple of this, so that the offsets
+ * table can be read in place */
+#define SECTION_ALIGNMENT 8
+
+/* The file is laid out as:
+ *
+ *  - This header
+ *  - n_keys keys of key_size bytes each, in ascending memcmp() order
+ *  - Padding up to SECTION_ALIGNMENT
+ *  - n_keys native-endian guint64 offsets, one per key
+ *  - n_fences fence keys, which are every fence_stride-th key
+ */
+typedef struct {
+  gchar   magic[8];
+  guint32 byte_order;
+  guint32 key_size;
+  guint64 n_keys;
+  guint64 keys_offset;
+  guint64 offsets_offset;
+  guint64 fence_stride;
+  guint64 n_fences;
+  guint64 fences_offset;
+} SortedIndexHeader;
+
+G_STATIC_ASSERT (sizeof (SortedIndexHeader) == 64);
+
+struct _GAlgorithmSortedIndexFile {
+  volatile gint            ref_count;
+  GMappedFile             *mapped_file;
+  const SortedIndexHeader *header;
+  const guint8            *keys;
+  const guint64           *offsets;
+  const guint8            *fences;
+};
+
+G_DEFINE_QUARK (g-algorithm-sorted-index-file-error-quark, g_algorithm_sorted_index_file_error)
+
+G_DEFINE_BOXED_TYPE (GAlgorithmSortedIndexFile,
+                     g_algorithm_sorted_index_file,
+                     g_algorithm_sorted_index_file_ref,
+                     g_algorithm_sorted_index_file_unref)
+
+static inline guint64
+align_section (guint64 offset)
+{
+  return (offset + SECTION_ALIGNMENT - 1) & ~((guint64) SECTION_ALIGNMENT - 1);
+}
+
+/* Find the first of the keys in [floor_index, ceil_index) which is
+ * not less than @key */
+static gsize
+sorted_index_lower_bound (const guint8 *keys,
+                          gsize         key_size,
+                          gsize         floor_index,
+                          gsize         ceil_index,
+                          const guint8 *key)
+{
+  while (floor_index < ceil_index)
+    {
+      gsize midpoint = floor_index + ((ceil_index - floor_index) / 2);
+
+      if (memcmp (keys + midpoint * key_size, key, key_size) < 0)
+        floor_index = midpoint + 1;
+      else
+        ceil_index = midpoint;
+    }
+
+  return floor_index;
+}
+
+static void
+set_error_from_errno (GError      **error,
+                      const gchar  *filename,
+                      const gchar  *action)
+{
+  int saved_errno = errno;
+
+  g_set_error (error,
+               G_FILE_ERROR,
+               g_file_error_from_errno (saved_errno),
+               "Failed to %s “%s”: %s",
+               action,
+               filename,
+               g_strerror (saved_errno));
+}
+
+static gboolean
+write_bytes (FILE         *stream,
+             gconstpointer data,
+             gsize         size)
+{
+  return size == 0 || fwrite (data, 1, size, stream) == size;
+}
+
+static gboolean
+write_padding (FILE  *stream,
+               gsize  size)
+{
+  static const guint8 zeros[SECTION_ALIGNMENT] = { 0 };
+
+  return write_bytes (stream, zeros, size);
+}
+
+/* Serialize every element of @array into @stream. Returns %FALSE with
+ * errno set on a write failure, or with @error set if the keys were
+ * not sorted. */
+static gboolean
+sorted_index_write_stream (FILE                          *stream,
+                           const SortedIndexHeader       *header,
+                           GPtrArray                     *array,
+                           GAlgorithmSortedIndexKeyFunc   key_func,
+                           gpointer                       user_data,
+                           GError                       **error)
+{
+  gsize key_size = header->key_size;
+  g_autofree guint64 *offsets = g_new (guint64, MAX (header->n_keys, 1));
+  g_autofree guint8 *fences = g_malloc (MAX (header->n_fences * key_size, 1));
+  g_autofree guint8 *key = g_malloc0 (key_size);
+  g_autofree guint8 *previous_key = g_malloc0 (key_size);
+
+  if (!write_bytes (stream, header, sizeof (*header)))
+    return FALSE;
+
+  for (gsize i = 0; i < header->n_keys; ++i)
+    {
+      offsets[i] = key_func (array->pdata[i], key, user_data);
+
+      if (i > 0 && memcmp (previous_key, key, key_size) > 0)
+        {
+          g_set_error (error,
+                       G_ALGORITHM_SORTED_INDEX_FILE_ERROR,
+                       G_ALGORITHM_SORTED_INDEX_FILE_ERROR_UNSORTED,
+                       "Key %" G_GSIZE_FORMAT " sorts before the key preceding it",
+                       i);
+          return FALSE;
+        }
+
+      if (i % header->fence_stride == 0)
+        memcpy (fences + (i / header->fence_stride) * key_size, key, key_size);
+
+      if (!write_bytes (stream, key, key_size))
+        return FALSE;
+
+      memcpy (previous_key, key, key_size);
+    }
+
+  return write_padding (stream, header->offsets_offset - (header->keys_offset + header->n_keys * key_size)) &&
+         write_bytes (stream, offsets, header->n_keys * sizeof (guint64)) &&
+         write_bytes (stream, fences, header->n_fences * key_size);
+}
+
+/**
+ * g_algorithm_sorted_index_key_from_uint64:
+ * @value: A #guint64 key.
+ * @key: (out caller-allocates) (array fixed-size=8): Where to write the
+ *       8 byte key.
+ *
+ * Serialize @value big-endian, so that the keys sort the same way as
+ * the integers they came from.
+ */
+void
+g_algorithm_sorted_index_key_from_uint64 (guint64  value,
+                                          guint8  *key)
+{
+  guint64 big_endian = GUINT64_TO_BE (value);
+
+  g_return_if_fail(key != NULL);
+
+  memcpy (key, &big_endian, sizeof (big_endian));
+}
+
+/**
+ * g_algorithm_sorted_index_file_write:
+ * @array: (element-type gpointer): A #GPtrArray, sorted in the same order
+ *         as the keys that @key_func serializes.
+ * @key_size: The size in bytes of every key.
+ * @key_func: (scope call) (closure user_data): A #GAlgorithmSortedIndexKeyFunc
+ *            to serialize each key and get its offset with.
+ * @user_data: User data for @key_func.
+ * @filename: The file to write the index to.
+ * @error: Return location for a #GError.
+ *
+ * Write the keys of @array to @filename as a sorted index, which can
+ * later be opened with g_algorithm_sorted_index_file_new(). Alongside
+ * the keys, the file holds the offset returned by @key_func for each
+ * element, and a table of every few keys to narrow down searches.
+ *
+ * @key_func is called exactly once per element, in order. The index
+ * is written to a temporary file which only replaces @filename once it
+ * is complete, so readers never see a partially written index.
+ *
+ * Returns: %TRUE if the index was written, %FALSE with @error set if it
+ *          could not be written or the keys were not sorted.
+ */
+gboolean
+g_algorithm_sorted_index_file_write (GPtrArray                     *array,
+                                     gsize                          key_size,
+                                     GAlgorithmSortedIndexKeyFunc   key_func,
+                                     gpointer                       user_data,
+                                     const gchar                   *filename,
+                                     GError                       **error)
+{
+  g_return_val_if_fail(array != NULL, FALSE);
+  g_return_val_if_fail(key_size > 0 && key_size <= G_MAXUINT32, FALSE);
+  g_return_val_if_fail(key_func != NULL, FALSE);
+  g_return_val_if_fail(filename != NULL, FALSE);
+  g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+  SortedIndexHeader header;
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, SORTED_INDEX_MAGIC, sizeof (header.magic));
+  header.byte_order = SORTED_INDEX_BYTE_ORDER;
+  header.key_size = key_size;
+  header.n_keys = array->len;
+  header.fence_stride = MAX (FENCE_TARGET_BYTES / key_size, 2);
+  header.n_fences = (header.n_keys + header.fence_stride - 1) / header.fence_stride;
+  header.keys_offset = sizeof (header);
+  header.offsets_offset = align_section (header.keys_offset + header.n_keys * key_size);
+  header.fences_offset = header.offsets_offset + header.n_keys * sizeof (guint64);
+
+  g_autofree gchar *tmp_filename = g_strconcat (filename, ".XXXXXX", NULL);
+  int fd = g_mkstemp (tmp_filename);
+
+  if (fd < 0)
+    {
+      set_error_from_errno (error, tmp_filename, "create");
+      return FALSE;
+    }
+
+  FILE *stream = fdopen (fd, "wb");
+
+  if (stream == NULL)
+    {
+      set_error_from_errno (error, tmp_filename, "open");
+      g_close (fd, NULL);
+      g_unlink (tmp_filename);
+      return FALSE;
+    }
+
+  GError *local_error = NULL;
+  gboolean written = sorted_index_write_stream (stream, &header, array, key_func, user_data, &local_error);
+
+  /* Make sure the contents are on disk before the rename makes them
+   * visible, or a crash could leave a truncated index behind */
+  if (written && (fflush (stream) != 0 || g_fsync (fileno (stream)) != 0))
+    written = FALSE;
+
+  if (!written && local_error == NULL)
+    set_error_from_errno (&local_error, tmp_filename, "write");
+
+  if (fclose (stream) != 0 && local_error == NULL)
+    set_error_from_errno (&local_error, tmp_filename, "close");
+
+  if (local_error == NULL && g_rename (tmp_filename, filename) != 0)
+    set_error_from_errno (&local_error, filename, "rename over");
+
+  if (local_error != NULL)
+    {
+      g_unlink (tmp_filename);
+      g_propagate_error (error, local_error);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Check that everything the header points at fits in the file, so that
+ * none of the accessors need to check anything */
+static gboolean
+sorted_index_header_is_valid (const SortedIndexHeader *header,
+                              gsize                    length)
+{
+  guint64 keys_size;
+  guint64 offsets_size;
+  guint64 fences_size;
+  guint64 keys_end;
+  guint64 offsets_end;
+  guint64 fences_end;
+
+  if (memcmp (header->magic, SORTED_INDEX_MAGIC, sizeof (header->magic)) != 0 ||
+      header->byte_order != SORTED_INDEX_BYTE_ORDER ||
+      header->key_size == 0 ||
+      header->fence_stride == 0)
+    return FALSE;
+
+  if (header->n_fences != header->n_keys / header->fence_stride +
+                          (header->n_keys % header->fence_stride != 0))
+    return FALSE;
+
+  if (header->keys_offset < sizeof (*header) ||
+      header->offsets_offset % SECTION_ALIGNMENT != 0)
+    return FALSE;
+
+  return g_uint64_checked_mul (&keys_size, header->n_keys, header->key_size) &&
+         g_uint64_checked_mul (&offsets_size, header->n_keys, sizeof (guint64)) &&
+         g_uint64_checked_mul (&fences_size, header->n_fences, header->key_size) &&
+         g_uint64_checked_add (&keys_end, header->keys_offset, keys_size) &&
+         g_uint64_checked_add (&offsets_end, header->offsets_offset, offsets_size) &&
+         g_uint64_checked_add (&fences_end, header->fences_offset, fences_size) &&
+         keys_end <= length &&
+         offsets_end <= length &&
+         fences_end <= length;
+}
+
+/**
+ * g_algorithm_sorted_index_file_new:
+ * @filename: The path of a file written by g_algorithm_sorted_index_file_write().
+ * @error: Return location for a #GError.
+ *
+ * Open the sorted index in @filename. The file is mapped into memory
+ * and searched in place, so opening it takes the same time no matter
+ * how many keys it holds. Pages of the file are only read in as
+ * searches touch them.
+ *
+ * Returns: (transfer full) (nullable): A new #GAlgorithmSortedIndexFile,
+ *          or %NULL with @error set if @filename could not be mapped or
+ *          is not a valid sorted index.
+ */
+GAlgorithmSortedIndexFile *
+g_algorithm_sorted_index_file_new (const gchar  *filename,
+                                   GError      **error)
+{
+  g_return_val_if_fail(filename != NULL, NULL);
+  g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+  g_autoptr(GMappedFile) mapped_file = g_mapped_file_new (filename, FALSE, error);
+
+  if (mapped_file == NULL)
+    return NULL;
+
+  const gchar *contents = g_mapped_file_get_contents (mapped_file);
+  gsize length = g_mapped_file_get_length (mapped_file);
+  const SortedIndexHeader *header = (const SortedIndexHeader *) contents;
+
+  if (length < sizeof (*header) || !sorted_index_header_is_valid (header, length))
+    {
+      g_set_error (error,
+                   G_ALGORITHM_SORTED_INDEX_FILE_ERROR,
+                   G_ALGORITHM_SORTED_INDEX_FILE_ERROR_INVALID,
+                   "“%s” is not a valid sorted index for this machine",
+                   filename);
+      return NULL;
+    }
+
+  GAlgorithmSortedIndexFile *index = g_new0 (GAlgorithmSortedIndexFile, 1);
+
+  index->ref_count = 1;
+  index->mapped_file = g_steal_pointer (&mapped_file);
+  index->header = header;
+  index->keys = (const guint8 *) contents + header->keys_offset;
+  index->offsets = (const guint64 *) (contents + header->offsets_offset);
+  index->fences = (const guint8 *) contents + header->fences_offset;
+
+  return index;
+}
+
+/**
+ * g_algorithm_sorted_index_file_ref:
+ * @index: A #GAlgorithmSortedIndexFile.
+ *
+ * Take a reference on @index.
+ *
+ * Returns: (transfer full): @index.
+ */
+GAlgorithmSortedIndexFile *
+g_algorithm_sorted_index_file_ref (GAlgorithmSortedIndexFile *index)
+{
+  g_return_val_if_fail(index != NULL, NULL);
+
+  g_atomic_int_inc (&index->ref_count);
+  return index;
+}
+
+/**
+ * g_algorithm_sorted_index_file_unref:
+ * @index: (transfer full): A #GAlgorithmSortedIndexFile.
+ *
+ * Release a reference on @index. When the last reference is released,
+ * the file is unmapped and any keys returned by
+ * g_algorithm_sorted_index_file_get_key() become invalid.
+ */
+void
+g_algorithm_sorted_index_file_unref (GAlgorithmSortedIndexFile *index)
+{
+  g_return_if_fail(index != NULL);
+
+  if (!g_atomic_int_dec_and_test (&index->ref_count))
+    return;
+
+  g_mapped_file_unref (index->mapped_file);
+  g_free (index);
+}
+
+/**
+ * g_algorithm_sorted_index_file_get_n_keys:
+ * @index: A #GAlgorithmSortedIndexFile.
+ *
+ * Get the number of keys in @index.
+ *
+ * Returns: The number of keys in @index.
+ */
+gsize
+g_algorithm_sorted_index_file_get_n_keys (GAlgorithmSortedIndexFile *index)
+{
+  g_return_val_if_fail(index != NULL, 0);
+
+  return index->header->n_keys;
+}
+
+/**
+ * g_algorithm_sorted_index_file_get_key_size:
+ * @index: A #GAlgorithmSortedIndexFile.
+ *
+ * Get the size in bytes of every key in @index.
+ *
+ * Returns: The key size of @index.
+ */
+gsize
+g_algorithm_sorted_index_file_get_key_size (GAlgorithmSortedIndexFile *index)
+{
+  g_return_val_if_fail(index != NULL, 0);
+
+  return index->header->key_size;
+}
+
+/**
+ * g_algorithm_sorted_index_file_get_key:
+ * @index: A #GAlgorithmSortedIndexFile.
+ * @position: The position of the key, less than the number of keys.
+ *
+ * Get the key at @position, which points straight into the mapped file.
+ *
+ * Returns: (transfer none): The key at @position, valid for as long as
+ *          @index is alive.
+ */
+const guint8 *
+g_algorithm_sorted_index_file_get_key (GAlgorithmSortedIndexFile *index,
+                                       gsize                      position)
+{
+  g_return_val_if_fail(index != NULL, NULL);
+  g_return_val_if_fail(position < index->header->n_keys, NULL);
+
+  return index->keys + position * index->header->key_size;
+}
+
+/**
+ * g_algorithm_sorted_index_file_get_offset:
+ * @index: A #GAlgorithmSortedIndexFile.
+ * @position: The position of the key, less than the number of keys.
+ *
+ * Get the offset that was stored alongside the key at @position.
+ *
+ * Returns: The offset for the key at @position.
+ */
+guint64
+g_algorithm_sorted_index_file_get_offset (GAlgorithmSortedIndexFile *index,
+                                          gsize                      position)
+{
+  g_return_val_if_fail(index != NULL, 0);
+  g_return_val_if_fail(position < index->header->n_keys, 0);
+
+  return index->offsets[position];
+}
+
+/**
+ * g_algorithm_sorted_index_file_search:
+ * @index: A #GAlgorithmSortedIndexFile.
+ * @key: (array): The key to search for, as long as the key size of @index.
+ *
+ * Find the first key in @index equal to @key. The fence table is
+ * binary searched first, which leaves about a page of keys for the
+ * binary search of the key table itself.
+ *
+ * Returns: The position of the first key equal to @key, or -1 if
+ *          there is none.
+ */
+int64_t
+g_algorithm_sorted_index_file_search (GAlgorithmSortedIndexFile *index,
+                                      const guint8              *key)
+{
+  g_return_val_if_fail(index != NULL, -1);
+  g_return_val_if_fail(key != NULL, -1);
+
+  const SortedIndexHeader *header = index->header;
+  gsize key_size = header->key_size;
+  gsize stride = header->fence_stride;
+
+  /* Fence f is key f * stride, so if it is the first fence not less
+   * than @key, then the first key not less than @key is somewhere
+   * after fence f - 1 and no later than fence f */
+  gsize fence = sorted_index_lower_bound (index->fences, key_size, 0, header->n_fences, key);
+  gsize floor_index = fence == 0 ? 0 : (fence - 1) * stride + 1;
+  gsize ceil_index = MIN (fence * stride, header->n_keys);
+  gsize position = sorted_index_lower_bound (index->keys, key_size, floor_index, ceil_index, key);
+
+  if (position < header->n_keys &&
+      memcmp (index->keys + position * key_size, key, key_size) == 0)
+    return (int64_t) position;
+
+  return -1;
+}
+
+/**
+ * g_algorithm_sorted_index_file_lookup:
+ * @index: A #GAlgorithmSortedIndexFile.
+ * @key: (array): The key to look up, as long as the key size of @index.
+ * @out_offset: (out) (optional): Return location for the offset stored
+ *              alongside @key.
+ *
+ * Look up the offset stored alongside the first key equal to @key.
+ *
+ * Returns: %TRUE if @key is in @index, %FALSE otherwise.
+ */
+gboolean
+g_algorithm_sorted_index_file_lookup (GAlgorithmSortedIndexFile *index,
+                                      const guint8              *key,
+                                      guint64                   *out_offset)
+{
+  g_return_val_if_fail(index != NULL, FALSE);
+  g_return_val_if_fail(key != NULL, FALSE);
+
+  int64_t position = g_algorithm_sorted_index_file_search (index, key);
+
+  if (position < 0)
+    return FALSE;
+
+  if (out_offset != NULL)
+    *out_offset = index->offsets[position];
+
+  return TRUE;
+}
@@ -0,0 +1,111 @@
+/*
+ * /galgorithm/galgorithm-sorted-index-file.h
+ *
+ * Forward declarations for GAlgorithm Sorted Index Files.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+#define G_ALGORITHM_TYPE_SORTED_INDEX_FILE (g_algorithm_sorted_index_file_get_type ())
+
+#define G_ALGORITHM_SORTED_INDEX_FILE_ERROR (g_algorithm_sorted_index_file_error_quark ())
+
+/**
+ * GAlgorithmSortedIndexFileError:
+ * @G_ALGORITHM_SORTED_INDEX_FILE_ERROR_INVALID: The file is not a sorted
+ *   index file, is truncated, or was written on a machine with a different
+ *   byte order.
+ * @G_ALGORITHM_SORTED_INDEX_FILE_ERROR_UNSORTED: The serialized keys were
+ *   not in ascending order.
+ *
+ * Errors from reading and writing sorted index files.
+ */
+typedef enum {
+  G_ALGORITHM_SORTED_INDEX_FILE_ERROR_INVALID,
+  G_ALGORITHM_SORTED_INDEX_FILE_ERROR_UNSORTED
+} GAlgorithmSortedIndexFileError;
+
+typedef struct _GAlgorithmSortedIndexFile GAlgorithmSortedIndexFile;
+
+/**
+ * GAlgorithmSortedIndexKeyFunc:
+ * @element: An element of the array being written.
+ * @key: (out caller-allocates) (array): Where to write the key of @element.
+ *       It is as long as the key size passed to
+ *       g_algorithm_sorted_index_file_write().
+ * @user_data: The user data passed along with the callback.
+ *
+ * Serialize the key of @element into @key. Keys are ordered by
+ * comparing their bytes with memcmp(), so integers should be written
+ * big-endian, for instance with g_algorithm_sorted_index_key_from_uint64().
+ *
+ * Returns: The offset to store alongside the key, such as where the
+ *          record for @element lives in some other file.
+ */
+typedef guint64 (*GAlgorithmSortedIndexKeyFunc) (gconstpointer  element,
+                                                 guint8        *key,
+                                                 gpointer       user_data);
+
+GQuark g_algorithm_sorted_index_file_error_quark (void);
+
+GType g_algorithm_sorted_index_file_get_type (void);
+
+void g_algorithm_sorted_index_key_from_uint64 (guint64  value,
+                                               guint8  *key);
+
+gboolean g_algorithm_sorted_index_file_write (GPtrArray                     *array,
+                                              gsize                          key_size,
+                                              GAlgorithmSortedIndexKeyFunc   key_func,
+                                              gpointer                       user_data,
+                                              const gchar                   *filename,
+                                              GError                       **error);
+
+GAlgorithmSortedIndexFile * g_algorithm_sorted_index_file_new (const gchar  *filename,
+                                                               GError      **error);
+
+GAlgorithmSortedIndexFile * g_algorithm_sorted_index_file_ref (GAlgorithmSortedIndexFile *index);
+
+void g_algorithm_sorted_index_file_unref (GAlgorithmSortedIndexFile *index);
+
+gsize g_algorithm_sorted_index_file_get_n_keys (GAlgorithmSortedIndexFile *index);
+
+gsize g_algorithm_sorted_index_file_get_key_size (GAlgorithmSortedIndexFile *index);
+
+const guint8 * g_algorithm_sorted_index_file_get_key (GAlgorithmSortedIndexFile *index,
+                                                      gsize                      position);
+
+guint64 g_algorithm_sorted_index_file_get_offset (GAlgorithmSortedIndexFile *index,
+                                                  gsize                      position);
+
+int64_t g_algorithm_sorted_index_file_search (GAlgorithmSortedIndexFile *index,
+                                              const guint8              *key);
+
+gboolean g_algorithm_sorted_index_file_lookup (GAlgorithmSortedIndexFile *index,
+                                               const guint8              *key,
+                                               guint64                   *out_offset);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GAlgorithmSortedIndexFile, g_algorithm_sorted_index_file_unref)
+
+G_END_DECLS
@@ -0,0 +1,107 @@
+/*
+ * /galgorithm/galgorithm-stats-private.h
+ *
+ * Instrumentation macros for GAlgorithm Stats and tracing.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+#include <galgorithm/galgorithm-stats.h>
+
+#ifdef G_ALGORITHM_ENABLE_USDT
+#include <sys/sdt.h>
+#endif
+
+G_BEGIN_DECLS
+
+/* Everything in here compiles to nothing unless the library is built
+ * with the stats or usdt options, so it can go in hot loops. Counters
+ * are bumped in bulk where a loop knows how much work it did, rather
+ * than once per iteration. */
+
+#ifdef G_ALGORITHM_ENABLE_STATS
+
+#if defined(_MSC_VER)
+#define G_ALGORITHM_THREAD_LOCAL __declspec(thread)
+#else
+#define G_ALGORITHM_THREAD_LOCAL __thread
+#endif
+
+/* The stats being collected on this thread, or NULL */
+extern G_ALGORITHM_THREAD_LOCAL GAlgorithmStats *g_algorithm_stats_current;
+
+#define G_ALGORITHM_STATS_ADD(field, n)                                     \
+  G_STMT_START {                                                            \
+    if (G_UNLIKELY (g_algorithm_stats_current != NULL))                     \
+      g_algorithm_stats_current->field += (n);                              \
+  } G_STMT_END
+
+/* Count a single comparison as part of an expression */
+#define G_ALGORITHM_STATS_COMPARE(cmp, a, b)                                \
+  ((void) (G_UNLIKELY (g_algorithm_stats_current != NULL) &&                \
+           ++g_algorithm_stats_current->comparisons),                       \
+   (cmp) ((a), (b)))
+
+#define G_ALGORITHM_STATS_OPERATION_BEGIN()                                 \
+  gint64 _g_algorithm_operation_start =                                     \
+    G_UNLIKELY (g_algorithm_stats_current != NULL) ? g_get_monotonic_time () : 0
+
+#define G_ALGORITHM_STATS_OPERATION_END()                                   \
+  G_STMT_START {                                                            \
+    if (G_UNLIKELY (g_algorithm_stats_current != NULL))                     \
+      {                                                                     \
+        g_algorithm_stats_current->operations++;                            \
+        g_algorithm_stats_current->wall_time_us +=                          \
+          g_get_monotonic_time () - _g_algorithm_operation_start;           \
+      }                                                                     \
+  } G_STMT_END
+
+#else
+
+#define G_ALGORITHM_STATS_ADD(field, n) G_STMT_START { (void) (n); } G_STMT_END
+#define G_ALGORITHM_STATS_COMPARE(cmp, a, b) ((cmp) ((a), (b)))
+#define G_ALGORITHM_STATS_OPERATION_BEGIN() G_STMT_START { } G_STMT_END
+#define G_ALGORITHM_STATS_OPERATION_END() G_STMT_START { } G_STMT_END
+
+#endif
+
+/* USDT probes named galgorithm:<name>__begin and galgorithm:<name>__end,
+ * with the number of elements as the argument */
+#ifdef G_ALGORITHM_ENABLE_USDT
+#define G_ALGORITHM_TRACE_BEGIN(name, len) DTRACE_PROBE1 (galgorithm, name##__begin, (len))
+#define G_ALGORITHM_TRACE_END(name, len) DTRACE_PROBE1 (galgorithm, name##__end, (len))
+#else
+#define G_ALGORITHM_TRACE_BEGIN(name, len) G_STMT_START { } G_STMT_END
+#define G_ALGORITHM_TRACE_END(name, len) G_STMT_START { } G_STMT_END
+#endif
+
+/* Start and finish an instrumented operation. BEGIN declares a local,
+ * so it must come after any early returns for trivial input. */
+#define G_ALGORITHM_OPERATION_BEGIN(name, len)                              \
+  G_ALGORITHM_STATS_OPERATION_BEGIN ();                                     \
+  G_ALGORITHM_TRACE_BEGIN (name, len)
+
+#define G_ALGORITHM_OPERATION_END(name, len)                                \
+  G_ALGORITHM_STATS_OPERATION_END ();                                       \
+  G_ALGORITHM_TRACE_END (name, len)
+
+G_END_DECLS
@@ -0,0 +1,89 @@
+/*
+ * /galgorithm/galgorithm-stats.c
+ *
+ * Implementation for GAlgorithm Stats.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-stats.h>
+#include <galgorithm/galgorithm-stats-private.h>
+
+#ifdef G_ALGORITHM_ENABLE_STATS
+G_ALGORITHM_THREAD_LOCAL GAlgorithmStats *g_algorithm_stats_current = NULL;
+#endif
+
+/**
+ * g_algorithm_stats_is_enabled:
+ *
+ * Check whether the library was built to collect #GAlgorithmStats.
+ *
+ * Returns: %TRUE if g_algorithm_stats_begin() collects anything.
+ */
+gboolean
+g_algorithm_stats_is_enabled (void)
+{
+#ifdef G_ALGORITHM_ENABLE_STATS
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/**
+ * g_algorithm_stats_begin:
+ * @stats: A #GAlgorithmStats to collect into. It must stay alive until
+ *         g_algorithm_stats_end() is called.
+ *
+ * Reset @stats and start adding the work done by operations on the
+ * calling thread to it, until g_algorithm_stats_end() is called.
+ * Operations that run on other threads, such as the asynchronous
+ * sorts, are not counted. Only one #GAlgorithmStats collects on a
+ * thread at a time, so this replaces any other one.
+ */
+void
+g_algorithm_stats_begin (GAlgorithmStats *stats)
+{
+  g_return_if_fail(stats != NULL);
+
+  memset (stats, 0, sizeof (*stats));
+
+#ifdef G_ALGORITHM_ENABLE_STATS
+  g_algorithm_stats_current = stats;
+#endif
+}
+
+/**
+ * g_algorithm_stats_end:
+ * @stats: The #GAlgorithmStats passed to g_algorithm_stats_begin().
+ *
+ * Stop collecting into @stats. Its counters keep their values.
+ */
+void
+g_algorithm_stats_end (GAlgorithmStats *stats)
+{
+  g_return_if_fail(stats != NULL);
+
+#ifdef G_ALGORITHM_ENABLE_STATS
+  if (g_algorithm_stats_current == stats)
+    g_algorithm_stats_current = NULL;
+#endif
+}
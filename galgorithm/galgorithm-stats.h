@@ -0,0 +1,61 @@
+/*
+ * /galgorithm/galgorithm-stats.h
+ *
+ * Forward declarations for GAlgorithm Stats.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GAlgorithmStats:
+ * @operations: The number of sorts, searches and heap operations run.
+ * @comparisons: The number of times a #GAlgorithmCompareFunc was called.
+ * @swaps: The number of pairs of elements swapped.
+ * @moves: The number of elements copied into place, other than by swaps.
+ * @scratch_bytes: The number of bytes of scratch memory allocated.
+ * @passes: The number of merge passes or quicksort partitions.
+ * @wall_time_us: The wall time spent in the operations, in microseconds.
+ *
+ * Operation counters collected by g_algorithm_stats_begin() for the
+ * merge sorts, quicksorts, binary search and min-heap operations run
+ * on the calling thread. Counters are only collected if the library
+ * was built with the `stats` option; otherwise they stay at zero.
+ */
+typedef struct {
+  guint64 operations;
+  guint64 comparisons;
+  guint64 swaps;
+  guint64 moves;
+  guint64 scratch_bytes;
+  guint64 passes;
+  gint64  wall_time_us;
+} GAlgorithmStats;
+
+gboolean g_algorithm_stats_is_enabled (void);
+
+void g_algorithm_stats_begin (GAlgorithmStats *stats);
+
+void g_algorithm_stats_end (GAlgorithmStats *stats);
+
+G_END_DECLS
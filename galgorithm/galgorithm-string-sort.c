@@ -0,0 +1,250 @@
+/*
+ * /galgorithm/galgorithm-string-sort.c
+ *
+ * Implementation for GAlgorithm String Sort, a multikey (three-way
+ * radix) quicksort over cached 8 byte prefix words. Runs in O(N)
+ * space and O(N log N + D) expected time, where D is the total
+ * length of the distinguishing prefixes.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <galgorithm/galgorithm-string-sort.h>
+
+/* Ranges smaller than this are finished off with insertion sort */
+#define INSERTION_SORT_THRESHOLD 16
+
+typedef struct {
+  guint64      word;
+  const gchar *key;
+  size_t       len;
+  gpointer     element;
+} StringEntry;
+
+typedef struct {
+  size_t lower;
+  size_t upper;
+  size_t depth;
+} StringSortFrame;
+
+static inline void
+swap (StringEntry *lhs, StringEntry *rhs)
+{
+  StringEntry tmp = *lhs;
+  *lhs = *rhs;
+  *rhs = tmp;
+}
+
+/* Pack the 8 bytes of @entry's key starting at @depth into a big-endian
+ * word, padding with zeros past the end of the key. Comparing two words
+ * as integers then gives the same result as comparing those bytes with
+ * strcmp(). The lowest byte of the word is only non-zero if the key
+ * continues past this word. */
+static inline guint64
+load_prefix_word (const StringEntry *entry, size_t depth)
+{
+  const guchar *bytes = (const guchar *) entry->key + depth;
+  size_t remaining = entry->len > depth ? entry->len - depth : 0;
+  guint64 word = 0;
+
+  if (remaining >= sizeof (word))
+    {
+      memcpy (&word, bytes, sizeof (word));
+      return GUINT64_FROM_BE (word);
+    }
+
+  for (size_t i = 0; i < remaining; ++i)
+    word |= (guint64) bytes[i] << (56 - 8 * i);
+
+  return word;
+}
+
+static inline gboolean
+prefix_word_continues (guint64 word)
+{
+  return (word & 0xff) != 0;
+}
+
+/* Compare two entries whose keys are known to agree on the
+ * first @depth bytes. */
+static inline int
+compare_from_depth (const StringEntry *a, const StringEntry *b, size_t depth)
+{
+  if (a->word != b->word)
+    return a->word < b->word ? -1 : 1;
+
+  if (!prefix_word_continues (a->word))
+    return 0;
+
+  return strcmp (a->key + depth + sizeof (guint64),
+                 b->key + depth + sizeof (guint64));
+}
+
+static void
+insertion_sort (StringEntry *entries, size_t len, size_t depth)
+{
+  for (size_t i = 1; i < len; ++i)
+    {
+      for (size_t j = i; j > 0 && compare_from_depth (&entries[j - 1], &entries[j], depth) > 0; --j)
+        swap (&entries[j - 1], &entries[j]);
+    }
+}
+
+static inline guint64
+median_of_three (guint64 a, guint64 b, guint64 c)
+{
+  if (a < b)
+    return b < c ? b : (a < c ? c : a);
+  else
+    return a < c ? a : (b < c ? c : b);
+}
+
+static void
+multikey_quicksort (StringEntry *entries, size_t len)
+{
+  g_autoptr(GArray) stack = g_array_new (FALSE, FALSE, sizeof (StringSortFrame));
+  StringSortFrame initial = { 0, len, 0 };
+
+  for (size_t i = 0; i < len; ++i)
+    entries[i].word = load_prefix_word (&entries[i], 0);
+
+  g_array_append_val (stack, initial);
+
+  while (stack->len > 0)
+    {
+      StringSortFrame frame = g_array_index (stack, StringSortFrame, stack->len - 1);
+      g_array_set_size (stack, stack->len - 1);
+
+      size_t lower = frame.lower;
+      size_t upper = frame.upper;
+
+      if (upper - lower < INSERTION_SORT_THRESHOLD)
+        {
+          insertion_sort (&entries[lower], upper - lower, frame.depth);
+          continue;
+        }
+
+      guint64 pivot = median_of_three (entries[lower].word,
+                                       entries[lower + (upper - lower) / 2].word,
+                                       entries[upper - 1].word);
+
+      /* Three-way partition on the prefix word. Most comparisons
+       * end up as a single integer compare here. */
+      size_t lt = lower;
+      size_t i = lower;
+      size_t gt = upper;
+
+      while (i < gt)
+        {
+          if (entries[i].word < pivot)
+            swap (&entries[lt++], &entries[i++]);
+          else if (entries[i].word > pivot)
+            swap (&entries[i], &entries[--gt]);
+          else
+            ++i;
+        }
+
+      StringSortFrame less = { lower, lt, frame.depth };
+      StringSortFrame greater = { gt, upper, frame.depth };
+
+      g_array_append_val (stack, less);
+      g_array_append_val (stack, greater);
+
+      /* Everything in the middle shares the pivot prefix. If the keys
+       * have not ended yet, carry on sorting them by the next word,
+       * otherwise they are all equal and there is nothing left to do. */
+      if (prefix_word_continues (pivot) && gt - lt > 1)
+        {
+          StringSortFrame equal = { lt, gt, frame.depth + sizeof (guint64) };
+
+          for (size_t k = lt; k < gt; ++k)
+            entries[k].word = load_prefix_word (&entries[k], equal.depth);
+
+          g_array_append_val (stack, equal);
+        }
+    }
+}
+
+/**
+ * g_algorithm_sort_strings:
+ * @array: (element-type utf8): A #GPtrArray of nul-terminated strings.
+ * @mode: The #GAlgorithmStringSortMode to order the strings by.
+ *
+ * Sort an array of strings, returning a reference to @array. This uses
+ * a multikey quicksort, which never re-compares a prefix that two strings
+ * are already known to share, and compares up to eight bytes at a time
+ * as a single integer. It is much faster than a comparison sort with
+ * strcmp() when the strings share long prefixes, such as paths or URLs.
+ *
+ * For the collating modes, the collation key of each string is
+ * computed exactly once and the keys are sorted bytewise.
+ *
+ * The sort is not stable.
+ *
+ * Return: (transfer none) (element-type utf8): @array, sorted in-place.
+ */
+GPtrArray * g_algorithm_sort_strings (GPtrArray                *array,
+                                      GAlgorithmStringSortMode  mode)
+{
+  g_return_val_if_fail(array != NULL, NULL);
+
+  size_t len = array->len;
+
+  if (len <= 1)
+    return array;
+
+  g_autofree StringEntry *entries = g_new (StringEntry, len);
+
+  for (size_t i = 0; i < len; ++i)
+    {
+      const gchar *str = array->pdata[i];
+
+      switch (mode)
+        {
+          case G_ALGORITHM_STRING_SORT_COLLATE:
+            entries[i].key = g_utf8_collate_key (str, -1);
+            break;
+          case G_ALGORITHM_STRING_SORT_COLLATE_FILENAME:
+            entries[i].key = g_utf8_collate_key_for_filename (str, -1);
+            break;
+          case G_ALGORITHM_STRING_SORT_BYTES:
+          default:
+            entries[i].key = str;
+            break;
+        }
+
+      entries[i].len = strlen (entries[i].key);
+      entries[i].element = array->pdata[i];
+    }
+
+  multikey_quicksort (entries, len);
+
+  for (size_t i = 0; i < len; ++i)
+    {
+      array->pdata[i] = entries[i].element;
+
+      /* Collation keys were allocated for us */
+      if (entries[i].key != entries[i].element)
+        g_free ((gchar *) entries[i].key);
+    }
+
+  return array;
+}
@@ -0,0 +1,48 @@
+/*
+ * /galgorithm/galgorithm-string-sort.h
+ *
+ * Forward declarations for GAlgorithm String Sort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GAlgorithmStringSortMode:
+ * @G_ALGORITHM_STRING_SORT_BYTES: Order strings bytewise, like strcmp().
+ * @G_ALGORITHM_STRING_SORT_COLLATE: Order strings like g_utf8_collate().
+ * @G_ALGORITHM_STRING_SORT_COLLATE_FILENAME: Order strings like
+ *   comparing the result of g_utf8_collate_key_for_filename().
+ *
+ * The ordering used by g_algorithm_sort_strings().
+ */
+typedef enum {
+  G_ALGORITHM_STRING_SORT_BYTES,
+  G_ALGORITHM_STRING_SORT_COLLATE,
+  G_ALGORITHM_STRING_SORT_COLLATE_FILENAME
+} GAlgorithmStringSortMode;
+
+GPtrArray * g_algorithm_sort_strings (GPtrArray                *array,
+                                      GAlgorithmStringSortMode  mode);
+
+G_END_DECLS
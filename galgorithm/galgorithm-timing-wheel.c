@@ -0,0 +1,524 @@
+/*
+ * /galgorithm/galgorithm-timing-wheel.c
+ *
+ * Implementation for GAlgorithm Timing Wheel, a hierarchical timing
+ * wheel. Scheduling and cancelling run in O(1) time and expiring runs
+ * in amortized O(1) time per timer.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <glib-object.h>
+#include <glib.h>
+
+#include <galgorithm/galgorithm-timing-wheel.h>
+
+/* Each level has 64 slots, so that the occupied slots of a level fit
+ * in one 64 bit mask. Slot s of level l holds timers expiring within
+ * the 64^l ticks that slot covers. Six levels cover 2^36 ticks, which
+ * is over two years of milliseconds. Timers further out than that
+ * are parked in the top level and placed again when it comes round. */
+#define SLOT_BITS 6
+#define SLOTS (1 << SLOT_BITS)
+#define SLOT_MASK (SLOTS - 1)
+#define LEVELS 6
+
+#define NIL G_MAXUINT32
+#define NOT_SCHEDULED G_MAXUINT16
+
+/* Timers live in one growable array and link to each other by index,
+ * so that scheduling doesn't allocate once the array is big enough */
+typedef struct {
+  guint64  expiry;
+  gpointer data;
+  guint32  next;
+  guint32  prev;
+  guint32  generation;
+  guint16  slot;
+} TimerNode;
+
+struct _GAlgorithmTimingWheel {
+  volatile gint  ref_count;
+  guint64        now;
+  GArray        *nodes;
+  guint32        free_head;
+  size_t         n_timers;
+  guint64        occupied[LEVELS];
+  guint32        slots[LEVELS * SLOTS];
+};
+
+G_DEFINE_BOXED_TYPE (GAlgorithmTimingWheel,
+                     g_algorithm_timing_wheel,
+                     g_algorithm_timing_wheel_ref,
+                     g_algorithm_timing_wheel_unref)
+
+static inline guint
+lowest_bit (guint64 mask)
+{
+#if defined(__GNUC__)
+  return __builtin_ctzll (mask);
+#else
+  guint bit = 0;
+
+  while ((mask & 1) == 0)
+    {
+      mask >>= 1;
+      ++bit;
+    }
+
+  return bit;
+#endif
+}
+
+static inline TimerNode *
+timer_node (GAlgorithmTimingWheel *wheel, guint32 index)
+{
+  return &g_array_index (wheel->nodes, TimerNode, index);
+}
+
+static inline GAlgorithmTimingWheelHandle
+timer_handle (guint32 index, guint32 generation)
+{
+  return ((guint64) generation << 32) | ((guint64) index + 1);
+}
+
+static guint32
+timer_node_alloc (GAlgorithmTimingWheel *wheel)
+{
+  if (wheel->free_head != NIL)
+    {
+      guint32 index = wheel->free_head;
+
+      wheel->free_head = timer_node (wheel, index)->next;
+      return index;
+    }
+
+  guint32 index = wheel->nodes->len;
+
+  g_array_set_size (wheel->nodes, index + 1);
+  return index;
+}
+
+static void
+timer_node_release (GAlgorithmTimingWheel *wheel,
+                    guint32                index)
+{
+  TimerNode *node = timer_node (wheel, index);
+
+  /* Invalidate any outstanding handle to this node */
+  node->generation++;
+  node->slot = NOT_SCHEDULED;
+  node->data = NULL;
+  node->next = wheel->free_head;
+  wheel->free_head = index;
+}
+
+static void
+slot_push (GAlgorithmTimingWheel *wheel,
+           guint16                slot,
+           guint32                index)
+{
+  TimerNode *node = timer_node (wheel, index);
+  guint32 head = wheel->slots[slot];
+
+  node->slot = slot;
+  node->prev = NIL;
+  node->next = head;
+
+  if (head != NIL)
+    timer_node (wheel, head)->prev = index;
+
+  wheel->slots[slot] = index;
+  wheel->occupied[slot / SLOTS] |= G_GUINT64_CONSTANT (1) << (slot % SLOTS);
+}
+
+static void
+slot_unlink (GAlgorithmTimingWheel *wheel,
+             guint32                index)
+{
+  TimerNode *node = timer_node (wheel, index);
+  guint16 slot = node->slot;
+
+  if (node->prev != NIL)
+    timer_node (wheel, node->prev)->next = node->next;
+  else
+    wheel->slots[slot] = node->next;
+
+  if (node->next != NIL)
+    timer_node (wheel, node->next)->prev = node->prev;
+
+  if (wheel->slots[slot] == NIL)
+    wheel->occupied[slot / SLOTS] &= ~(G_GUINT64_CONSTANT (1) << (slot % SLOTS));
+}
+
+/* Take the whole list out of @slot, returning its head */
+static guint32
+slot_detach (GAlgorithmTimingWheel *wheel,
+             guint16                slot)
+{
+  guint32 head = wheel->slots[slot];
+
+  wheel->slots[slot] = NIL;
+  wheel->occupied[slot / SLOTS] &= ~(G_GUINT64_CONSTANT (1) << (slot % SLOTS));
+
+  return head;
+}
+
+/* Put the timer at @index into the slot covering its expiry, relative
+ * to @base, the next tick that will be processed. Timers are placed on
+ * the lowest level that can tell their expiry apart from @base. */
+static void
+timer_place (GAlgorithmTimingWheel *wheel,
+             guint32                index,
+             guint64                base)
+{
+  guint64 expiry = MAX (timer_node (wheel, index)->expiry, base);
+  guint64 delta = expiry - base;
+
+  for (guint level = 0; level < LEVELS; ++level)
+    {
+      if (delta < (G_GUINT64_CONSTANT (1) << (SLOT_BITS * (level + 1))))
+        {
+          guint16 slot = level * SLOTS + ((expiry >> (SLOT_BITS * level)) & SLOT_MASK);
+
+          slot_push (wheel, slot, index);
+          return;
+        }
+    }
+
+  /* Too far out for the top level. Park it in the furthest slot, from
+   * which it will be placed again once that slot comes round */
+  expiry = base + (G_GUINT64_CONSTANT (1) << (SLOT_BITS * LEVELS)) - 1;
+  slot_push (wheel,
+             (LEVELS - 1) * SLOTS + ((expiry >> (SLOT_BITS * (LEVELS - 1))) & SLOT_MASK),
+             index);
+}
+
+/* Called when @tick starts a new rotation of the bottom level. The
+ * slot of each level above that has just come round is emptied into
+ * the levels below it. */
+static void
+timing_wheel_cascade (GAlgorithmTimingWheel *wheel,
+                      guint64                tick)
+{
+  for (guint level = 1; level < LEVELS; ++level)
+    {
+      guint slot_index = (tick >> (SLOT_BITS * level)) & SLOT_MASK;
+      guint32 index = slot_detach (wheel, level * SLOTS + slot_index);
+
+      while (index != NIL)
+        {
+          guint32 next = timer_node (wheel, index)->next;
+
+          timer_place (wheel, index, tick);
+          index = next;
+        }
+
+      /* Only carry on up if this level has also started a new rotation */
+      if (slot_index != 0)
+        break;
+    }
+}
+
+/* With the bottom level empty, nothing can expire until some timer
+ * is cascaded down. Find the first tick after now at which the lowest
+ * occupied level either cascades an occupied slot or starts a new
+ * rotation, which might bring timers down from above. */
+static guint64
+timing_wheel_next_cascade (GAlgorithmTimingWheel *wheel)
+{
+  guint level = 1;
+
+  while (wheel->occupied[level] == 0)
+    ++level;
+
+  guint shift = SLOT_BITS * level;
+  guint64 boundary = ((wheel->now >> shift) + 1) << shift;
+  guint slot_index = (boundary >> shift) & SLOT_MASK;
+
+  if (slot_index == 0)
+    return boundary;
+
+  guint64 pending = wheel->occupied[level] >> slot_index;
+
+  if (pending == 0)
+    return ((boundary >> (shift + SLOT_BITS)) + 1) << (shift + SLOT_BITS);
+
+  return boundary + ((guint64) lowest_bit (pending) << shift);
+}
+
+static size_t
+timing_wheel_expire_slot (GAlgorithmTimingWheel *wheel,
+                          guint16                slot,
+                          GPtrArray             *expired)
+{
+  guint32 index = slot_detach (wheel, slot);
+  size_t n_expired = 0;
+
+  while (index != NIL)
+    {
+      TimerNode *node = timer_node (wheel, index);
+      guint32 next = node->next;
+
+      if (expired != NULL)
+        g_ptr_array_add (expired, node->data);
+
+      timer_node_release (wheel, index);
+      ++n_expired;
+      index = next;
+    }
+
+  wheel->n_timers -= n_expired;
+  return n_expired;
+}
+
+/**
+ * g_algorithm_timing_wheel_new:
+ * @now: The current time, in ticks.
+ *
+ * Create a new, empty timing wheel starting at @now. A tick is whatever
+ * unit of time the caller chooses, such as a millisecond, and is the
+ * finest granularity at which timers expire.
+ *
+ * Unlike a heap, which costs O(log N) for each timer scheduled, a
+ * timing wheel schedules and cancels timers in O(1) time, which suits
+ * large numbers of timeouts that are mostly cancelled before they fire.
+ *
+ * Returns: (transfer full): A new #GAlgorithmTimingWheel.
+ */
+GAlgorithmTimingWheel *
+g_algorithm_timing_wheel_new (guint64 now)
+{
+  GAlgorithmTimingWheel *wheel = g_new0 (GAlgorithmTimingWheel, 1);
+
+  wheel->ref_count = 1;
+  wheel->now = now;
+  wheel->nodes = g_array_new (FALSE, TRUE, sizeof (TimerNode));
+  wheel->free_head = NIL;
+  wheel->n_timers = 0;
+
+  for (size_t i = 0; i < G_N_ELEMENTS (wheel->slots); ++i)
+    wheel->slots[i] = NIL;
+
+  return wheel;
+}
+
+/**
+ * g_algorithm_timing_wheel_ref:
+ * @wheel: A #GAlgorithmTimingWheel.
+ *
+ * Take a reference on @wheel.
+ *
+ * Returns: (transfer full): @wheel.
+ */
+GAlgorithmTimingWheel *
+g_algorithm_timing_wheel_ref (GAlgorithmTimingWheel *wheel)
+{
+  g_return_val_if_fail(wheel != NULL, NULL);
+
+  g_atomic_int_inc (&wheel->ref_count);
+  return wheel;
+}
+
+/**
+ * g_algorithm_timing_wheel_unref:
+ * @wheel: (transfer full): A #GAlgorithmTimingWheel.
+ *
+ * Release a reference on @wheel. Any timers still scheduled are
+ * dropped without expiring.
+ */
+void
+g_algorithm_timing_wheel_unref (GAlgorithmTimingWheel *wheel)
+{
+  g_return_if_fail(wheel != NULL);
+
+  if (!g_atomic_int_dec_and_test (&wheel->ref_count))
+    return;
+
+  g_array_unref (wheel->nodes);
+  g_free (wheel);
+}
+
+/**
+ * g_algorithm_timing_wheel_schedule:
+ * @wheel: A #GAlgorithmTimingWheel.
+ * @expiry: The tick at which the timer expires. If it is not after the
+ *          current time of @wheel, the timer expires on the next advance
+ *          to a later time.
+ * @data: (nullable): Data to hand back when the timer expires.
+ *
+ * Schedule a timer on @wheel in O(1) time.
+ *
+ * Returns: A #GAlgorithmTimingWheelHandle to cancel the timer with.
+ */
+GAlgorithmTimingWheelHandle
+g_algorithm_timing_wheel_schedule (GAlgorithmTimingWheel *wheel,
+                                   guint64                expiry,
+                                   gpointer               data)
+{
+  g_return_val_if_fail(wheel != NULL, 0);
+
+  guint32 index = timer_node_alloc (wheel);
+  TimerNode *node = timer_node (wheel, index);
+
+  node->expiry = expiry;
+  node->data = data;
+
+  timer_place (wheel, index, wheel->now + 1);
+  wheel->n_timers++;
+
+  return timer_handle (index, node->generation);
+}
+
+/**
+ * g_algorithm_timing_wheel_cancel:
+ * @wheel: A #GAlgorithmTimingWheel.
+ * @handle: A #GAlgorithmTimingWheelHandle returned by
+ *          g_algorithm_timing_wheel_schedule().
+ *
+ * Cancel the timer identified by @handle in O(1) time.
+ *
+ * Returns: %TRUE if the timer was cancelled, %FALSE if it had already
+ *          expired or been cancelled.
+ */
+gboolean
+g_algorithm_timing_wheel_cancel (GAlgorithmTimingWheel       *wheel,
+                                 GAlgorithmTimingWheelHandle  handle)
+{
+  g_return_val_if_fail(wheel != NULL, FALSE);
+
+  guint64 index_plus_one = handle & G_MAXUINT32;
+  guint32 generation = handle >> 32;
+
+  if (index_plus_one == 0 || index_plus_one > wheel->nodes->len)
+    return FALSE;
+
+  guint32 index = index_plus_one - 1;
+  TimerNode *node = timer_node (wheel, index);
+
+  if (node->generation != generation || node->slot == NOT_SCHEDULED)
+    return FALSE;
+
+  slot_unlink (wheel, index);
+  timer_node_release (wheel, index);
+  wheel->n_timers--;
+
+  return TRUE;
+}
+
+/**
+ * g_algorithm_timing_wheel_advance:
+ * @wheel: A #GAlgorithmTimingWheel.
+ * @now: The new current time, in ticks.
+ * @expired: (element-type gpointer) (nullable): A #GPtrArray to append
+ *           the data of every expired timer to, or %NULL.
+ *
+ * Move the current time of @wheel forward to @now, expiring every
+ * timer whose expiry is at or before @now. Timers are appended to
+ * @expired in order of expiry, though timers expiring on the same tick
+ * are in no particular order.
+ *
+ * Each timer is moved down at most once per level, and empty stretches
+ * of each level are skipped over, so advancing costs amortized O(1)
+ * per timer no matter how much time has passed.
+ *
+ * Returns: The number of timers that expired.
+ */
+size_t
+g_algorithm_timing_wheel_advance (GAlgorithmTimingWheel *wheel,
+                                  guint64                now,
+                                  GPtrArray             *expired)
+{
+  g_return_val_if_fail(wheel != NULL, 0);
+
+  size_t n_expired = 0;
+
+  while (wheel->now < now)
+    {
+      /* With nothing scheduled, there is nothing to keep in step */
+      if (wheel->n_timers == 0)
+        {
+          wheel->now = now;
+          break;
+        }
+
+      guint64 tick = wheel->now + 1;
+
+      if (wheel->occupied[0] == 0)
+        {
+          tick = timing_wheel_next_cascade (wheel);
+        }
+      else if ((tick & SLOT_MASK) != 0)
+        {
+          /* Skip straight to the next occupied slot of the bottom
+           * level, or to the start of the next rotation */
+          guint64 pending = wheel->occupied[0] >> (tick & SLOT_MASK);
+
+          if (pending == 0)
+            tick = (tick | SLOT_MASK) + 1;
+          else
+            tick += lowest_bit (pending);
+        }
+
+      if (tick > now)
+        {
+          wheel->now = now;
+          break;
+        }
+
+      if ((tick & SLOT_MASK) == 0)
+        timing_wheel_cascade (wheel, tick);
+
+      n_expired += timing_wheel_expire_slot (wheel, tick & SLOT_MASK, expired);
+      wheel->now = tick;
+    }
+
+  return n_expired;
+}
+
+/**
+ * g_algorithm_timing_wheel_get_time:
+ * @wheel: A #GAlgorithmTimingWheel.
+ *
+ * Get the current time of @wheel, which is the time it was created at
+ * or last advanced to.
+ *
+ * Returns: The current time of @wheel, in ticks.
+ */
+guint64
+g_algorithm_timing_wheel_get_time (GAlgorithmTimingWheel *wheel)
+{
+  g_return_val_if_fail(wheel != NULL, 0);
+
+  return wheel->now;
+}
+
+/**
+ * g_algorithm_timing_wheel_get_length:
+ * @wheel: A #GAlgorithmTimingWheel.
+ *
+ * Get the number of timers scheduled on @wheel.
+ *
+ * Returns: The number of scheduled timers.
+ */
+size_t
+g_algorithm_timing_wheel_get_length (GAlgorithmTimingWheel *wheel)
+{
+  g_return_val_if_fail(wheel != NULL, 0);
+
+  return wheel->n_timers;
+}
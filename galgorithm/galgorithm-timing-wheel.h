@@ -0,0 +1,70 @@
+/*
+ * /galgorithm/galgorithm-timing-wheel.h
+ *
+ * Forward declarations for GAlgorithm Timing Wheel.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+#define G_ALGORITHM_TYPE_TIMING_WHEEL (g_algorithm_timing_wheel_get_type ())
+
+typedef struct _GAlgorithmTimingWheel GAlgorithmTimingWheel;
+
+/**
+ * GAlgorithmTimingWheelHandle:
+ *
+ * Identifies a timer scheduled on a #GAlgorithmTimingWheel, so that it
+ * can be cancelled. Handles are checked before they are used, so it
+ * is safe to cancel a timer that already expired or was cancelled.
+ * Zero is never a valid handle.
+ */
+typedef guint64 GAlgorithmTimingWheelHandle;
+
+GType g_algorithm_timing_wheel_get_type (void);
+
+GAlgorithmTimingWheel * g_algorithm_timing_wheel_new (guint64 now);
+
+GAlgorithmTimingWheel * g_algorithm_timing_wheel_ref (GAlgorithmTimingWheel *wheel);
+
+void g_algorithm_timing_wheel_unref (GAlgorithmTimingWheel *wheel);
+
+GAlgorithmTimingWheelHandle g_algorithm_timing_wheel_schedule (GAlgorithmTimingWheel *wheel,
+                                                               guint64                expiry,
+                                                               gpointer               data);
+
+gboolean g_algorithm_timing_wheel_cancel (GAlgorithmTimingWheel       *wheel,
+                                          GAlgorithmTimingWheelHandle  handle);
+
+size_t g_algorithm_timing_wheel_advance (GAlgorithmTimingWheel *wheel,
+                                         guint64                now,
+                                         GPtrArray             *expired);
+
+guint64 g_algorithm_timing_wheel_get_time (GAlgorithmTimingWheel *wheel);
+
+size_t g_algorithm_timing_wheel_get_length (GAlgorithmTimingWheel *wheel);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GAlgorithmTimingWheel, g_algorithm_timing_wheel_unref)
+
+G_END_DECLS
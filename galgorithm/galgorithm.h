@@ -24,5 +24,23 @@
 
 #include <glib.h>
 
+#include <galgorithm/galgorithm-accessor.h>
+#include <galgorithm/galgorithm-argsort.h>
+#include <galgorithm/galgorithm-async.h>
 #include <galgorithm/galgorithm-binary-search.h>
+#include <galgorithm/galgorithm-bloom-filter.h>
+#include <galgorithm/galgorithm-incremental-sort.h>
 #include <galgorithm/galgorithm-merge-sort.h>
+#include <galgorithm/galgorithm-min-max-heap.h>
+#include <galgorithm/galgorithm-pairing-heap.h>
+#include <galgorithm/galgorithm-primitive-sort.h>
+#include <galgorithm/galgorithm-quicksort.h>
+#include <galgorithm/galgorithm-radix-sort.h>
+#include <galgorithm/galgorithm-set-operations.h>
+#include <galgorithm/galgorithm-sort-spec.h>
+#include <galgorithm/galgorithm-sort.h>
+#include <galgorithm/galgorithm-sorted-container.h>
+#include <galgorithm/galgorithm-sorted-index-file.h>
+#include <galgorithm/galgorithm-stats.h>
+#include <galgorithm/galgorithm-string-sort.h>
+#include <galgorithm/galgorithm-timing-wheel.h>
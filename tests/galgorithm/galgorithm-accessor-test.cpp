@@ -0,0 +1,349 @@
+/*
+ * /tests/galgorithm/galgorithm-accessor-test.cpp
+ *
+ * Tests for the GAlgorithm Accessor.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-accessor.h>
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::Gt;
+
+G_BEGIN_DECLS
+
+/* A model which makes a new item every time it is asked for one, so
+ * its items only live as long as their callers' references */
+#define TEST_TYPE_ON_DEMAND_MODEL (test_on_demand_model_get_type ())
+G_DECLARE_FINAL_TYPE (TestOnDemandModel, test_on_demand_model, TEST, ON_DEMAND_MODEL, GObject)
+
+struct _TestOnDemandModel {
+  GObject parent_instance;
+
+  guint   n_items;
+};
+
+static void test_on_demand_model_list_model_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (TestOnDemandModel, test_on_demand_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL,
+                                                test_on_demand_model_list_model_init))
+
+G_END_DECLS
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  size_t item_value (gconstpointer item)
+  {
+    return GPOINTER_TO_SIZE (g_object_get_data (G_OBJECT (item), "value"));
+  }
+
+  int item_compare (gconstpointer a, gconstpointer b)
+  {
+    return ptr_compare (GSIZE_TO_POINTER (item_value (a)), GSIZE_TO_POINTER (item_value (b)));
+  }
+
+  std::vector <size_t> random_values (size_t n, unsigned int seed)
+  {
+    std::mt19937 rng (seed);
+    std::vector <size_t> values;
+
+    /* Plenty of duplicates */
+    for (size_t i = 0; i < n; ++i)
+      values.push_back (rng () % (n / 4 + 1) + 1);
+
+    return values;
+  }
+
+  GListStore * list_store_from_values (const std::vector <size_t> &values)
+  {
+    GListStore *store = g_list_store_new (G_TYPE_OBJECT);
+
+    for (size_t value : values)
+      {
+        g_autoptr(GObject) item = G_OBJECT (g_object_new (G_TYPE_OBJECT, NULL));
+
+        g_object_set_data (item, "value", GSIZE_TO_POINTER (value));
+        g_list_store_append (store, item);
+      }
+
+    return store;
+  }
+
+  std::vector <size_t> list_store_values (GListStore *store)
+  {
+    std::vector <size_t> values;
+
+    for (guint i = 0; i < g_list_model_get_n_items (G_LIST_MODEL (store)); ++i)
+      {
+        g_autoptr(GObject) item = G_OBJECT (g_list_model_get_item (G_LIST_MODEL (store), i));
+
+        values.push_back (item_value (item));
+      }
+
+    return values;
+  }
+
+  guint on_demand_items_alive = 0;
+
+  void on_demand_item_finalized (gpointer  data,
+                                 GObject  *where_the_object_was)
+  {
+    on_demand_items_alive--;
+  }
+
+  GType test_on_demand_model_get_item_type (GListModel *list)
+  {
+    return G_TYPE_OBJECT;
+  }
+
+  guint test_on_demand_model_get_n_items (GListModel *list)
+  {
+    return TEST_ON_DEMAND_MODEL (list)->n_items;
+  }
+
+  gpointer test_on_demand_model_get_item (GListModel *list,
+                                          guint       position)
+  {
+    if (position >= TEST_ON_DEMAND_MODEL (list)->n_items)
+      return NULL;
+
+    GObject *item = G_OBJECT (g_object_new (G_TYPE_OBJECT, NULL));
+
+    g_object_set_data (item, "value", GSIZE_TO_POINTER ((position + 1) * 2));
+    g_object_weak_ref (item, on_demand_item_finalized, NULL);
+    on_demand_items_alive++;
+
+    return item;
+  }
+
+  int on_demand_item_compare (gconstpointer a, gconstpointer b)
+  {
+    /* At least the item from the model must still be alive */
+    EXPECT_THAT (on_demand_items_alive, Gt(0u));
+
+    return item_compare (a, b);
+  }
+
+  struct ItemsChanged {
+    unsigned int n_emissions;
+    guint        position;
+    guint        removed;
+    guint        added;
+  };
+
+  void on_items_changed (GListModel   *model,
+                         guint         position,
+                         guint         removed,
+                         guint         added,
+                         ItemsChanged *changed)
+  {
+    changed->n_emissions++;
+    changed->position = position;
+    changed->removed = removed;
+    changed->added = added;
+  }
+
+  TEST (GAlgorithmAccessor, sort_ptr_array) {
+    std::vector <size_t> values = random_values (1000, 1);
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    for (size_t value : values)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (value));
+
+    g_algorithm_accessor_sort (g_algorithm_accessor_for_ptr_array (), array, ptr_compare);
+    std::sort (values.begin (), values.end ());
+
+    for (size_t i = 0; i < values.size (); ++i)
+      EXPECT_THAT (GPOINTER_TO_SIZE (array->pdata[i]), Eq(values[i]));
+  }
+
+  TEST (GAlgorithmAccessor, sort_and_search_sequence) {
+    std::vector <size_t> values = random_values (500, 2);
+    GSequence *sequence = g_sequence_new (NULL);
+
+    for (size_t value : values)
+      g_sequence_append (sequence, GSIZE_TO_POINTER (value));
+
+    g_algorithm_accessor_sort (g_algorithm_accessor_for_sequence (), sequence, ptr_compare);
+    std::sort (values.begin (), values.end ());
+
+    for (size_t i = 0; i < values.size (); ++i)
+      EXPECT_THAT (GPOINTER_TO_SIZE (g_sequence_get (g_sequence_get_iter_at_pos (sequence, i))),
+                   Eq(values[i]));
+
+    int64_t found = g_algorithm_accessor_binary_search (g_algorithm_accessor_for_sequence (),
+                                                        sequence,
+                                                        GSIZE_TO_POINTER (values[123]),
+                                                        ptr_compare);
+
+    EXPECT_THAT (values[found], Eq(values[123]));
+    EXPECT_THAT (g_algorithm_accessor_binary_search (g_algorithm_accessor_for_sequence (),
+                                                     sequence,
+                                                     GSIZE_TO_POINTER (values.back () + 1),
+                                                     ptr_compare),
+                 Eq(-1));
+
+    g_sequence_free (sequence);
+  }
+
+  TEST (GAlgorithmAccessor, sort_sequence_keeps_elements) {
+    /* Sorting swaps elements, so none of them are handed to the
+     * sequence's destroy function */
+    GSequence *sequence = g_sequence_new (g_free);
+
+    for (int i = 40; i > 0; --i)
+      g_sequence_append (sequence, g_strdup_printf ("%02d", i));
+
+    g_algorithm_accessor_sort (g_algorithm_accessor_for_sequence (),
+                               sequence,
+                               reinterpret_cast <GAlgorithmCompareFunc> (g_strcmp0));
+
+    EXPECT_THAT (g_sequence_get_length (sequence), Eq(40));
+    EXPECT_STREQ (static_cast <const char *> (g_sequence_get (g_sequence_get_iter_at_pos (sequence, 0))), "01");
+    EXPECT_STREQ (static_cast <const char *> (g_sequence_get (g_sequence_get_iter_at_pos (sequence, 39))), "40");
+
+    g_sequence_free (sequence);
+  }
+
+  TEST (GAlgorithmAccessor, search_list_model) {
+    g_autoptr(GListStore) store = list_store_from_values ({ 2, 4, 6, 8, 10 });
+    g_autoptr(GObject) needle = G_OBJECT (g_object_new (G_TYPE_OBJECT, NULL));
+    const GAlgorithmAccessor *accessor = g_algorithm_accessor_for_list_model ();
+
+    g_object_set_data (needle, "value", GSIZE_TO_POINTER (8));
+    EXPECT_THAT (g_algorithm_accessor_binary_search (accessor, store, needle, item_compare), Eq(3));
+
+    g_object_set_data (needle, "value", GSIZE_TO_POINTER (5));
+    EXPECT_THAT (g_algorithm_accessor_binary_search (accessor, store, needle, item_compare), Eq(-1));
+  }
+
+  TEST (GAlgorithmAccessor, search_list_model_with_items_made_on_demand) {
+    g_autoptr(TestOnDemandModel) model = TEST_ON_DEMAND_MODEL (g_object_new (TEST_TYPE_ON_DEMAND_MODEL, NULL));
+    g_autoptr(GObject) needle = G_OBJECT (g_object_new (G_TYPE_OBJECT, NULL));
+    const GAlgorithmAccessor *accessor = g_algorithm_accessor_for_list_model ();
+
+    model->n_items = 100;
+
+    g_object_set_data (needle, "value", GSIZE_TO_POINTER (64));
+    EXPECT_THAT (g_algorithm_accessor_binary_search (accessor, model, needle, on_demand_item_compare), Eq(31));
+
+    g_object_set_data (needle, "value", GSIZE_TO_POINTER (65));
+    EXPECT_THAT (g_algorithm_accessor_binary_search (accessor, model, needle, on_demand_item_compare), Eq(-1));
+
+    /* Every item fetched was released again */
+    EXPECT_THAT (on_demand_items_alive, Eq(0u));
+  }
+
+  TEST (GAlgorithmAccessor, sort_list_store_emits_once) {
+    std::vector <size_t> values = random_values (1000, 3);
+    g_autoptr(GListStore) store = list_store_from_values (values);
+    ItemsChanged changed = { 0, 0, 0, 0 };
+
+    g_signal_connect (store, "items-changed", G_CALLBACK (on_items_changed), &changed);
+    g_algorithm_accessor_sort_list_store (store, item_compare);
+    std::sort (values.begin (), values.end ());
+
+    EXPECT_THAT (list_store_values (store), ElementsAreArray(values));
+    EXPECT_THAT (changed.n_emissions, Eq(1u));
+    EXPECT_THAT (changed.removed, Eq(changed.added));
+  }
+
+  TEST (GAlgorithmAccessor, sort_list_store_only_splices_moved_range) {
+    g_autoptr(GListStore) store = list_store_from_values ({ 1, 2, 5, 4, 3, 6, 7 });
+    ItemsChanged changed = { 0, 0, 0, 0 };
+
+    g_signal_connect (store, "items-changed", G_CALLBACK (on_items_changed), &changed);
+    g_algorithm_accessor_sort_list_store (store, item_compare);
+
+    EXPECT_THAT (list_store_values (store), ElementsAre(1, 2, 3, 4, 5, 6, 7));
+    EXPECT_THAT (changed.n_emissions, Eq(1u));
+    EXPECT_THAT (changed.position, Eq(2u));
+    EXPECT_THAT (changed.removed, Eq(3u));
+    EXPECT_THAT (changed.added, Eq(3u));
+
+    /* Already sorted, so nothing to announce */
+    g_algorithm_accessor_sort_list_store (store, item_compare);
+    EXPECT_THAT (changed.n_emissions, Eq(1u));
+  }
+
+  TEST (GAlgorithmAccessor, sort_list_store_with_duplicates_is_stable) {
+    std::vector <size_t> values = random_values (1000, 4);
+    g_autoptr(GListStore) store = list_store_from_values (values);
+    std::vector <GObject *> items;
+    ItemsChanged changed = { 0, 0, 0, 0 };
+
+    for (guint i = 0; i < values.size (); ++i)
+      {
+        g_autoptr(GObject) item = G_OBJECT (g_list_model_get_item (G_LIST_MODEL (store), i));
+
+        items.push_back (item);
+      }
+
+    g_signal_connect (store, "items-changed", G_CALLBACK (on_items_changed), &changed);
+    g_algorithm_accessor_sort_list_store (store, item_compare);
+    g_algorithm_accessor_sort_list_store (store, item_compare);
+
+    EXPECT_THAT (changed.n_emissions, Eq(1u));
+
+    /* Equal items keep the order they were added in */
+    std::stable_sort (items.begin (), items.end (),
+                      [] (GObject *a, GObject *b) { return item_value (a) < item_value (b); });
+
+    for (guint i = 0; i < items.size (); ++i)
+      {
+        g_autoptr(GObject) item = G_OBJECT (g_list_model_get_item (G_LIST_MODEL (store), i));
+
+        EXPECT_THAT (item, Eq(items[i]));
+      }
+  }
+}
+
+static void
+test_on_demand_model_list_model_init (GListModelInterface *iface)
+{
+  iface->get_item_type = test_on_demand_model_get_item_type;
+  iface->get_n_items = test_on_demand_model_get_n_items;
+  iface->get_item = test_on_demand_model_get_item;
+}
+
+static void
+test_on_demand_model_class_init (TestOnDemandModelClass *klass)
+{
+}
+
+static void
+test_on_demand_model_init (TestOnDemandModel *model)
+{
+}
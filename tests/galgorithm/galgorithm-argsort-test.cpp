@@ -0,0 +1,144 @@
+/*
+ * /tests/galgorithm/galgorithm-argsort-test.cpp
+ *
+ * Tests for the GAlgorithm argsort and permutation functions.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-argsort.h>
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  /* Compare by tens, so that elements in the same ten are equal */
+  int tens_compare (gconstpointer a, gconstpointer b)
+  {
+    return ptr_compare (GSIZE_TO_POINTER (GPOINTER_TO_SIZE (a) / 10),
+                        GSIZE_TO_POINTER (GPOINTER_TO_SIZE (b) / 10));
+  }
+
+  template <typename T>
+  std::vector <T> vector_from_array (GArray *array)
+  {
+    T *data = reinterpret_cast <T *> (array->data);
+    return std::vector <T> (data, data + array->len);
+  }
+
+  template <typename... Args>
+  void insert_into_ptr_array (GPtrArray *array, Args... args)
+  {
+    size_t elements[] = { static_cast <size_t> (args)... };
+
+    for (size_t element : elements)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (element));
+  }
+
+  TEST (GAlgorithmArgsort, argsort_empty_array) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    g_autoptr(GArray) permutation = g_algorithm_argsort (array, ptr_compare);
+
+    EXPECT_THAT (vector_from_array <guint32> (permutation), IsEmpty ());
+  }
+
+  TEST (GAlgorithmArgsort, argsort_five_elements) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    insert_into_ptr_array (array, 20, 10, 50, 40, 30);
+
+    g_autoptr(GArray) permutation = g_algorithm_argsort (array, ptr_compare);
+
+    EXPECT_THAT (vector_from_array <guint32> (permutation),
+                 ElementsAre (1u, 0u, 4u, 3u, 2u));
+  }
+
+  TEST (GAlgorithmArgsort, argsort_many_elements) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < 5000; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (engine () % 1000));
+
+    g_autoptr(GArray) permutation = g_algorithm_argsort (array, ptr_compare);
+    std::vector <guint32> indices (vector_from_array <guint32> (permutation));
+    std::vector <size_t> sorted;
+
+    for (guint32 index : indices)
+      sorted.push_back (GPOINTER_TO_SIZE (array->pdata[index]));
+
+    std::sort (indices.begin (), indices.end ());
+    EXPECT_TRUE (std::is_sorted (sorted.begin (), sorted.end ()));
+    EXPECT_TRUE (std::adjacent_find (indices.begin (), indices.end ()) == indices.end ());
+  }
+
+  TEST (GAlgorithmArgsort, argsort_stable_keeps_equal_elements_in_order) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    std::vector <guint32> expected;
+
+    for (size_t i = 0; i < 100; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER ((i * 37) % 100));
+
+    expected.resize (array->len);
+    std::iota (expected.begin (), expected.end (), 0);
+    std::stable_sort (expected.begin (), expected.end (), [&](guint32 a, guint32 b) {
+      return tens_compare (array->pdata[a], array->pdata[b]) < 0;
+    });
+
+    g_autoptr(GArray) permutation = g_algorithm_argsort_stable (array, tens_compare);
+
+    EXPECT_THAT (vector_from_array <guint32> (permutation),
+                 ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmArgsort, apply_permutation_to_parallel_arrays) {
+    g_autoptr(GPtrArray) keys = g_ptr_array_new ();
+    g_autoptr(GArray) column = g_array_new (FALSE, FALSE, sizeof (gdouble));
+    gdouble values[] = { 2.0, 1.0, 5.0, 4.0, 3.0 };
+
+    insert_into_ptr_array (keys, 20, 10, 50, 40, 30);
+    g_array_append_vals (column, values, G_N_ELEMENTS (values));
+
+    g_autoptr(GArray) permutation = g_algorithm_argsort_stable (keys, ptr_compare);
+    g_algorithm_apply_permutation_ptr_array (keys, permutation);
+    g_algorithm_apply_permutation_array (column, permutation);
+
+    EXPECT_THAT (std::vector <gpointer> (keys->pdata, keys->pdata + keys->len),
+                 ElementsAre (GSIZE_TO_POINTER (10),
+                              GSIZE_TO_POINTER (20),
+                              GSIZE_TO_POINTER (30),
+                              GSIZE_TO_POINTER (40),
+                              GSIZE_TO_POINTER (50)));
+    EXPECT_THAT (vector_from_array <gdouble> (column),
+                 ElementsAre (1.0, 2.0, 3.0, 4.0, 5.0));
+  }
+}
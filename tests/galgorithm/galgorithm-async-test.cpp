@@ -0,0 +1,264 @@
+/*
+ * /tests/galgorithm/galgorithm-async-test.cpp
+ *
+ * Tests for the asynchronous GAlgorithm sorts.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-async.h>
+
+using ::testing::Eq;
+using ::testing::ElementsAreArray;
+using ::testing::Gt;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  int ptr_compare_data (gconstpointer a, gconstpointer b, gpointer user_data)
+  {
+    return ptr_compare (a, b);
+  }
+
+  /* Comparator data which checks that it is used for every comparison
+   * and destroyed exactly once, the way a binding's closure would be */
+  struct CompareClosure {
+    gint n_calls = 0;
+    gint n_destroys = 0;
+
+    static int compare (gconstpointer a, gconstpointer b, gpointer user_data)
+    {
+      auto closure = static_cast <CompareClosure *> (user_data);
+
+      EXPECT_THAT (g_atomic_int_get (&closure->n_destroys), Eq (0));
+      g_atomic_int_inc (&closure->n_calls);
+      return ptr_compare (a, b);
+    }
+
+    static void destroy (gpointer user_data)
+    {
+      g_atomic_int_inc (&static_cast <CompareClosure *> (user_data)->n_destroys);
+    }
+  };
+
+  struct AsyncResultHolder {
+    GAsyncResult *result = nullptr;
+
+    ~AsyncResultHolder () {
+      g_clear_object (&result);
+    }
+
+    static void store (GObject      *source,
+                       GAsyncResult *result,
+                       gpointer      user_data)
+    {
+      auto holder = static_cast <AsyncResultHolder *> (user_data);
+      holder->result = G_ASYNC_RESULT (g_object_ref (result));
+    }
+
+    GAsyncResult * wait () {
+      while (result == nullptr)
+        g_main_context_iteration (NULL, TRUE);
+
+      return result;
+    }
+  };
+
+  void record_progress (gdouble fraction, gpointer user_data)
+  {
+    static_cast <std::vector <gdouble> *> (user_data)->push_back (fraction);
+  }
+
+  GPtrArray * random_ptr_array (std::vector <gpointer> &elements, size_t size)
+  {
+    GPtrArray *array = g_ptr_array_new ();
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < size; ++i)
+      {
+        gpointer element = GSIZE_TO_POINTER (1 + engine () % 100000);
+        g_ptr_array_add (array, element);
+        elements.push_back (element);
+      }
+
+    return array;
+  }
+
+  std::vector <gpointer> ptr_array_to_vector (GPtrArray *array)
+  {
+    return std::vector <gpointer> (array->pdata, array->pdata + array->len);
+  }
+
+  TEST (GAlgorithmAsync, merge_sort_async_sorts_array) {
+    std::vector <gpointer> expected;
+    std::vector <gdouble> progress;
+    g_autoptr(GPtrArray) array = random_ptr_array (expected, 200000);
+    g_autoptr(GError) error = NULL;
+    AsyncResultHolder holder;
+
+    g_algorithm_merge_sort_async (array,
+                                  ptr_compare_data,
+                                  NULL,
+                                  NULL,
+                                  record_progress,
+                                  &progress,
+                                  NULL,
+                                  NULL,
+                                  AsyncResultHolder::store,
+                                  &holder);
+
+    EXPECT_TRUE (g_algorithm_merge_sort_finish (holder.wait (), &error));
+    EXPECT_THAT (error, Eq (nullptr));
+
+    std::sort (expected.begin (), expected.end ());
+    EXPECT_THAT (ptr_array_to_vector (array), ElementsAreArray (expected));
+    EXPECT_TRUE (std::is_sorted (progress.begin (), progress.end ()));
+
+    /* The completion callback might run before the last progress
+     * update has been dispatched, so flush them first */
+    while (g_main_context_iteration (NULL, FALSE));
+    EXPECT_THAT (progress.back (), Eq (1.0));
+  }
+
+  TEST (GAlgorithmAsync, merge_sort_async_cancelled_keeps_all_elements) {
+    std::vector <gpointer> expected;
+    g_autoptr(GPtrArray) array = random_ptr_array (expected, 200000);
+    g_autoptr(GCancellable) cancellable = g_cancellable_new ();
+    g_autoptr(GError) error = NULL;
+    AsyncResultHolder holder;
+
+    g_cancellable_cancel (cancellable);
+    g_algorithm_merge_sort_async (array,
+                                  ptr_compare_data,
+                                  NULL,
+                                  NULL,
+                                  NULL,
+                                  NULL,
+                                  NULL,
+                                  cancellable,
+                                  AsyncResultHolder::store,
+                                  &holder);
+
+    EXPECT_FALSE (g_algorithm_merge_sort_finish (holder.wait (), &error));
+    EXPECT_TRUE (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED));
+
+    std::vector <gpointer> elements (ptr_array_to_vector (array));
+    std::sort (elements.begin (), elements.end ());
+    std::sort (expected.begin (), expected.end ());
+    EXPECT_THAT (elements, ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmAsync, quicksort_async_sorts_array) {
+    std::vector <gpointer> expected;
+    g_autoptr(GPtrArray) array = random_ptr_array (expected, 200000);
+    g_autoptr(GError) error = NULL;
+    AsyncResultHolder holder;
+
+    g_algorithm_quicksort_async (array,
+                                 ptr_compare_data,
+                                 NULL,
+                                 NULL,
+                                 G_ALGORITHM_QUICKSORT_PARTITION_BLOCK,
+                                 NULL,
+                                 NULL,
+                                 NULL,
+                                 NULL,
+                                 AsyncResultHolder::store,
+                                 &holder);
+
+    EXPECT_TRUE (g_algorithm_quicksort_finish (holder.wait (), &error));
+    EXPECT_THAT (error, Eq (nullptr));
+
+    std::sort (expected.begin (), expected.end ());
+    EXPECT_THAT (ptr_array_to_vector (array), ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmAsync, async_sorts_use_notified_comparator) {
+    for (bool use_quicksort : { false, true })
+      {
+        std::vector <gpointer> expected;
+        g_autoptr(GPtrArray) array = random_ptr_array (expected, 10000);
+        g_autoptr(GError) error = NULL;
+        CompareClosure closure;
+
+        {
+          AsyncResultHolder holder;
+
+          if (use_quicksort)
+            g_algorithm_quicksort_async (array,
+                                         CompareClosure::compare,
+                                         &closure,
+                                         CompareClosure::destroy,
+                                         G_ALGORITHM_QUICKSORT_PARTITION_LOMUTO,
+                                         NULL,
+                                         NULL,
+                                         NULL,
+                                         NULL,
+                                         AsyncResultHolder::store,
+                                         &holder);
+          else
+            g_algorithm_merge_sort_async (array,
+                                          CompareClosure::compare,
+                                          &closure,
+                                          CompareClosure::destroy,
+                                          NULL,
+                                          NULL,
+                                          NULL,
+                                          NULL,
+                                          AsyncResultHolder::store,
+                                          &holder);
+
+          GAsyncResult *result = holder.wait ();
+
+          EXPECT_TRUE (use_quicksort ?
+                       g_algorithm_quicksort_finish (result, &error) :
+                       g_algorithm_merge_sort_finish (result, &error));
+        }
+
+        /* The worker thread might drop the last reference on the task,
+         * and with it the comparator data, a moment after the result
+         * has been delivered */
+        gint64 deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+
+        while (g_atomic_int_get (&closure.n_destroys) == 0 &&
+               g_get_monotonic_time () < deadline)
+          {
+            while (g_main_context_iteration (NULL, FALSE));
+            g_usleep (1000);
+          }
+
+        EXPECT_THAT (error, Eq (nullptr));
+        EXPECT_THAT (g_atomic_int_get (&closure.n_calls), Gt (1));
+        EXPECT_THAT (g_atomic_int_get (&closure.n_destroys), Eq (1));
+
+        std::sort (expected.begin (), expected.end ());
+        EXPECT_THAT (ptr_array_to_vector (array), ElementsAreArray (expected));
+      }
+  }
+}
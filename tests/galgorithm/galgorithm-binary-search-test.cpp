@@ -86,4 +86,14 @@ namespace {
 
     EXPECT_THAT (g_algorithm_binary_search (array, GINT_TO_POINTER(2), ptr_compare), Eq(2));
   }
+
+  TEST (GAlgorithmBinarySearch, search_missing_in_array) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    insert_into_ptr_array (array, 2, 4, 6, 8);
+
+    EXPECT_THAT (g_algorithm_binary_search (array, GINT_TO_POINTER(1), ptr_compare), Eq(-1));
+    EXPECT_THAT (g_algorithm_binary_search (array, GINT_TO_POINTER(5), ptr_compare), Eq(-1));
+    EXPECT_THAT (g_algorithm_binary_search (array, GINT_TO_POINTER(9), ptr_compare), Eq(-1));
+  }
 }
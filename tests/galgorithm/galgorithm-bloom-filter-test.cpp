@@ -0,0 +1,144 @@
+/*
+ * /tests/galgorithm/galgorithm-bloom-filter-test.cpp
+ *
+ * Tests for the GAlgorithm Bloom Filter.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-binary-search.h>
+#include <galgorithm/galgorithm-bloom-filter.h>
+
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Gt;
+using ::testing::Le;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  guint64 ptr_hash (gconstpointer element)
+  {
+    return static_cast <guint64> (GPOINTER_TO_SIZE (element));
+  }
+
+  /* Every even number from 2 up to 2 * n, so every odd number is absent */
+  GPtrArray * even_numbers (unsigned int n)
+  {
+    GPtrArray *array = g_ptr_array_sized_new (n);
+
+    for (unsigned int i = 1; i <= n; ++i)
+      g_ptr_array_add (array, GUINT_TO_POINTER (i * 2));
+
+    return array;
+  }
+
+  double measured_false_positive_rate (GAlgorithmBloomFilter *filter, unsigned int n)
+  {
+    unsigned int false_positives = 0;
+
+    for (unsigned int i = 0; i < n; ++i)
+      if (g_algorithm_bloom_filter_may_contain (filter, GUINT_TO_POINTER (i * 2 + 1)))
+        ++false_positives;
+
+    return static_cast <double> (false_positives) / n;
+  }
+
+  TEST (GAlgorithmBloomFilter, no_false_negatives) {
+    g_autoptr(GPtrArray) array = even_numbers (10000);
+    g_autoptr(GAlgorithmBloomFilter) filter = g_algorithm_bloom_filter_new (array, ptr_hash, 0.01);
+
+    for (unsigned int i = 0; i < array->len; ++i)
+      EXPECT_TRUE (g_algorithm_bloom_filter_may_contain (filter, array->pdata[i]));
+  }
+
+  TEST (GAlgorithmBloomFilter, false_positive_rate_near_target) {
+    g_autoptr(GPtrArray) array = even_numbers (100000);
+    g_autoptr(GAlgorithmBloomFilter) filter = g_algorithm_bloom_filter_new (array, ptr_hash, 0.01);
+    double rate = measured_false_positive_rate (filter, 1000000);
+
+    EXPECT_THAT (rate, Le(0.01));
+    EXPECT_THAT (rate, Ge(0.005));
+  }
+
+  TEST (GAlgorithmBloomFilter, lower_target_fewer_false_positives) {
+    g_autoptr(GPtrArray) array = even_numbers (100000);
+    g_autoptr(GAlgorithmBloomFilter) loose = g_algorithm_bloom_filter_new (array, ptr_hash, 0.05);
+    g_autoptr(GAlgorithmBloomFilter) tight = g_algorithm_bloom_filter_new (array, ptr_hash, 0.001);
+
+    double loose_rate = measured_false_positive_rate (loose, 1000000);
+    double tight_rate = measured_false_positive_rate (tight, 1000000);
+
+    EXPECT_THAT (loose_rate, Le(0.05));
+    EXPECT_THAT (loose_rate, Ge(0.025));
+    EXPECT_THAT (tight_rate, Le(0.001));
+    EXPECT_THAT (tight_rate, Ge(0.0005));
+  }
+
+  TEST (GAlgorithmBloomFilter, reports_memory_overhead) {
+    g_autoptr(GPtrArray) array = even_numbers (10000);
+    g_autoptr(GAlgorithmBloomFilter) loose = g_algorithm_bloom_filter_new (array, ptr_hash, 0.05);
+    g_autoptr(GAlgorithmBloomFilter) tight = g_algorithm_bloom_filter_new (array, ptr_hash, 0.001);
+
+    EXPECT_THAT (g_algorithm_bloom_filter_get_bits_per_element (tight),
+                 Gt(g_algorithm_bloom_filter_get_bits_per_element (loose)));
+    EXPECT_THAT (g_algorithm_bloom_filter_get_size (tight),
+                 Gt(g_algorithm_bloom_filter_get_size (loose)));
+
+    /* The size covers at least the bits themselves */
+    EXPECT_THAT (g_algorithm_bloom_filter_get_size (tight) * 8,
+                 Gt(g_algorithm_bloom_filter_get_bits_per_element (tight) * array->len));
+  }
+
+  TEST (GAlgorithmBloomFilter, empty_array) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    g_autoptr(GAlgorithmBloomFilter) filter = g_algorithm_bloom_filter_new (array, ptr_hash, 0.01);
+
+    EXPECT_FALSE (g_algorithm_bloom_filter_may_contain (filter, GUINT_TO_POINTER (1)));
+    EXPECT_THAT (g_algorithm_bloom_filter_get_bits_per_element (filter), Eq(0.0));
+  }
+
+  TEST (GAlgorithmBloomFilter, binary_search_with_filter) {
+    g_autoptr(GPtrArray) array = even_numbers (1000);
+    g_autoptr(GAlgorithmBloomFilter) filter = g_algorithm_bloom_filter_new (array, ptr_hash, 0.01);
+
+    for (unsigned int i = 0; i <= 2002; ++i)
+      {
+        int64_t expected = g_algorithm_binary_search (array, GUINT_TO_POINTER (i), ptr_compare);
+
+        EXPECT_THAT (g_algorithm_binary_search_with_filter (array,
+                                                            GUINT_TO_POINTER (i),
+                                                            ptr_compare,
+                                                            filter),
+                     Eq(expected));
+        EXPECT_THAT (g_algorithm_binary_search_with_filter (array,
+                                                            GUINT_TO_POINTER (i),
+                                                            ptr_compare,
+                                                            NULL),
+                     Eq(expected));
+      }
+  }
+}
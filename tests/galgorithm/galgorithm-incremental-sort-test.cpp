@@ -0,0 +1,139 @@
+/*
+ * /tests/galgorithm/galgorithm-incremental-sort-test.cpp
+ *
+ * Tests for the GAlgorithm Incremental Sort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-incremental-sort.h>
+
+using ::testing::Eq;
+using ::testing::ElementsAreArray;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  GPtrArray * random_ptr_array (std::vector <gpointer> &elements, size_t size)
+  {
+    GPtrArray *array = g_ptr_array_new ();
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < size; ++i)
+      {
+        gpointer element = GSIZE_TO_POINTER (1 + engine () % 100000);
+        g_ptr_array_add (array, element);
+        elements.push_back (element);
+      }
+
+    return array;
+  }
+
+  std::vector <gpointer> ptr_array_to_vector (GPtrArray *array)
+  {
+    return std::vector <gpointer> (array->pdata, array->pdata + array->len);
+  }
+
+  void mark_done (GAlgorithmIncrementalSort *sort, gpointer user_data)
+  {
+    *static_cast <gboolean *> (user_data) = TRUE;
+  }
+
+  TEST (GAlgorithmIncrementalSort, stepping_sorts_array) {
+    std::vector <gpointer> expected;
+    std::vector <gdouble> progress;
+    g_autoptr(GPtrArray) array = random_ptr_array (expected, 10000);
+    g_autoptr(GAlgorithmIncrementalSort) sort = g_algorithm_incremental_sort_new (array,
+                                                                                 ptr_compare);
+
+    progress.push_back (g_algorithm_incremental_sort_get_progress (sort));
+    while (g_algorithm_incremental_sort_step (sort, 1000, 0))
+      progress.push_back (g_algorithm_incremental_sort_get_progress (sort));
+
+    EXPECT_TRUE (g_algorithm_incremental_sort_is_done (sort));
+    EXPECT_THAT (g_algorithm_incremental_sort_get_progress (sort), Eq (1.0));
+    EXPECT_TRUE (std::is_sorted (progress.begin (), progress.end ()));
+
+    EXPECT_GT (progress.size (), 100u);
+
+    std::sort (expected.begin (), expected.end ());
+    EXPECT_THAT (ptr_array_to_vector (array), ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmIncrementalSort, unlimited_step_sorts_everything) {
+    std::vector <gpointer> expected;
+    g_autoptr(GPtrArray) array = random_ptr_array (expected, 10000);
+    g_autoptr(GAlgorithmIncrementalSort) sort = g_algorithm_incremental_sort_new (array,
+                                                                                 ptr_compare);
+
+    EXPECT_FALSE (g_algorithm_incremental_sort_step (sort, 0, 0));
+    EXPECT_FALSE (g_algorithm_incremental_sort_step (sort, 0, 0));
+
+    std::sort (expected.begin (), expected.end ());
+    EXPECT_THAT (ptr_array_to_vector (array), ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmIncrementalSort, unref_before_done_keeps_all_elements) {
+    std::vector <gpointer> expected;
+    g_autoptr(GPtrArray) array = random_ptr_array (expected, 10000);
+    GAlgorithmIncrementalSort *sort = g_algorithm_incremental_sort_new (array, ptr_compare);
+
+    EXPECT_TRUE (g_algorithm_incremental_sort_step (sort, 25000, 0));
+    g_algorithm_incremental_sort_unref (sort);
+
+    std::vector <gpointer> elements (ptr_array_to_vector (array));
+    std::sort (elements.begin (), elements.end ());
+    std::sort (expected.begin (), expected.end ());
+    EXPECT_THAT (elements, ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmIncrementalSort, attached_source_sorts_array) {
+    std::vector <gpointer> expected;
+    g_autoptr(GPtrArray) array = random_ptr_array (expected, 100000);
+    g_autoptr(GMainContext) context = g_main_context_new ();
+    g_autoptr(GAlgorithmIncrementalSort) sort = g_algorithm_incremental_sort_new (array,
+                                                                                 ptr_compare);
+    gboolean done = FALSE;
+    g_autoptr(GSource) source = g_algorithm_incremental_sort_attach (sort,
+                                                                     context,
+                                                                     1000,
+                                                                     mark_done,
+                                                                     &done,
+                                                                     NULL);
+
+    while (!done)
+      g_main_context_iteration (context, TRUE);
+
+    EXPECT_TRUE (g_algorithm_incremental_sort_is_done (sort));
+    EXPECT_TRUE (g_source_is_destroyed (source));
+
+    std::sort (expected.begin (), expected.end ());
+    EXPECT_THAT (ptr_array_to_vector (array), ElementsAreArray (expected));
+  }
+}
@@ -125,4 +125,64 @@ namespace {
                               GINT_TO_POINTER (4),
                               GINT_TO_POINTER (5)));
   }
+
+  size_t key_func_calls = 0;
+  size_t key_destroy_calls = 0;
+
+  /* Group elements into tens, so that elements in the same
+   * group compare equal */
+  gpointer tens_key (gconstpointer element)
+  {
+    ++key_func_calls;
+    return GSIZE_TO_POINTER (GPOINTER_TO_SIZE (element) / 10);
+  }
+
+  void count_key_destroy (gpointer key)
+  {
+    ++key_destroy_calls;
+  }
+
+  TEST (GAlgorithmMergeSort, sort_by_key_five_elements) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    insert_into_ptr_array (array, 20, 10, 50, 40, 30);
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_merge_sort_by_key (array,
+                                                                 tens_key,
+                                                                 ptr_compare,
+                                                                 NULL)),
+                 ElementsAre (GINT_TO_POINTER (10),
+                              GINT_TO_POINTER (20),
+                              GINT_TO_POINTER (30),
+                              GINT_TO_POINTER (40),
+                              GINT_TO_POINTER (50)));
+  }
+
+  TEST (GAlgorithmMergeSort, sort_by_key_is_stable) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    insert_into_ptr_array (array, 21, 12, 25, 3, 11, 27, 1);
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_merge_sort_by_key (array,
+                                                                 tens_key,
+                                                                 ptr_compare,
+                                                                 NULL)),
+                 ElementsAre (GINT_TO_POINTER (3),
+                              GINT_TO_POINTER (1),
+                              GINT_TO_POINTER (12),
+                              GINT_TO_POINTER (11),
+                              GINT_TO_POINTER (21),
+                              GINT_TO_POINTER (25),
+                              GINT_TO_POINTER (27)));
+  }
+
+  TEST (GAlgorithmMergeSort, sort_by_key_computes_each_key_once) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    insert_into_ptr_array (array, 21, 12, 25, 3, 11, 27, 1);
+
+    key_func_calls = 0;
+    key_destroy_calls = 0;
+    g_algorithm_merge_sort_by_key (array, tens_key, ptr_compare, count_key_destroy);
+
+    EXPECT_EQ (key_func_calls, array->len);
+    EXPECT_EQ (key_destroy_calls, array->len);
+  }
 }
@@ -0,0 +1,162 @@
+/*
+ * /tests/galgorithm/galgorithm-min-max-heap-test.cpp
+ *
+ * Tests for the GAlgorithm Min-Max Heap.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <random>
+#include <set>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-min-max-heap.h>
+
+using ::testing::Eq;
+using ::testing::IsNull;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  TEST (GAlgorithmMinMaxHeap, empty_heap) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    EXPECT_THAT (g_algorithm_min_max_heap_peek_min (array), IsNull());
+    EXPECT_THAT (g_algorithm_min_max_heap_peek_max (array, ptr_compare), IsNull());
+    EXPECT_THAT (g_algorithm_min_max_heap_pop_min (array, ptr_compare), IsNull());
+    EXPECT_THAT (g_algorithm_min_max_heap_pop_max (array, ptr_compare), IsNull());
+  }
+
+  TEST (GAlgorithmMinMaxHeap, insert_and_peek) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    g_algorithm_min_max_heap_insert (array, GINT_TO_POINTER (3), ptr_compare);
+    g_algorithm_min_max_heap_insert (array, GINT_TO_POINTER (1), ptr_compare);
+    g_algorithm_min_max_heap_insert (array, GINT_TO_POINTER (5), ptr_compare);
+    g_algorithm_min_max_heap_insert (array, GINT_TO_POINTER (2), ptr_compare);
+    g_algorithm_min_max_heap_insert (array, GINT_TO_POINTER (4), ptr_compare);
+
+    EXPECT_THAT (g_algorithm_min_max_heap_peek_min (array), Eq(GINT_TO_POINTER (1)));
+    EXPECT_THAT (g_algorithm_min_max_heap_peek_max (array, ptr_compare), Eq(GINT_TO_POINTER (5)));
+    EXPECT_THAT (array->len, Eq(5u));
+  }
+
+  TEST (GAlgorithmMinMaxHeap, pop_alternating_ends) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    for (int i = 1; i <= 10; ++i)
+      g_ptr_array_add (array, GINT_TO_POINTER ((i * 7) % 10 + 1));
+
+    g_algorithm_min_max_heapify (array, ptr_compare);
+
+    for (int i = 0; i < 5; ++i)
+      {
+        EXPECT_THAT (g_algorithm_min_max_heap_pop_min (array, ptr_compare), Eq(GINT_TO_POINTER (1 + i)));
+        EXPECT_THAT (g_algorithm_min_max_heap_pop_max (array, ptr_compare), Eq(GINT_TO_POINTER (10 - i)));
+      }
+
+    EXPECT_THAT (array->len, Eq(0u));
+  }
+
+  TEST (GAlgorithmMinMaxHeap, heapify_then_pop_all_sorted) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    std::mt19937 engine (1);
+
+    for (int i = 0; i < 1000; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (engine () % 500 + 1));
+
+    g_algorithm_min_max_heapify (array, ptr_compare);
+
+    gpointer previous = NULL;
+    while (array->len > 0)
+      {
+        gpointer max = g_algorithm_min_max_heap_pop_max (array, ptr_compare);
+
+        if (previous != NULL)
+          {
+            ASSERT_LE (GPOINTER_TO_SIZE (max), GPOINTER_TO_SIZE (previous));
+          }
+
+        previous = max;
+      }
+  }
+
+  TEST (GAlgorithmMinMaxHeap, random_operations_match_multiset) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    std::multiset <size_t> expected;
+    std::mt19937 engine (2);
+
+    for (int i = 0; i < 20000; ++i)
+      {
+        switch (engine () % 4)
+          {
+            case 0:
+            case 1:
+              {
+                size_t value = engine () % 1000 + 1;
+
+                g_algorithm_min_max_heap_insert (array, GSIZE_TO_POINTER (value), ptr_compare);
+                expected.insert (value);
+              }
+              break;
+            case 2:
+              if (!expected.empty ())
+                {
+                  ASSERT_THAT (GPOINTER_TO_SIZE (g_algorithm_min_max_heap_pop_min (array, ptr_compare)),
+                               Eq(*expected.begin ()));
+                  expected.erase (expected.begin ());
+                }
+              break;
+            case 3:
+              if (!expected.empty ())
+                {
+                  ASSERT_THAT (GPOINTER_TO_SIZE (g_algorithm_min_max_heap_pop_max (array, ptr_compare)),
+                               Eq(*expected.rbegin ()));
+                  expected.erase (std::prev (expected.end ()));
+                }
+              break;
+          }
+
+        ASSERT_THAT (array->len, Eq(expected.size ()));
+      }
+  }
+
+  TEST (GAlgorithmMinMaxHeap, insert_bounded_evicts_largest) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    EXPECT_THAT (g_algorithm_min_max_heap_insert_bounded (array, GINT_TO_POINTER (5), 3, ptr_compare), IsNull());
+    EXPECT_THAT (g_algorithm_min_max_heap_insert_bounded (array, GINT_TO_POINTER (3), 3, ptr_compare), IsNull());
+    EXPECT_THAT (g_algorithm_min_max_heap_insert_bounded (array, GINT_TO_POINTER (4), 3, ptr_compare), IsNull());
+
+    /* Larger than everything already there, so it is turned away */
+    EXPECT_THAT (g_algorithm_min_max_heap_insert_bounded (array, GINT_TO_POINTER (6), 3, ptr_compare),
+                 Eq(GINT_TO_POINTER (6)));
+    EXPECT_THAT (g_algorithm_min_max_heap_insert_bounded (array, GINT_TO_POINTER (1), 3, ptr_compare),
+                 Eq(GINT_TO_POINTER (5)));
+
+    EXPECT_THAT (array->len, Eq(3u));
+    EXPECT_THAT (g_algorithm_min_max_heap_peek_min (array), Eq(GINT_TO_POINTER (1)));
+    EXPECT_THAT (g_algorithm_min_max_heap_peek_max (array, ptr_compare), Eq(GINT_TO_POINTER (4)));
+  }
+}
@@ -127,4 +127,16 @@ namespace {
     EXPECT_THAT (g_algorithm_minheap_pop (array, ptr_compare), Eq (GINT_TO_POINTER (4)));
     EXPECT_THAT (g_algorithm_minheap_pop (array, ptr_compare), Eq (GINT_TO_POINTER (5)));
   }
+
+  TEST (GAlgorithmMinheap, pop_many_in_order) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    for (int i = 0; i < 100; ++i)
+      g_algorithm_insert_minheap (array, GINT_TO_POINTER ((i * 37) % 100 + 1), ptr_compare);
+
+    for (int i = 1; i <= 100; ++i)
+      EXPECT_THAT (g_algorithm_minheap_pop (array, ptr_compare), Eq (GINT_TO_POINTER (i)));
+
+    EXPECT_THAT (g_algorithm_minheap_pop (array, ptr_compare), Eq (nullptr));
+  }
 }
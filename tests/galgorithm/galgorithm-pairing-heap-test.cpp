@@ -0,0 +1,190 @@
+/*
+ * /tests/galgorithm/galgorithm-pairing-heap-test.cpp
+ *
+ * Tests for the GAlgorithm Pairing Heap.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-pairing-heap.h>
+
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::IsNull;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  std::vector <size_t> drain (GAlgorithmPairingHeap *heap)
+  {
+    std::vector <size_t> values;
+
+    while (g_algorithm_pairing_heap_get_length (heap) > 0)
+      values.push_back (GPOINTER_TO_SIZE (g_algorithm_pairing_heap_pop_min (heap)));
+
+    return values;
+  }
+
+  TEST (GAlgorithmPairingHeap, empty_heap) {
+    g_autoptr(GAlgorithmPairingHeap) heap = g_algorithm_pairing_heap_new (ptr_compare);
+
+    EXPECT_THAT (g_algorithm_pairing_heap_peek_min (heap), IsNull());
+    EXPECT_THAT (g_algorithm_pairing_heap_pop_min (heap), IsNull());
+    EXPECT_THAT (g_algorithm_pairing_heap_get_length (heap), Eq(0u));
+  }
+
+  TEST (GAlgorithmPairingHeap, pops_in_order) {
+    g_autoptr(GAlgorithmPairingHeap) heap = g_algorithm_pairing_heap_new (ptr_compare);
+    std::mt19937 rng (42);
+    std::vector <size_t> values;
+
+    for (size_t i = 0; i < 1000; ++i)
+      values.push_back (rng () % 500 + 1);
+
+    for (size_t value : values)
+      g_algorithm_pairing_heap_insert (heap, GSIZE_TO_POINTER (value));
+
+    std::sort (values.begin (), values.end ());
+
+    EXPECT_THAT (g_algorithm_pairing_heap_peek_min (heap), Eq(GSIZE_TO_POINTER (values[0])));
+    EXPECT_THAT (drain (heap), ElementsAreArray(values));
+  }
+
+  TEST (GAlgorithmPairingHeap, decrease_key) {
+    g_autoptr(GAlgorithmPairingHeap) heap = g_algorithm_pairing_heap_new (ptr_compare);
+    std::vector <GAlgorithmPairingHeapNode *> nodes;
+
+    for (size_t i = 10; i <= 100; i += 10)
+      nodes.push_back (g_algorithm_pairing_heap_insert (heap, GSIZE_TO_POINTER (i)));
+
+    /* Pop once so that the nodes are arranged into a deeper tree */
+    EXPECT_THAT (g_algorithm_pairing_heap_pop_min (heap), Eq(GSIZE_TO_POINTER (10)));
+
+    g_algorithm_pairing_heap_decrease_key (heap, nodes[6], GSIZE_TO_POINTER (5));
+    g_algorithm_pairing_heap_decrease_key (heap, nodes[9], GSIZE_TO_POINTER (45));
+    g_algorithm_pairing_heap_decrease_key (heap, nodes[2], GSIZE_TO_POINTER (30));
+
+    EXPECT_THAT (g_algorithm_pairing_heap_node_get_element (nodes[9]), Eq(GSIZE_TO_POINTER (45)));
+    EXPECT_THAT (drain (heap), ElementsAreArray({ 5, 20, 30, 40, 45, 50, 60, 80, 90 }));
+  }
+
+  TEST (GAlgorithmPairingHeap, meld) {
+    g_autoptr(GAlgorithmPairingHeap) heap = g_algorithm_pairing_heap_new (ptr_compare);
+    g_autoptr(GAlgorithmPairingHeap) other = g_algorithm_pairing_heap_new (ptr_compare);
+
+    for (size_t i = 1; i <= 9; i += 2)
+      g_algorithm_pairing_heap_insert (heap, GSIZE_TO_POINTER (i));
+
+    for (size_t i = 2; i <= 10; i += 2)
+      g_algorithm_pairing_heap_insert (other, GSIZE_TO_POINTER (i));
+
+    g_algorithm_pairing_heap_meld (heap, other);
+
+    EXPECT_THAT (g_algorithm_pairing_heap_get_length (heap), Eq(10u));
+    EXPECT_THAT (g_algorithm_pairing_heap_get_length (other), Eq(0u));
+    EXPECT_THAT (g_algorithm_pairing_heap_peek_min (other), IsNull());
+    EXPECT_THAT (drain (heap), ElementsAreArray({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }));
+
+    /* The emptied heap can still be used */
+    g_algorithm_pairing_heap_insert (other, GSIZE_TO_POINTER (1));
+    EXPECT_THAT (drain (other), ElementsAreArray({ 1 }));
+  }
+
+  TEST (GAlgorithmPairingHeap, nodes_survive_meld) {
+    g_autoptr(GAlgorithmPairingHeap) heap = g_algorithm_pairing_heap_new (ptr_compare);
+    g_autoptr(GAlgorithmPairingHeap) other = g_algorithm_pairing_heap_new (ptr_compare);
+
+    g_algorithm_pairing_heap_insert (heap, GSIZE_TO_POINTER (10));
+    g_algorithm_pairing_heap_insert (other, GSIZE_TO_POINTER (20));
+    GAlgorithmPairingHeapNode *node = g_algorithm_pairing_heap_insert (other, GSIZE_TO_POINTER (30));
+
+    g_algorithm_pairing_heap_meld (heap, other);
+
+    /* Drop the melded heap, whose slabs now belong to the first one */
+    g_clear_pointer (&other, g_algorithm_pairing_heap_unref);
+
+    g_algorithm_pairing_heap_decrease_key (heap, node, GSIZE_TO_POINTER (1));
+    EXPECT_THAT (drain (heap), ElementsAreArray({ 1, 10, 20 }));
+  }
+
+  TEST (GAlgorithmPairingHeap, matches_sorted_order_under_churn) {
+    g_autoptr(GAlgorithmPairingHeap) heap = g_algorithm_pairing_heap_new (ptr_compare);
+    std::mt19937 rng (7);
+    std::vector <size_t> expected;
+
+    /* Interleave inserts, pops and decreases across several slabs. The
+     * low bits of each value are unique, so that there are no ties and
+     * the node that pops is always known. */
+    const size_t ID_RANGE = 1 << 15;
+    std::vector <std::pair <GAlgorithmPairingHeapNode *, size_t>> live;
+
+    for (size_t round = 0; round < 20000; ++round)
+      {
+        switch (rng () % 4)
+          {
+            case 0:
+            case 1:
+              {
+                size_t value = (rng () % 100000 + 1000) * ID_RANGE + round;
+
+                live.emplace_back (g_algorithm_pairing_heap_insert (heap, GSIZE_TO_POINTER (value)), value);
+                break;
+              }
+            case 2:
+              if (!live.empty ())
+                {
+                  auto min = std::min_element (live.begin (), live.end (),
+                                               [] (const auto &a, const auto &b) { return a.second < b.second; });
+
+                  EXPECT_THAT (GPOINTER_TO_SIZE (g_algorithm_pairing_heap_pop_min (heap)), Eq(min->second));
+                  live.erase (min);
+                }
+              break;
+            case 3:
+              if (!live.empty ())
+                {
+                  auto &entry = live[rng () % live.size ()];
+                  size_t steps = std::min <size_t> (entry.second / ID_RANGE - 1, rng () % 1000);
+                  size_t value = entry.second - steps * ID_RANGE;
+
+                  g_algorithm_pairing_heap_decrease_key (heap, entry.first, GSIZE_TO_POINTER (value));
+                  entry.second = value;
+                }
+              break;
+          }
+      }
+
+    for (auto &entry : live)
+      expected.push_back (entry.second);
+
+    std::sort (expected.begin (), expected.end ());
+    EXPECT_THAT (drain (heap), ElementsAreArray(expected));
+  }
+}
@@ -0,0 +1,155 @@
+/*
+ * /tests/galgorithm/galgorithm-primitive-sort-test.cpp
+ *
+ * Tests for the GAlgorithm primitive sort functions.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-primitive-sort.h>
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+
+namespace {
+  template <typename T>
+  GArray * array_from_vector (std::vector <T> const &values)
+  {
+    GArray *array = g_array_sized_new (FALSE, FALSE, sizeof (T), values.size ());
+    g_array_append_vals (array, values.data (), values.size ());
+    return array;
+  }
+
+  template <typename T>
+  std::vector <T> vector_from_array (GArray *array)
+  {
+    T *data = reinterpret_cast <T *> (array->data);
+    return std::vector <T> (data, data + array->len);
+  }
+
+  template <typename T>
+  std::vector <T> random_values (size_t size, T lower, T upper)
+  {
+    std::mt19937 engine (0);
+    std::vector <T> values;
+
+    for (size_t i = 0; i < size; ++i)
+      values.push_back (lower + static_cast <T> (engine () % static_cast <uint64_t> (upper - lower)));
+
+    return values;
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_empty_int32_array) {
+    g_autoptr(GArray) array = array_from_vector (std::vector <gint32> ());
+
+    EXPECT_THAT (vector_from_array <gint32> (g_algorithm_sort_int32 (array)),
+                 IsEmpty ());
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_five_int32) {
+    g_autoptr(GArray) array = array_from_vector (std::vector <gint32> { 2, -1, 5, G_MININT32, 3 });
+
+    EXPECT_THAT (vector_from_array <gint32> (g_algorithm_sort_int32 (array)),
+                 ElementsAre (G_MININT32, -1, 2, 3, 5));
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_many_int32) {
+    /* Not a multiple of the block size, so padding gets exercised */
+    std::vector <gint32> values (random_values <gint32> (10007, -5000, 5000));
+    g_autoptr(GArray) array = array_from_vector (values);
+
+    std::sort (values.begin (), values.end ());
+    EXPECT_THAT (vector_from_array <gint32> (g_algorithm_sort_int32 (array)),
+                 ElementsAreArray (values));
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_many_int64) {
+    std::vector <gint64> values (random_values <gint64> (10007, -(G_GINT64_CONSTANT (1) << 40), G_GINT64_CONSTANT (1) << 40));
+    g_autoptr(GArray) array = array_from_vector (values);
+
+    std::sort (values.begin (), values.end ());
+    EXPECT_THAT (vector_from_array <gint64> (g_algorithm_sort_int64 (array)),
+                 ElementsAreArray (values));
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_floats) {
+    std::vector <gfloat> values;
+
+    for (size_t i = 0; i < 1000; ++i)
+      values.push_back ((static_cast <gfloat> (i % 97) - 48.0f) * 1.5f);
+
+    g_autoptr(GArray) array = array_from_vector (values);
+
+    std::sort (values.begin (), values.end ());
+    EXPECT_THAT (vector_from_array <gfloat> (g_algorithm_sort_float (array)),
+                 ElementsAreArray (values));
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_doubles) {
+    g_autoptr(GArray) array = array_from_vector (std::vector <gdouble> { 2.5, -0.5, -100.0, 0.0, 1e300 });
+
+    EXPECT_THAT (vector_from_array <gdouble> (g_algorithm_sort_double (array)),
+                 ElementsAre (-100.0, -0.5, 0.0, 2.5, 1e300));
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_int32_with_index_is_stable) {
+    g_autoptr(GArray) array = array_from_vector (std::vector <gint32> { 3, 1, 3, -2, 1 });
+    g_autoptr(GArray) indices = g_algorithm_sort_int32_with_index (array);
+
+    EXPECT_THAT (vector_from_array <gint32> (array),
+                 ElementsAre (-2, 1, 1, 3, 3));
+    EXPECT_THAT (vector_from_array <guint32> (indices),
+                 ElementsAre (3u, 1u, 4u, 0u, 2u));
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_many_float_with_index_gives_permutation) {
+    std::vector <gfloat> values;
+
+    for (gint32 value : random_values <gint32> (5000, -1000, 1000))
+      values.push_back (static_cast <gfloat> (value) / 8.0f);
+
+    g_autoptr(GArray) array = array_from_vector (values);
+    g_autoptr(GArray) indices = g_algorithm_sort_float_with_index (array);
+
+    std::vector <gfloat> sorted (vector_from_array <gfloat> (array));
+    std::vector <gfloat> permuted;
+
+    for (guint32 index : vector_from_array <guint32> (indices))
+      permuted.push_back (values[index]);
+
+    EXPECT_TRUE (std::is_sorted (sorted.begin (), sorted.end ()));
+    EXPECT_THAT (permuted, ElementsAreArray (sorted));
+  }
+
+  TEST (GAlgorithmPrimitiveSort, sort_int64_with_index_is_stable) {
+    g_autoptr(GArray) array = array_from_vector (std::vector <gint64> { G_MAXINT64, 7, G_MININT64, 7 });
+    g_autoptr(GArray) indices = g_algorithm_sort_int64_with_index (array);
+
+    EXPECT_THAT (vector_from_array <gint64> (array),
+                 ElementsAre (G_MININT64, 7, 7, G_MAXINT64));
+    EXPECT_THAT (vector_from_array <guint32> (indices),
+                 ElementsAre (2u, 1u, 3u, 0u));
+  }
+}
@@ -20,12 +20,17 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <galgorithm/galgorithm-quicksort.h>
 
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::IsEmpty;
 using ::testing::Not;
 using ::testing::_;
@@ -125,4 +130,61 @@ namespace {
                               GINT_TO_POINTER (4),
                               GINT_TO_POINTER (5)));
   }
+
+  TEST (GAlgorithmQuicksort, block_partition_sort_five_elements) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    insert_into_ptr_array (array, 2, 1, 5, 4, 3);
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_quicksort_full (array,
+                                                              ptr_compare,
+                                                              G_ALGORITHM_QUICKSORT_PARTITION_BLOCK)),
+                 ElementsAre (GINT_TO_POINTER (1),
+                              GINT_TO_POINTER (2),
+                              GINT_TO_POINTER (3),
+                              GINT_TO_POINTER (4),
+                              GINT_TO_POINTER (5)));
+  }
+
+  TEST (GAlgorithmQuicksort, block_partition_sort_many_random_elements) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    std::vector <gpointer> expected;
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < 10000; ++i)
+      {
+        gpointer element = GINT_TO_POINTER (engine () % 100000);
+        g_ptr_array_add (array, element);
+        expected.push_back (element);
+      }
+
+    std::sort (expected.begin (), expected.end (), [](gpointer a, gpointer b) {
+      return ptr_compare (a, b) < 0;
+    });
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_quicksort_full (array,
+                                                              ptr_compare,
+                                                              G_ALGORITHM_QUICKSORT_PARTITION_BLOCK)),
+                 ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmQuicksort, block_partition_sort_many_duplicates) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    std::vector <gpointer> expected;
+
+    for (size_t i = 0; i < 1000; ++i)
+      {
+        gpointer element = GINT_TO_POINTER ((i * 7) % 3);
+        g_ptr_array_add (array, element);
+        expected.push_back (element);
+      }
+
+    std::sort (expected.begin (), expected.end (), [](gpointer a, gpointer b) {
+      return ptr_compare (a, b) < 0;
+    });
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_quicksort_full (array,
+                                                              ptr_compare,
+                                                              G_ALGORITHM_QUICKSORT_PARTITION_BLOCK)),
+                 ElementsAreArray (expected));
+  }
 }
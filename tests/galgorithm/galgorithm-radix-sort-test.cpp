@@ -0,0 +1,218 @@
+/*
+ * /tests/galgorithm/galgorithm-radix-sort-test.cpp
+ *
+ * Tests for the GAlgorithm radix sort function.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-radix-sort.h>
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+
+namespace {
+  class PtrArrayWrapper {
+    public:
+      PtrArrayWrapper(GPtrArray *array) :
+        array (array)
+      {
+      }
+
+      gpointer * begin () const {
+        return &array->pdata[0];
+      }
+
+      gpointer * end () const {
+        return &array->pdata[0] + array->len;
+      }
+
+      size_t size () const {
+        return array->len;
+      }
+
+      bool empty () const {
+        return array->len == 0;
+      }
+
+      gpointer & operator[] (size_t x) {
+        return array->pdata[x];
+      }
+
+      typedef gpointer value_type;
+      typedef gpointer * const_iterator;
+      typedef gpointer * iterator;
+
+    private:
+      GPtrArray *array;
+  };
+
+  struct Record {
+    gint64  integer;
+    gdouble real;
+    gfloat  single;
+  };
+
+  guint64 unsigned_key (gconstpointer element)
+  {
+    return static_cast <guint64> (GPOINTER_TO_SIZE (element));
+  }
+
+  guint64 signed_key (gconstpointer element)
+  {
+    return static_cast <guint64> (static_cast <const Record *> (element)->integer);
+  }
+
+  guint64 double_key (gconstpointer element)
+  {
+    return g_algorithm_radix_key_from_double (static_cast <const Record *> (element)->real);
+  }
+
+  guint64 float_key (gconstpointer element)
+  {
+    return g_algorithm_radix_key_from_float (static_cast <const Record *> (element)->single);
+  }
+
+  guint64 bucket_key (gconstpointer element)
+  {
+    return static_cast <guint64> (GPOINTER_TO_SIZE (element)) / 16;
+  }
+
+  TEST (GAlgorithmRadixSort, sort_empty_array) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_radix_sort (array,
+                                                          unsigned_key,
+                                                          G_ALGORITHM_RADIX_KEY_UNSIGNED)),
+                 IsEmpty ());
+  }
+
+  TEST (GAlgorithmRadixSort, sort_unsigned_keys) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    for (size_t value : { 300, 2, 70000, 1, 5 })
+      g_ptr_array_add (array, GSIZE_TO_POINTER (value));
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_radix_sort (array,
+                                                          unsigned_key,
+                                                          G_ALGORITHM_RADIX_KEY_UNSIGNED)),
+                 ElementsAre (GSIZE_TO_POINTER (1),
+                              GSIZE_TO_POINTER (2),
+                              GSIZE_TO_POINTER (5),
+                              GSIZE_TO_POINTER (300),
+                              GSIZE_TO_POINTER (70000)));
+  }
+
+  TEST (GAlgorithmRadixSort, sort_signed_keys) {
+    Record records[] = { { 3 }, { -1 }, { G_MININT64 }, { 0 }, { G_MAXINT64 } };
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    for (auto &record : records)
+      g_ptr_array_add (array, &record);
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_radix_sort (array,
+                                                          signed_key,
+                                                          G_ALGORITHM_RADIX_KEY_SIGNED)),
+                 ElementsAre (&records[2],
+                              &records[1],
+                              &records[3],
+                              &records[0],
+                              &records[4]));
+  }
+
+  TEST (GAlgorithmRadixSort, sort_double_keys) {
+    Record records[] = { { 0, 2.5 }, { 0, -0.5 }, { 0, -100.0 }, { 0, 0.0 }, { 0, 1e10 } };
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    for (auto &record : records)
+      g_ptr_array_add (array, &record);
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_radix_sort (array,
+                                                          double_key,
+                                                          G_ALGORITHM_RADIX_KEY_DOUBLE)),
+                 ElementsAre (&records[2],
+                              &records[1],
+                              &records[3],
+                              &records[0],
+                              &records[4]));
+  }
+
+  TEST (GAlgorithmRadixSort, sort_float_keys) {
+    Record records[] = { { 0, 0, 2.5f }, { 0, 0, -0.5f }, { 0, 0, -100.0f }, { 0, 0, 0.0f }, { 0, 0, 1e10f } };
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    for (auto &record : records)
+      g_ptr_array_add (array, &record);
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_radix_sort (array,
+                                                          float_key,
+                                                          G_ALGORITHM_RADIX_KEY_FLOAT)),
+                 ElementsAre (&records[2],
+                              &records[1],
+                              &records[3],
+                              &records[0],
+                              &records[4]));
+  }
+
+  TEST (GAlgorithmRadixSort, sort_is_stable) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    for (size_t value : { 33, 17, 32, 1, 16, 2 })
+      g_ptr_array_add (array, GSIZE_TO_POINTER (value));
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_radix_sort (array,
+                                                          bucket_key,
+                                                          G_ALGORITHM_RADIX_KEY_UNSIGNED)),
+                 ElementsAre (GSIZE_TO_POINTER (1),
+                              GSIZE_TO_POINTER (2),
+                              GSIZE_TO_POINTER (17),
+                              GSIZE_TO_POINTER (16),
+                              GSIZE_TO_POINTER (33),
+                              GSIZE_TO_POINTER (32)));
+  }
+
+  TEST (GAlgorithmRadixSort, parallel_sort_matches_stable_sort) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    std::vector <gpointer> expected;
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < 200000; ++i)
+      {
+        gpointer element = GSIZE_TO_POINTER (1 + engine () % 1000000);
+        g_ptr_array_add (array, element);
+        expected.push_back (element);
+      }
+
+    std::stable_sort (expected.begin (), expected.end (), [](gpointer a, gpointer b) {
+      return bucket_key (a) < bucket_key (b);
+    });
+
+    EXPECT_THAT (PtrArrayWrapper (g_algorithm_radix_sort_full (array,
+                                                               bucket_key,
+                                                               G_ALGORITHM_RADIX_KEY_UNSIGNED,
+                                                               4)),
+                 ElementsAreArray (expected));
+  }
+}
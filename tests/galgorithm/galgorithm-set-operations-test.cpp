@@ -0,0 +1,206 @@
+/*
+ * /tests/galgorithm/galgorithm-set-operations-test.cpp
+ *
+ * Tests for the GAlgorithm Set Operations.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-set-operations.h>
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  template <typename... Args>
+  void insert_into_ptr_array (GPtrArray *array, Args... args)
+  {
+    size_t elements[] = { static_cast <size_t> (args)... };
+
+    for (size_t element : elements)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (element));
+  }
+
+  std::vector <size_t> vector_from_ptr_array (GPtrArray *array)
+  {
+    std::vector <size_t> elements;
+
+    for (guint i = 0; i < array->len; ++i)
+      elements.push_back (GPOINTER_TO_SIZE (array->pdata[i]));
+
+    return elements;
+  }
+
+  std::vector <guint32> random_uint32_set (std::mt19937 &engine, size_t size, guint32 range)
+  {
+    std::vector <guint32> values;
+
+    for (size_t i = 0; i < size; ++i)
+      values.push_back (engine () % range);
+
+    std::sort (values.begin (), values.end ());
+    values.erase (std::unique (values.begin (), values.end ()), values.end ());
+    return values;
+  }
+
+  GArray * array_from_vector (const std::vector <guint32> &values)
+  {
+    GArray *array = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+    g_array_append_vals (array, values.data (), values.size ());
+    return array;
+  }
+
+  void count_free (gpointer element)
+  {
+    ++*static_cast <int *> (element);
+  }
+
+  TEST (GAlgorithmSetOperations, unique_frees_duplicates) {
+    int counters[4] = { 0, 0, 0, 0 };
+    g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func (count_free);
+
+    g_ptr_array_add (array, &counters[0]);
+    g_ptr_array_add (array, &counters[0]);
+    g_ptr_array_add (array, &counters[1]);
+    g_ptr_array_add (array, &counters[2]);
+    g_ptr_array_add (array, &counters[2]);
+    g_ptr_array_add (array, &counters[2]);
+    g_ptr_array_add (array, &counters[3]);
+
+    g_algorithm_unique (array, ptr_compare);
+
+    EXPECT_THAT (std::vector <gpointer> (array->pdata, array->pdata + array->len),
+                 ElementsAre (&counters[0], &counters[1], &counters[2], &counters[3]));
+    EXPECT_THAT (counters, ElementsAre (1, 0, 2, 0));
+  }
+
+  TEST (GAlgorithmSetOperations, union_keeps_max_count) {
+    g_autoptr(GPtrArray) a = g_ptr_array_new ();
+    g_autoptr(GPtrArray) b = g_ptr_array_new ();
+    insert_into_ptr_array (a, 1, 2, 2, 5, 9);
+    insert_into_ptr_array (b, 2, 3, 5, 5, 10);
+
+    g_autoptr(GPtrArray) result = g_algorithm_set_union (a, b, ptr_compare);
+
+    EXPECT_THAT (vector_from_ptr_array (result), ElementsAre (1, 2, 2, 3, 5, 5, 9, 10));
+  }
+
+  TEST (GAlgorithmSetOperations, difference_removes_matches) {
+    g_autoptr(GPtrArray) a = g_ptr_array_new ();
+    g_autoptr(GPtrArray) b = g_ptr_array_new ();
+    insert_into_ptr_array (a, 1, 2, 2, 5, 9);
+    insert_into_ptr_array (b, 2, 3, 5, 10);
+
+    g_autoptr(GPtrArray) result = g_algorithm_set_difference (a, b, ptr_compare);
+
+    EXPECT_THAT (vector_from_ptr_array (result), ElementsAre (1, 2, 9));
+  }
+
+  TEST (GAlgorithmSetOperations, intersection_matches_std) {
+    std::mt19937 engine (0);
+
+    /* The second size is far enough apart to gallop */
+    for (size_t b_size : { 1000u, 50000u })
+      {
+        std::vector <guint32> a_values (random_uint32_set (engine, 1000, 100000));
+        std::vector <guint32> b_values (random_uint32_set (engine, b_size, 100000));
+        std::vector <size_t> expected;
+        g_autoptr(GPtrArray) a = g_ptr_array_new ();
+        g_autoptr(GPtrArray) b = g_ptr_array_new ();
+
+        for (guint32 value : a_values)
+          g_ptr_array_add (a, GSIZE_TO_POINTER (value));
+        for (guint32 value : b_values)
+          g_ptr_array_add (b, GSIZE_TO_POINTER (value));
+
+        std::set_intersection (a_values.begin (), a_values.end (),
+                               b_values.begin (), b_values.end (),
+                               std::back_inserter (expected));
+
+        g_autoptr(GPtrArray) forwards = g_algorithm_set_intersection (a, b, ptr_compare);
+        g_autoptr(GPtrArray) backwards = g_algorithm_set_intersection (b, a, ptr_compare);
+
+        EXPECT_THAT (vector_from_ptr_array (forwards), ElementsAreArray (expected));
+        EXPECT_THAT (vector_from_ptr_array (backwards), ElementsAreArray (expected));
+      }
+  }
+
+  TEST (GAlgorithmSetOperations, intersection_many) {
+    g_autoptr(GPtrArray) a = g_ptr_array_new ();
+    g_autoptr(GPtrArray) b = g_ptr_array_new ();
+    g_autoptr(GPtrArray) c = g_ptr_array_new ();
+    insert_into_ptr_array (a, 1, 2, 3, 4, 5, 6, 7, 8);
+    insert_into_ptr_array (b, 2, 4, 6, 8);
+    insert_into_ptr_array (c, 1, 4, 5, 6, 9);
+
+    GPtrArray *arrays[] = { a, b, c };
+    g_autoptr(GPtrArray) result = g_algorithm_set_intersection_many (arrays,
+                                                                     G_N_ELEMENTS (arrays),
+                                                                     ptr_compare);
+
+    EXPECT_THAT (vector_from_ptr_array (result), ElementsAre (4, 6));
+  }
+
+  TEST (GAlgorithmSetOperations, intersection_many_no_arrays) {
+    g_autoptr(GPtrArray) result = g_algorithm_set_intersection_many (NULL, 0, ptr_compare);
+
+    EXPECT_THAT (vector_from_ptr_array (result), IsEmpty ());
+  }
+
+  TEST (GAlgorithmSetOperations, intersection_uint32_matches_std) {
+    std::mt19937 engine (0);
+
+    for (size_t a_size : { 0u, 7u, 100u, 5000u })
+      {
+        for (size_t b_size : { 0u, 9u, 100u, 5000u, 200000u })
+          {
+            std::vector <guint32> a_values (random_uint32_set (engine, a_size, 10000));
+            std::vector <guint32> b_values (random_uint32_set (engine, b_size, 10000));
+            std::vector <guint32> expected;
+            g_autoptr(GArray) a = array_from_vector (a_values);
+            g_autoptr(GArray) b = array_from_vector (b_values);
+
+            std::set_intersection (a_values.begin (), a_values.end (),
+                                   b_values.begin (), b_values.end (),
+                                   std::back_inserter (expected));
+
+            g_autoptr(GArray) result = g_algorithm_set_intersection_uint32 (a, b);
+            guint32 *data = reinterpret_cast <guint32 *> (result->data);
+
+            EXPECT_THAT (std::vector <guint32> (data, data + result->len),
+                         ElementsAreArray (expected));
+          }
+      }
+  }
+}
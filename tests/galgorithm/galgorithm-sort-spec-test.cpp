@@ -0,0 +1,317 @@
+/*
+ * /tests/galgorithm/galgorithm-sort-spec-test.cpp
+ *
+ * Tests for the GAlgorithm Sort Specs.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-sort-spec.h>
+
+using ::testing::Eq;
+using ::testing::ElementsAre;
+
+G_BEGIN_DECLS
+
+#define TEST_TYPE_ITEM (test_item_get_type ())
+G_DECLARE_FINAL_TYPE (TestItem, test_item, TEST, ITEM, GObject)
+
+struct _TestItem {
+  GObject parent_instance;
+
+  gchar   *name;
+  gint     priority;
+  gdouble  weight;
+};
+
+G_DEFINE_TYPE (TestItem, test_item, G_TYPE_OBJECT)
+
+G_END_DECLS
+
+namespace {
+  enum {
+    PROP_0,
+    PROP_NAME,
+    PROP_PRIORITY,
+    PROP_WEIGHT
+  };
+
+  void test_item_get_property (GObject    *object,
+                               guint       prop_id,
+                               GValue     *value,
+                               GParamSpec *pspec)
+  {
+    TestItem *item = TEST_ITEM (object);
+
+    switch (prop_id)
+      {
+        case PROP_NAME:
+          g_value_set_string (value, item->name);
+          break;
+        case PROP_PRIORITY:
+          g_value_set_int (value, item->priority);
+          break;
+        case PROP_WEIGHT:
+          g_value_set_double (value, item->weight);
+          break;
+        default:
+          G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      }
+  }
+
+  void test_item_set_property (GObject      *object,
+                               guint         prop_id,
+                               const GValue *value,
+                               GParamSpec   *pspec)
+  {
+    TestItem *item = TEST_ITEM (object);
+
+    switch (prop_id)
+      {
+        case PROP_NAME:
+          g_free (item->name);
+          item->name = g_value_dup_string (value);
+          break;
+        case PROP_PRIORITY:
+          item->priority = g_value_get_int (value);
+          break;
+        case PROP_WEIGHT:
+          item->weight = g_value_get_double (value);
+          break;
+        default:
+          G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      }
+  }
+
+  void test_item_finalize (GObject *object)
+  {
+    g_free (TEST_ITEM (object)->name);
+
+    G_OBJECT_CLASS (test_item_parent_class)->finalize (object);
+  }
+
+  GPtrArray * make_items (const std::vector <std::tuple <const char *, gint, gdouble>> &values)
+  {
+    GPtrArray *array = g_ptr_array_new_with_free_func (g_object_unref);
+
+    for (auto const &value : values)
+      g_ptr_array_add (array, g_object_new (TEST_TYPE_ITEM,
+                                            "name", std::get <0> (value),
+                                            "priority", std::get <1> (value),
+                                            "weight", std::get <2> (value),
+                                            NULL));
+
+    return array;
+  }
+
+  std::vector <std::string> item_names (GPtrArray *array)
+  {
+    std::vector <std::string> names;
+
+    for (guint i = 0; i < array->len; ++i)
+      {
+        const gchar *name = TEST_ITEM (array->pdata[i])->name;
+        names.push_back (name != NULL ? name : "(null)");
+      }
+
+    return names;
+  }
+
+  TEST (GAlgorithmSortSpec, sort_by_int_property) {
+    g_autoptr(GPtrArray) array = make_items ({
+      { "c", 3, 0.0 },
+      { "a", 1, 0.0 },
+      { "d", -4, 0.0 },
+      { "b", 2, 0.0 }
+    });
+    g_autoptr(GAlgorithmSortSpec) spec = g_algorithm_sort_spec_new ();
+
+    g_algorithm_sort_spec_add_key (spec,
+                                   "priority",
+                                   G_ALGORITHM_SORT_KEY_INT,
+                                   G_ALGORITHM_SORT_ASCENDING,
+                                   G_ALGORITHM_STRING_SORT_BYTES);
+    g_algorithm_sort_by_spec (array, spec);
+
+    EXPECT_THAT (item_names (array), ElementsAre ("d", "a", "b", "c"));
+  }
+
+  TEST (GAlgorithmSortSpec, sort_by_double_property_descending) {
+    g_autoptr(GPtrArray) array = make_items ({
+      { "light", 0, 0.5 },
+      { "heavy", 0, 10.0 },
+      { "medium", 0, 2.5 },
+      { "nothing", 0, NAN }
+    });
+    g_autoptr(GAlgorithmSortSpec) spec = g_algorithm_sort_spec_new ();
+
+    g_algorithm_sort_spec_add_key (spec,
+                                   "weight",
+                                   G_ALGORITHM_SORT_KEY_DOUBLE,
+                                   G_ALGORITHM_SORT_DESCENDING,
+                                   G_ALGORITHM_STRING_SORT_BYTES);
+    g_algorithm_sort_by_spec (array, spec);
+
+    EXPECT_THAT (item_names (array), ElementsAre ("nothing", "heavy", "medium", "light"));
+  }
+
+  TEST (GAlgorithmSortSpec, sort_by_string_property_null_first) {
+    g_autoptr(GPtrArray) array = make_items ({
+      { "pear", 0, 0.0 },
+      { NULL, 0, 0.0 },
+      { "apple", 0, 0.0 },
+      { "fig", 0, 0.0 }
+    });
+    g_autoptr(GAlgorithmSortSpec) spec = g_algorithm_sort_spec_new ();
+
+    g_algorithm_sort_spec_add_key (spec,
+                                   "name",
+                                   G_ALGORITHM_SORT_KEY_STRING,
+                                   G_ALGORITHM_SORT_ASCENDING,
+                                   G_ALGORITHM_STRING_SORT_COLLATE);
+    g_algorithm_sort_by_spec (array, spec);
+
+    EXPECT_THAT (item_names (array), ElementsAre ("(null)", "apple", "fig", "pear"));
+  }
+
+  TEST (GAlgorithmSortSpec, later_keys_break_ties) {
+    g_autoptr(GPtrArray) array = make_items ({
+      { "b", 2, 0.0 },
+      { "c", 1, 0.0 },
+      { "a", 2, 0.0 },
+      { "d", 1, 0.0 }
+    });
+    g_autoptr(GAlgorithmSortSpec) spec = g_algorithm_sort_spec_new ();
+
+    g_algorithm_sort_spec_add_key (spec,
+                                   "priority",
+                                   G_ALGORITHM_SORT_KEY_INT,
+                                   G_ALGORITHM_SORT_DESCENDING,
+                                   G_ALGORITHM_STRING_SORT_BYTES);
+    g_algorithm_sort_spec_add_key (spec,
+                                   "name",
+                                   G_ALGORITHM_SORT_KEY_STRING,
+                                   G_ALGORITHM_SORT_ASCENDING,
+                                   G_ALGORITHM_STRING_SORT_BYTES);
+    g_algorithm_sort_by_spec (array, spec);
+
+    EXPECT_THAT (item_names (array), ElementsAre ("a", "b", "c", "d"));
+  }
+
+  TEST (GAlgorithmSortSpec, sort_is_stable) {
+    std::vector <std::tuple <const char *, gint, gdouble>> values;
+    static const char *names[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9" };
+
+    /* Enough elements to need merging as well as insertion sorting */
+    for (int i = 0; i < 100; ++i)
+      values.emplace_back (names[i / 10], i % 3, 0.0);
+
+    g_autoptr(GPtrArray) array = make_items (values);
+    g_autoptr(GAlgorithmSortSpec) spec = g_algorithm_sort_spec_new ();
+
+    g_algorithm_sort_spec_add_key (spec,
+                                   "priority",
+                                   G_ALGORITHM_SORT_KEY_INT,
+                                   G_ALGORITHM_SORT_ASCENDING,
+                                   G_ALGORITHM_STRING_SORT_BYTES);
+    g_algorithm_sort_by_spec (array, spec);
+
+    std::vector <std::string> sorted_names (item_names (array));
+
+    for (guint i = 1; i < array->len; ++i)
+      {
+        TestItem *previous = TEST_ITEM (array->pdata[i - 1]);
+        TestItem *current = TEST_ITEM (array->pdata[i]);
+
+        ASSERT_LE (previous->priority, current->priority);
+
+        if (previous->priority == current->priority)
+          ASSERT_LE (sorted_names[i - 1], sorted_names[i]);
+      }
+  }
+
+  TEST (GAlgorithmSortSpec, binary_search_finds_element) {
+    g_autoptr(GPtrArray) array = make_items ({
+      { "a", 1, 0.0 },
+      { "b", 3, 0.0 },
+      { "c", 5, 0.0 },
+      { "d", 7, 0.0 }
+    });
+    g_autoptr(GAlgorithmSortSpec) spec = g_algorithm_sort_spec_new ();
+    g_autoptr(GObject) present = G_OBJECT (g_object_new (TEST_TYPE_ITEM, "priority", 5, NULL));
+    g_autoptr(GObject) missing = G_OBJECT (g_object_new (TEST_TYPE_ITEM, "priority", 4, NULL));
+
+    g_algorithm_sort_spec_add_key (spec,
+                                   "priority",
+                                   G_ALGORITHM_SORT_KEY_INT,
+                                   G_ALGORITHM_SORT_ASCENDING,
+                                   G_ALGORITHM_STRING_SORT_BYTES);
+
+    EXPECT_THAT (g_algorithm_binary_search_by_spec (array, present, spec), Eq (2));
+    EXPECT_THAT (g_algorithm_binary_search_by_spec (array, missing, spec), Eq (-1));
+  }
+}
+
+static void
+test_item_class_init (TestItemClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->get_property = test_item_get_property;
+  object_class->set_property = test_item_set_property;
+  object_class->finalize = test_item_finalize;
+
+  g_object_class_install_property (object_class,
+                                   PROP_NAME,
+                                   g_param_spec_string ("name",
+                                                        "Name",
+                                                        "Name",
+                                                        NULL,
+                                                        G_PARAM_READWRITE));
+  g_object_class_install_property (object_class,
+                                   PROP_PRIORITY,
+                                   g_param_spec_int ("priority",
+                                                     "Priority",
+                                                     "Priority",
+                                                     G_MININT,
+                                                     G_MAXINT,
+                                                     0,
+                                                     G_PARAM_READWRITE));
+  g_object_class_install_property (object_class,
+                                   PROP_WEIGHT,
+                                   g_param_spec_double ("weight",
+                                                        "Weight",
+                                                        "Weight",
+                                                        -G_MAXDOUBLE,
+                                                        G_MAXDOUBLE,
+                                                        0.0,
+                                                        G_PARAM_READWRITE));
+}
+
+static void
+test_item_init (TestItem *item)
+{
+}
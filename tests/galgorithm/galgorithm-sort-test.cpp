@@ -0,0 +1,155 @@
+/*
+ * /tests/galgorithm/galgorithm-sort-test.cpp
+ *
+ * Tests for the GAlgorithm adaptive sort.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-sort.h>
+
+using ::testing::Eq;
+using ::testing::ElementsAreArray;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  /* Compare by tens, so that elements in the same ten are equal */
+  int tens_compare (gconstpointer a, gconstpointer b)
+  {
+    return ptr_compare (GSIZE_TO_POINTER (GPOINTER_TO_SIZE (a) / 10),
+                        GSIZE_TO_POINTER (GPOINTER_TO_SIZE (b) / 10));
+  }
+
+  GPtrArray * ptr_array_from_vector (const std::vector <size_t> &values)
+  {
+    GPtrArray *array = g_ptr_array_sized_new (values.size ());
+
+    for (size_t value : values)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (value));
+
+    return array;
+  }
+
+  std::vector <size_t> vector_from_ptr_array (GPtrArray *array)
+  {
+    std::vector <size_t> values;
+
+    for (guint i = 0; i < array->len; ++i)
+      values.push_back (GPOINTER_TO_SIZE (array->pdata[i]));
+
+    return values;
+  }
+
+  std::vector <size_t> random_values (size_t size, size_t range)
+  {
+    std::vector <size_t> values;
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < size; ++i)
+      values.push_back (1 + engine () % range);
+
+    return values;
+  }
+
+  /* Sort @values with @flags, checking that the result matches a
+   * stable sort by @cmp and returning the strategy that was used */
+  GAlgorithmSortStrategy sort_and_check (const std::vector <size_t> &values,
+                                         GAlgorithmCompareFunc       cmp,
+                                         GAlgorithmSortFlags         flags)
+  {
+    g_autoptr(GPtrArray) array = ptr_array_from_vector (values);
+    GAlgorithmSortStrategy strategy;
+    std::vector <size_t> expected (values);
+
+    g_algorithm_sort_full (array, cmp, flags, &strategy);
+
+    std::stable_sort (expected.begin (), expected.end (), [cmp] (size_t a, size_t b) {
+      return cmp (GSIZE_TO_POINTER (a), GSIZE_TO_POINTER (b)) < 0;
+    });
+
+    if (flags & G_ALGORITHM_SORT_FLAGS_STABLE)
+      EXPECT_THAT (vector_from_ptr_array (array), ElementsAreArray (expected));
+    else
+      EXPECT_TRUE (std::is_sorted (array->pdata, array->pdata + array->len,
+                                   [cmp] (gpointer a, gpointer b) {
+                                     return cmp (a, b) < 0;
+                                   }));
+
+    return strategy;
+  }
+
+  TEST (GAlgorithmSort, small_array_uses_insertion_sort) {
+    EXPECT_THAT (sort_and_check (random_values (10, 1000), ptr_compare, G_ALGORITHM_SORT_FLAGS_NONE),
+                 Eq (G_ALGORITHM_SORT_STRATEGY_INSERTION));
+  }
+
+  TEST (GAlgorithmSort, random_array_uses_introsort) {
+    EXPECT_THAT (sort_and_check (random_values (100000, 1000000000), ptr_compare, G_ALGORITHM_SORT_FLAGS_NONE),
+                 Eq (G_ALGORITHM_SORT_STRATEGY_INTROSORT));
+  }
+
+  TEST (GAlgorithmSort, presorted_arrays_use_run_merge) {
+    std::vector <size_t> values (random_values (100000, 1000000000));
+
+    std::sort (values.begin (), values.end ());
+    EXPECT_THAT (sort_and_check (values, ptr_compare, G_ALGORITHM_SORT_FLAGS_NONE),
+                 Eq (G_ALGORITHM_SORT_STRATEGY_RUN_MERGE));
+
+    std::reverse (values.begin (), values.end ());
+    EXPECT_THAT (sort_and_check (values, ptr_compare, G_ALGORITHM_SORT_FLAGS_NONE),
+                 Eq (G_ALGORITHM_SORT_STRATEGY_RUN_MERGE));
+  }
+
+  TEST (GAlgorithmSort, few_distinct_values_use_three_way_quicksort) {
+    EXPECT_THAT (sort_and_check (random_values (100000, 16), ptr_compare, G_ALGORITHM_SORT_FLAGS_NONE),
+                 Eq (G_ALGORITHM_SORT_STRATEGY_THREE_WAY_QUICKSORT));
+  }
+
+  TEST (GAlgorithmSort, stable_flag_keeps_equal_elements_in_order) {
+    EXPECT_THAT (sort_and_check (random_values (100000, 100000), tens_compare, G_ALGORITHM_SORT_FLAGS_STABLE),
+                 Eq (G_ALGORITHM_SORT_STRATEGY_RUN_MERGE));
+  }
+
+  TEST (GAlgorithmSort, stable_in_place_flags_merge_in_place) {
+    GAlgorithmSortFlags flags = static_cast <GAlgorithmSortFlags> (G_ALGORITHM_SORT_FLAGS_STABLE |
+                                                                   G_ALGORITHM_SORT_FLAGS_IN_PLACE);
+
+    EXPECT_THAT (sort_and_check (random_values (10000, 10000), tens_compare, flags),
+                 Eq (G_ALGORITHM_SORT_STRATEGY_IN_PLACE_MERGE));
+  }
+
+  TEST (GAlgorithmSort, in_place_flag_avoids_run_merge) {
+    std::vector <size_t> values (random_values (100000, 1000000000));
+
+    std::sort (values.begin (), values.end ());
+    EXPECT_THAT (sort_and_check (values, ptr_compare, G_ALGORITHM_SORT_FLAGS_IN_PLACE),
+                 Eq (G_ALGORITHM_SORT_STRATEGY_INTROSORT));
+  }
+}
@@ -0,0 +1,233 @@
+/*
+ * /tests/galgorithm/galgorithm-sorted-container-test.cpp
+ *
+ * Tests for the GAlgorithm Sorted Container.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-sorted-container.h>
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::IsNull;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  int boxed_int_compare (gconstpointer a, gconstpointer b)
+  {
+    int lhs = *static_cast <const int *> (a);
+    int rhs = *static_cast <const int *> (b);
+
+    return lhs == rhs ? 0 : (lhs < rhs ? -1 : 1);
+  }
+
+  gpointer new_boxed_int (int value)
+  {
+    int *boxed = g_new (int, 1);
+
+    *boxed = value;
+    return boxed;
+  }
+
+  size_t n_freed = 0;
+
+  void counting_free (gpointer element)
+  {
+    ++n_freed;
+    g_free (element);
+  }
+
+  std::vector <size_t> container_contents (GAlgorithmSortedContainer *container)
+  {
+    g_autoptr(GPtrArray) array = g_algorithm_sorted_container_to_array (container);
+    std::vector <size_t> elements;
+
+    for (guint i = 0; i < array->len; ++i)
+      elements.push_back (GPOINTER_TO_SIZE (array->pdata[i]));
+
+    return elements;
+  }
+
+  TEST (GAlgorithmSortedContainer, insert_and_lookup) {
+    g_autoptr(GAlgorithmSortedContainer) container = g_algorithm_sorted_container_new (ptr_compare, NULL);
+
+    for (size_t i = 1; i <= 1000; ++i)
+      g_algorithm_sorted_container_insert (container, GSIZE_TO_POINTER ((i * 7919) % 1000 + 1));
+
+    EXPECT_THAT (g_algorithm_sorted_container_get_length (container), Eq(1000u));
+    EXPECT_THAT (g_algorithm_sorted_container_lookup (container, GSIZE_TO_POINTER (1)), Eq(GSIZE_TO_POINTER (1)));
+    EXPECT_THAT (g_algorithm_sorted_container_lookup (container, GSIZE_TO_POINTER (500)), Eq(GSIZE_TO_POINTER (500)));
+    EXPECT_THAT (g_algorithm_sorted_container_lookup (container, GSIZE_TO_POINTER (1001)), IsNull());
+  }
+
+  TEST (GAlgorithmSortedContainer, to_array_is_sorted) {
+    g_autoptr(GAlgorithmSortedContainer) container = g_algorithm_sorted_container_new (ptr_compare, NULL);
+    std::mt19937 engine (1);
+    std::vector <size_t> expected;
+
+    for (size_t i = 0; i < 5000; ++i)
+      {
+        size_t value = engine () % 100000 + 1;
+
+        expected.push_back (value);
+        g_algorithm_sorted_container_insert (container, GSIZE_TO_POINTER (value));
+      }
+
+    std::sort (expected.begin (), expected.end ());
+
+    EXPECT_THAT (container_contents (container), ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmSortedContainer, duplicates_are_kept) {
+    g_autoptr(GAlgorithmSortedContainer) container = g_algorithm_sorted_container_new (ptr_compare, NULL);
+
+    for (size_t i = 0; i < 100; ++i)
+      g_algorithm_sorted_container_insert (container, GSIZE_TO_POINTER (i % 2 + 1));
+
+    EXPECT_TRUE (g_algorithm_sorted_container_remove (container, GSIZE_TO_POINTER (2)));
+    EXPECT_THAT (g_algorithm_sorted_container_get_length (container), Eq(99u));
+
+    std::vector <size_t> contents = container_contents (container);
+
+    EXPECT_THAT (std::count (contents.begin (), contents.end (), 1), Eq(50));
+    EXPECT_THAT (std::count (contents.begin (), contents.end (), 2), Eq(49));
+  }
+
+  TEST (GAlgorithmSortedContainer, remove_from_delta_and_levels) {
+    g_autoptr(GAlgorithmSortedContainer) container = g_algorithm_sorted_container_new (ptr_compare, NULL);
+
+    for (size_t i = 1; i <= 200; ++i)
+      g_algorithm_sorted_container_insert (container, GSIZE_TO_POINTER (i));
+
+    /* 1 was flushed out to a level long ago, 200 is still in the delta */
+    EXPECT_TRUE (g_algorithm_sorted_container_remove (container, GSIZE_TO_POINTER (1)));
+    EXPECT_TRUE (g_algorithm_sorted_container_remove (container, GSIZE_TO_POINTER (200)));
+    EXPECT_FALSE (g_algorithm_sorted_container_remove (container, GSIZE_TO_POINTER (1)));
+    EXPECT_FALSE (g_algorithm_sorted_container_remove (container, GSIZE_TO_POINTER (201)));
+
+    EXPECT_THAT (g_algorithm_sorted_container_lookup (container, GSIZE_TO_POINTER (1)), IsNull());
+    EXPECT_THAT (g_algorithm_sorted_container_lookup (container, GSIZE_TO_POINTER (200)), IsNull());
+    EXPECT_THAT (g_algorithm_sorted_container_get_length (container), Eq(198u));
+  }
+
+  TEST (GAlgorithmSortedContainer, random_operations_match_multiset) {
+    g_autoptr(GAlgorithmSortedContainer) container = g_algorithm_sorted_container_new (ptr_compare, NULL);
+    std::multiset <size_t> expected;
+    std::mt19937 engine (2);
+
+    for (size_t i = 0; i < 20000; ++i)
+      {
+        size_t value = engine () % 500 + 1;
+
+        switch (engine () % 3)
+          {
+            case 0:
+            case 1:
+              g_algorithm_sorted_container_insert (container, GSIZE_TO_POINTER (value));
+              expected.insert (value);
+              break;
+            case 2:
+              {
+                auto it = expected.find (value);
+                gboolean removed = g_algorithm_sorted_container_remove (container,
+                                                                        GSIZE_TO_POINTER (value));
+
+                ASSERT_THAT (removed, Eq(it != expected.end ()));
+
+                if (it != expected.end ())
+                  expected.erase (it);
+              }
+              break;
+          }
+
+        size_t probe = engine () % 500 + 1;
+        gpointer found = g_algorithm_sorted_container_lookup (container, GSIZE_TO_POINTER (probe));
+
+        ASSERT_THAT (found != NULL, Eq(expected.count (probe) > 0));
+      }
+
+    EXPECT_THAT (g_algorithm_sorted_container_get_length (container), Eq(expected.size ()));
+    EXPECT_THAT (container_contents (container), ElementsAreArray (expected.begin (), expected.end ()));
+
+    g_algorithm_sorted_container_compact (container);
+
+    EXPECT_THAT (container_contents (container), ElementsAreArray (expected.begin (), expected.end ()));
+  }
+
+  TEST (GAlgorithmSortedContainer, compact_frees_removed_elements) {
+    g_autoptr(GAlgorithmSortedContainer) container = g_algorithm_sorted_container_new (boxed_int_compare,
+                                                                                       counting_free);
+
+    n_freed = 0;
+
+    for (int i = 0; i < 300; ++i)
+      g_algorithm_sorted_container_insert (container, new_boxed_int (i));
+
+    for (int i = 0; i < 10; ++i)
+      g_algorithm_sorted_container_remove (container, &i);
+
+    g_algorithm_sorted_container_compact (container);
+
+    EXPECT_THAT (n_freed, Eq(10u));
+    EXPECT_THAT (g_algorithm_sorted_container_get_length (container), Eq(290u));
+
+    int needle = 10;
+    EXPECT_THAT (*static_cast <int *> (g_algorithm_sorted_container_lookup (container, &needle)), Eq(10));
+  }
+
+  TEST (GAlgorithmSortedContainer, unref_frees_all_elements) {
+    GAlgorithmSortedContainer *container = g_algorithm_sorted_container_new (boxed_int_compare,
+                                                                             counting_free);
+
+    n_freed = 0;
+
+    for (int i = 0; i < 300; ++i)
+      g_algorithm_sorted_container_insert (container, new_boxed_int (i));
+
+    int needle = 5;
+    g_algorithm_sorted_container_remove (container, &needle);
+    g_algorithm_sorted_container_unref (container);
+
+    EXPECT_THAT (n_freed, Eq(300u));
+  }
+
+  TEST (GAlgorithmSortedContainer, empty_container) {
+    g_autoptr(GAlgorithmSortedContainer) container = g_algorithm_sorted_container_new (ptr_compare, NULL);
+
+    g_algorithm_sorted_container_compact (container);
+
+    EXPECT_THAT (g_algorithm_sorted_container_get_length (container), Eq(0u));
+    EXPECT_THAT (g_algorithm_sorted_container_lookup (container, GSIZE_TO_POINTER (1)), IsNull());
+    EXPECT_THAT (container_contents (container), ElementsAre());
+  }
+}
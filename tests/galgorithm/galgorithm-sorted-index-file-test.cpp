@@ -0,0 +1,187 @@
+/*
+ * /tests/galgorithm/galgorithm-sorted-index-file-test.cpp
+ *
+ * Tests for the GAlgorithm Sorted Index Files.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <glib/gstdio.h>
+
+#include <galgorithm/galgorithm-sorted-index-file.h>
+
+using ::testing::Eq;
+using ::testing::IsNull;
+using ::testing::NotNull;
+
+namespace {
+  guint64 serialize_size_key (gconstpointer element, guint8 *key, gpointer user_data)
+  {
+    size_t value = GPOINTER_TO_SIZE (element);
+
+    g_algorithm_sorted_index_key_from_uint64 (value, key);
+    return value * 100;
+  }
+
+  class GAlgorithmSortedIndexFileTest : public ::testing::Test {
+    protected:
+      void SetUp () override
+      {
+        gchar *tmpl = g_strconcat (g_get_tmp_dir (), "/galgorithm-sorted-index-XXXXXX", NULL);
+        int fd = g_mkstemp (tmpl);
+
+        ASSERT_GE (fd, 0);
+        g_close (fd, NULL);
+
+        path = tmpl;
+        g_free (tmpl);
+      }
+
+      void TearDown () override
+      {
+        g_unlink (path.c_str ());
+      }
+
+      std::string path;
+  };
+
+  TEST_F (GAlgorithmSortedIndexFileTest, write_and_search) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    g_autoptr(GError) error = NULL;
+
+    for (size_t i = 0; i < 10000; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (i * 3));
+
+    ASSERT_TRUE (g_algorithm_sorted_index_file_write (array, 8, serialize_size_key, NULL,
+                                                      path.c_str (), &error));
+
+    g_autoptr(GAlgorithmSortedIndexFile) index = g_algorithm_sorted_index_file_new (path.c_str (), &error);
+
+    ASSERT_THAT (index, NotNull());
+    EXPECT_THAT (g_algorithm_sorted_index_file_get_n_keys (index), Eq(10000u));
+    EXPECT_THAT (g_algorithm_sorted_index_file_get_key_size (index), Eq(8u));
+
+    for (size_t i = 0; i < 30000; ++i)
+      {
+        guint8 key[8];
+        guint64 offset = 0;
+
+        g_algorithm_sorted_index_key_from_uint64 (i, key);
+
+        if (i % 3 == 0)
+          {
+            ASSERT_THAT (g_algorithm_sorted_index_file_search (index, key), Eq(static_cast <int64_t> (i / 3)));
+            ASSERT_TRUE (g_algorithm_sorted_index_file_lookup (index, key, &offset));
+            ASSERT_THAT (offset, Eq(i * 100));
+          }
+        else
+          {
+            ASSERT_THAT (g_algorithm_sorted_index_file_search (index, key), Eq(-1));
+          }
+      }
+  }
+
+  TEST_F (GAlgorithmSortedIndexFileTest, keys_point_into_the_file) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    g_autoptr(GError) error = NULL;
+
+    for (size_t i = 0; i < 100; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (i));
+
+    ASSERT_TRUE (g_algorithm_sorted_index_file_write (array, 8, serialize_size_key, NULL,
+                                                      path.c_str (), &error));
+
+    g_autoptr(GAlgorithmSortedIndexFile) index = g_algorithm_sorted_index_file_new (path.c_str (), &error);
+    guint8 expected[8];
+
+    g_algorithm_sorted_index_key_from_uint64 (42, expected);
+
+    EXPECT_THAT (memcmp (g_algorithm_sorted_index_file_get_key (index, 42), expected, 8), Eq(0));
+    EXPECT_THAT (g_algorithm_sorted_index_file_get_offset (index, 42), Eq(4200u));
+  }
+
+  TEST_F (GAlgorithmSortedIndexFileTest, search_finds_first_duplicate) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    g_autoptr(GError) error = NULL;
+
+    /* Long runs of the same key span several fences */
+    for (size_t i = 0; i < 5000; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (i / 1000));
+
+    ASSERT_TRUE (g_algorithm_sorted_index_file_write (array, 8, serialize_size_key, NULL,
+                                                      path.c_str (), &error));
+
+    g_autoptr(GAlgorithmSortedIndexFile) index = g_algorithm_sorted_index_file_new (path.c_str (), &error);
+
+    for (size_t value = 0; value < 5; ++value)
+      {
+        guint8 key[8];
+
+        g_algorithm_sorted_index_key_from_uint64 (value, key);
+        EXPECT_THAT (g_algorithm_sorted_index_file_search (index, key), Eq(static_cast <int64_t> (value * 1000)));
+      }
+  }
+
+  TEST_F (GAlgorithmSortedIndexFileTest, empty_array) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    g_autoptr(GError) error = NULL;
+    guint8 key[8];
+
+    ASSERT_TRUE (g_algorithm_sorted_index_file_write (array, 8, serialize_size_key, NULL,
+                                                      path.c_str (), &error));
+
+    g_autoptr(GAlgorithmSortedIndexFile) index = g_algorithm_sorted_index_file_new (path.c_str (), &error);
+
+    g_algorithm_sorted_index_key_from_uint64 (0, key);
+
+    ASSERT_THAT (index, NotNull());
+    EXPECT_THAT (g_algorithm_sorted_index_file_get_n_keys (index), Eq(0u));
+    EXPECT_THAT (g_algorithm_sorted_index_file_search (index, key), Eq(-1));
+  }
+
+  TEST_F (GAlgorithmSortedIndexFileTest, unsorted_keys_fail_to_write) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    g_autoptr(GError) error = NULL;
+
+    g_ptr_array_add (array, GSIZE_TO_POINTER (2));
+    g_ptr_array_add (array, GSIZE_TO_POINTER (1));
+
+    EXPECT_FALSE (g_algorithm_sorted_index_file_write (array, 8, serialize_size_key, NULL,
+                                                       path.c_str (), &error));
+    ASSERT_THAT (error, NotNull());
+    EXPECT_THAT (error->domain, Eq(G_ALGORITHM_SORTED_INDEX_FILE_ERROR));
+    EXPECT_THAT (error->code, Eq(G_ALGORITHM_SORTED_INDEX_FILE_ERROR_UNSORTED));
+  }
+
+  TEST_F (GAlgorithmSortedIndexFileTest, invalid_file_fails_to_open) {
+    g_autoptr(GError) error = NULL;
+
+    ASSERT_TRUE (g_file_set_contents (path.c_str (), "not an index", -1, NULL));
+
+    g_autoptr(GAlgorithmSortedIndexFile) index = g_algorithm_sorted_index_file_new (path.c_str (), &error);
+
+    EXPECT_THAT (index, IsNull());
+    ASSERT_THAT (error, NotNull());
+    EXPECT_THAT (error->domain, Eq(G_ALGORITHM_SORTED_INDEX_FILE_ERROR));
+    EXPECT_THAT (error->code, Eq(G_ALGORITHM_SORTED_INDEX_FILE_ERROR_INVALID));
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ * /tests/galgorithm/galgorithm-stats-test.cpp
+ *
+ * Tests for GAlgorithm Stats.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <random>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-binary-search.h>
+#include <galgorithm/galgorithm-merge-sort.h>
+#include <galgorithm/galgorithm-quicksort.h>
+#include <galgorithm/galgorithm-stats.h>
+
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::Le;
+
+namespace {
+  int ptr_compare (gconstpointer a, gconstpointer b)
+  {
+    auto cmp = reinterpret_cast <ptrdiff_t> (a) - reinterpret_cast <ptrdiff_t> (b);
+    /* Avoid overflow */
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+  }
+
+  GPtrArray * random_ptr_array (size_t size)
+  {
+    GPtrArray *array = g_ptr_array_sized_new (size);
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < size; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (1 + engine () % 100000));
+
+    return array;
+  }
+
+#ifdef G_ALGORITHM_TEST_EXPECT_STATS
+  TEST (GAlgorithmStats, enabled_in_stats_build) {
+    EXPECT_TRUE (g_algorithm_stats_is_enabled ());
+  }
+#endif
+
+  TEST (GAlgorithmStats, merge_sort_counts_passes_and_scratch) {
+    g_autoptr(GPtrArray) array = random_ptr_array (1000);
+    GAlgorithmStats stats;
+
+    g_algorithm_stats_begin (&stats);
+    g_algorithm_merge_sort (array, ptr_compare);
+    g_algorithm_stats_end (&stats);
+
+    if (!g_algorithm_stats_is_enabled ())
+      {
+        EXPECT_THAT (stats.operations, Eq (0u));
+        EXPECT_THAT (stats.comparisons, Eq (0u));
+        return;
+      }
+
+    /* 1000 elements take ten passes of 1000 moves each. After an even
+     * number of passes the result is already back in the array. */
+    EXPECT_THAT (stats.operations, Eq (1u));
+    EXPECT_THAT (stats.passes, Eq (10u));
+    EXPECT_THAT (stats.moves, Eq (10000u));
+    EXPECT_THAT (stats.scratch_bytes, Eq (1000 * sizeof (gpointer)));
+    EXPECT_THAT (stats.comparisons, Gt (0u));
+    EXPECT_THAT (stats.comparisons, Le (10000u));
+  }
+
+  TEST (GAlgorithmStats, quicksort_counts_swaps) {
+    g_autoptr(GPtrArray) array = random_ptr_array (1000);
+    GAlgorithmStats stats;
+
+    g_algorithm_stats_begin (&stats);
+    g_algorithm_quicksort_full (array, ptr_compare, G_ALGORITHM_QUICKSORT_PARTITION_BLOCK);
+    g_algorithm_stats_end (&stats);
+
+    if (!g_algorithm_stats_is_enabled ())
+      return;
+
+    EXPECT_THAT (stats.operations, Eq (1u));
+    EXPECT_THAT (stats.comparisons, Gt (0u));
+    EXPECT_THAT (stats.swaps, Gt (0u));
+    EXPECT_THAT (stats.passes, Gt (0u));
+  }
+
+  TEST (GAlgorithmStats, binary_search_counts_each_probe) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    GAlgorithmStats stats;
+
+    for (size_t i = 0; i < 1024; ++i)
+      g_ptr_array_add (array, GSIZE_TO_POINTER (i * 2 + 1));
+
+    g_algorithm_stats_begin (&stats);
+    g_algorithm_binary_search (array, GSIZE_TO_POINTER (1), ptr_compare);
+    g_algorithm_binary_search (array, GSIZE_TO_POINTER (2047), ptr_compare);
+    g_algorithm_stats_end (&stats);
+
+    if (!g_algorithm_stats_is_enabled ())
+      return;
+
+    EXPECT_THAT (stats.operations, Eq (2u));
+    EXPECT_THAT (stats.comparisons, Le (2u * 11u));
+  }
+
+  TEST (GAlgorithmStats, nothing_counted_after_end) {
+    g_autoptr(GPtrArray) array = random_ptr_array (100);
+    GAlgorithmStats stats;
+
+    g_algorithm_stats_begin (&stats);
+    g_algorithm_stats_end (&stats);
+    g_algorithm_merge_sort (array, ptr_compare);
+
+    EXPECT_THAT (stats.operations, Eq (0u));
+    EXPECT_THAT (stats.comparisons, Eq (0u));
+  }
+}
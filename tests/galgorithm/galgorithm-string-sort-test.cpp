@@ -0,0 +1,133 @@
+/*
+ * /tests/galgorithm/galgorithm-string-sort-test.cpp
+ *
+ * Tests for the GAlgorithm string sort function.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-string-sort.h>
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+using ::testing::StrEq;
+
+namespace {
+  std::vector <std::string> to_strings (GPtrArray *array)
+  {
+    std::vector <std::string> strings;
+
+    for (size_t i = 0; i < array->len; ++i)
+      strings.push_back (static_cast <const gchar *> (array->pdata[i]));
+
+    return strings;
+  }
+
+  template <typename... Args>
+  void insert_strings (GPtrArray *array, Args... args)
+  {
+    const gchar *strings[] = { args... };
+
+    for (const gchar *str : strings)
+      g_ptr_array_add (array, const_cast <gchar *> (str));
+  }
+
+  TEST (GAlgorithmStringSort, sort_empty_array) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+
+    EXPECT_THAT (to_strings (g_algorithm_sort_strings (array,
+                                                       G_ALGORITHM_STRING_SORT_BYTES)),
+                 IsEmpty ());
+  }
+
+  TEST (GAlgorithmStringSort, sort_short_strings) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    insert_strings (array, "pear", "apple", "", "fig", "apples");
+
+    EXPECT_THAT (to_strings (g_algorithm_sort_strings (array,
+                                                       G_ALGORITHM_STRING_SORT_BYTES)),
+                 ElementsAre ("", "apple", "apples", "fig", "pear"));
+  }
+
+  TEST (GAlgorithmStringSort, sort_strings_with_long_shared_prefixes) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    insert_strings (array,
+                    "/usr/share/icons/hicolor/48x48/apps/b.png",
+                    "/usr/share/icons/hicolor/48x48",
+                    "/usr/share/icons/hicolor/48x48/apps/a.png",
+                    "/usr/share/icons/hicolor/48x48/apps/a.png",
+                    "/usr/share/icons/hicolor/16x16/apps/a.png");
+
+    EXPECT_THAT (to_strings (g_algorithm_sort_strings (array,
+                                                       G_ALGORITHM_STRING_SORT_BYTES)),
+                 ElementsAre ("/usr/share/icons/hicolor/16x16/apps/a.png",
+                              "/usr/share/icons/hicolor/48x48",
+                              "/usr/share/icons/hicolor/48x48/apps/a.png",
+                              "/usr/share/icons/hicolor/48x48/apps/a.png",
+                              "/usr/share/icons/hicolor/48x48/apps/b.png"));
+  }
+
+  TEST (GAlgorithmStringSort, sort_many_strings_matches_strcmp) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func (g_free);
+    std::vector <std::string> expected;
+    std::mt19937 engine (0);
+
+    for (size_t i = 0; i < 5000; ++i)
+      {
+        std::string str = "https://example.com/";
+        size_t length = engine () % 24;
+
+        for (size_t j = 0; j < length; ++j)
+          str.push_back ("ab/\xc3\xa9"[engine () % 5]);
+
+        g_ptr_array_add (array, g_strdup (str.c_str ()));
+        expected.push_back (str);
+      }
+
+    std::sort (expected.begin (), expected.end (), [](const std::string &a, const std::string &b) {
+      return std::strcmp (a.c_str (), b.c_str ()) < 0;
+    });
+
+    EXPECT_THAT (to_strings (g_algorithm_sort_strings (array,
+                                                       G_ALGORITHM_STRING_SORT_BYTES)),
+                 ElementsAreArray (expected));
+  }
+
+  TEST (GAlgorithmStringSort, sort_collated_matches_utf8_collate) {
+    g_autoptr(GPtrArray) array = g_ptr_array_new ();
+    insert_strings (array, "pear", "Apple", "\xc3\xa9" "clair", "apple", "eclair", "Zebra");
+
+    std::vector <std::string> expected (to_strings (array));
+    std::sort (expected.begin (), expected.end (), [](const std::string &a, const std::string &b) {
+      return g_utf8_collate (a.c_str (), b.c_str ()) < 0;
+    });
+
+    EXPECT_THAT (to_strings (g_algorithm_sort_strings (array,
+                                                       G_ALGORITHM_STRING_SORT_COLLATE)),
+                 ElementsAreArray (expected));
+  }
+}
@@ -0,0 +1,178 @@
+/*
+ * /tests/galgorithm/galgorithm-timing-wheel-test.cpp
+ *
+ * Tests for the GAlgorithm Timing Wheel.
+ *
+ * Copyright (C) 2019 Sam Spilsbury.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <galgorithm/galgorithm-timing-wheel.h>
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::IsEmpty;
+
+namespace {
+  std::vector <size_t> advance (GAlgorithmTimingWheel *wheel, guint64 now)
+  {
+    g_autoptr(GPtrArray) expired = g_ptr_array_new ();
+    std::vector <size_t> values;
+
+    g_algorithm_timing_wheel_advance (wheel, now, expired);
+
+    for (guint i = 0; i < expired->len; ++i)
+      values.push_back (GPOINTER_TO_SIZE (expired->pdata[i]));
+
+    return values;
+  }
+
+  TEST (GAlgorithmTimingWheel, expires_in_order) {
+    g_autoptr(GAlgorithmTimingWheel) wheel = g_algorithm_timing_wheel_new (0);
+    const guint64 expiries[] = { 4096, 1, 65, 63, 64, 4095, 5, 100000 };
+
+    for (guint64 expiry : expiries)
+      g_algorithm_timing_wheel_schedule (wheel, expiry, GSIZE_TO_POINTER (expiry));
+
+    EXPECT_THAT (advance (wheel, 4), ElementsAre(1));
+    EXPECT_THAT (advance (wheel, 64), ElementsAre(5, 63, 64));
+    EXPECT_THAT (advance (wheel, 5000), ElementsAre(65, 4095, 4096));
+    EXPECT_THAT (g_algorithm_timing_wheel_get_length (wheel), Eq(1u));
+    EXPECT_THAT (advance (wheel, 99999), IsEmpty());
+    EXPECT_THAT (advance (wheel, 100000), ElementsAre(100000));
+    EXPECT_THAT (g_algorithm_timing_wheel_get_time (wheel), Eq(100000u));
+  }
+
+  TEST (GAlgorithmTimingWheel, cancel_by_handle) {
+    g_autoptr(GAlgorithmTimingWheel) wheel = g_algorithm_timing_wheel_new (0);
+    GAlgorithmTimingWheelHandle first = g_algorithm_timing_wheel_schedule (wheel, 10, GSIZE_TO_POINTER (1));
+    GAlgorithmTimingWheelHandle second = g_algorithm_timing_wheel_schedule (wheel, 10, GSIZE_TO_POINTER (2));
+
+    EXPECT_TRUE (g_algorithm_timing_wheel_cancel (wheel, first));
+    EXPECT_FALSE (g_algorithm_timing_wheel_cancel (wheel, first));
+    EXPECT_FALSE (g_algorithm_timing_wheel_cancel (wheel, 0));
+    EXPECT_THAT (g_algorithm_timing_wheel_get_length (wheel), Eq(1u));
+
+    /* The node behind the first handle is reused, but the old handle
+     * must not cancel the new timer */
+    g_algorithm_timing_wheel_schedule (wheel, 10, GSIZE_TO_POINTER (3));
+    EXPECT_FALSE (g_algorithm_timing_wheel_cancel (wheel, first));
+
+    EXPECT_THAT (advance (wheel, 10), testing::UnorderedElementsAre(2, 3));
+    EXPECT_FALSE (g_algorithm_timing_wheel_cancel (wheel, second));
+  }
+
+  TEST (GAlgorithmTimingWheel, past_expiry_fires_on_next_advance) {
+    g_autoptr(GAlgorithmTimingWheel) wheel = g_algorithm_timing_wheel_new (1000);
+
+    g_algorithm_timing_wheel_schedule (wheel, 10, GSIZE_TO_POINTER (10));
+
+    EXPECT_THAT (advance (wheel, 1001), ElementsAre(10));
+  }
+
+  TEST (GAlgorithmTimingWheel, far_future_timers_are_placed_again) {
+    g_autoptr(GAlgorithmTimingWheel) wheel = g_algorithm_timing_wheel_new (0);
+    guint64 far = (G_GUINT64_CONSTANT (1) << 40) + 12345;
+
+    g_algorithm_timing_wheel_schedule (wheel, far, GSIZE_TO_POINTER (1));
+
+    EXPECT_THAT (advance (wheel, far - 1), IsEmpty());
+    EXPECT_THAT (advance (wheel, far), ElementsAre(1));
+  }
+
+  TEST (GAlgorithmTimingWheel, random_operations_match_reference) {
+    g_autoptr(GAlgorithmTimingWheel) wheel = g_algorithm_timing_wheel_new (0);
+    std::map <GAlgorithmTimingWheelHandle, std::pair <guint64, size_t>> pending;
+    std::mt19937 engine (1);
+    guint64 now = 0;
+    size_t next_value = 1;
+
+    for (int round = 0; round < 2000; ++round)
+      {
+        for (int i = 0; i < 20; ++i)
+          {
+            guint64 expiry = now + 1 + engine () % (engine () % 2 ? 100 : 3000000);
+            size_t value = next_value++;
+
+            pending[g_algorithm_timing_wheel_schedule (wheel, expiry, GSIZE_TO_POINTER (value))] =
+              std::make_pair (expiry, value);
+          }
+
+        for (int i = 0; i < 10 && !pending.empty (); ++i)
+          {
+            auto it = pending.begin ();
+            std::advance (it, engine () % pending.size ());
+
+            ASSERT_TRUE (g_algorithm_timing_wheel_cancel (wheel, it->first));
+            pending.erase (it);
+          }
+
+        switch (engine () % 20)
+          {
+            case 0:
+              now += engine () % 1000000;
+              break;
+            case 1:
+              now += engine () % 5000;
+              break;
+            default:
+              now += engine () % 50;
+              break;
+          }
+
+        std::vector <size_t> expected;
+        for (auto it = pending.begin (); it != pending.end (); )
+          {
+            if (it->second.first <= now)
+              {
+                expected.push_back (it->second.second);
+                it = pending.erase (it);
+              }
+            else
+              {
+                ++it;
+              }
+          }
+
+        std::vector <size_t> expired = advance (wheel, now);
+
+        std::sort (expected.begin (), expected.end ());
+        std::sort (expired.begin (), expired.end ());
+
+        ASSERT_THAT (expired, ElementsAreArray (expected));
+        ASSERT_THAT (g_algorithm_timing_wheel_get_length (wheel), Eq(pending.size ()));
+      }
+  }
+
+  TEST (GAlgorithmTimingWheel, advance_without_expired_array) {
+    g_autoptr(GAlgorithmTimingWheel) wheel = g_algorithm_timing_wheel_new (0);
+
+    for (size_t i = 1; i <= 100; ++i)
+      g_algorithm_timing_wheel_schedule (wheel, i, GSIZE_TO_POINTER (i));
+
+    EXPECT_THAT (g_algorithm_timing_wheel_advance (wheel, 50, NULL), Eq(50u));
+    EXPECT_THAT (g_algorithm_timing_wheel_get_length (wheel), Eq(50u));
+  }
+}